@@ -1,11 +1,15 @@
 #include "BaseConnectionManager.h"
 
 #include <cassert>
+#include <algorithm>
 
 #include "NicEntryDebug.h"
 #include "NicEntryDirect.h"
 #include "BaseWorldUtility.h"
 #include "FindModule.h"
+#include "MemoryPool.h"
+#include "MiXiMAirFrame.h"
+#include "MappingBase.h"
 
 #ifndef ccEV
 #define ccEV (ev.isDisabled()||!coreDebug) ? ev : ev << getName() << ": "
@@ -24,7 +28,12 @@ BaseConnectionManager::BaseConnectionManager()
   , maxDistSquared(0.0)
   , useTorus(false)
   , drawMIR(false)
+  , batchUpdates(false)
+  , pendingMoves()
+  , batchTimer(NULL)
   , nicGrid()
+  , cellNeighbors()
+  , cellNeighborCount()
   , findDistance()
   , gridDim()
 {}
@@ -43,8 +52,18 @@ void BaseConnectionManager::initialize(int stage)
 		drawMIR = hasPar("drawMaxIntfDist")
 						? par("drawMaxIntfDist").boolValue() : false;
 
+		batchUpdates = hasPar("batchPositionUpdates")
+						? par("batchPositionUpdates").boolValue() : false;
+		if(batchUpdates) {
+			batchTimer = new cMessage("batchPositionUpdates");
+		}
+
 		ccEV <<"initializing BaseConnectionManager\n";
 
+		//pools are shared by all runs, only count the current one
+		MiximAirFrame::getPool().resetStatistics();
+		ConstMapping::getPool().resetStatistics();
+
 		BaseWorldUtility* world = FindModule<BaseWorldUtility*>
 										::findGlobalModule();
 
@@ -83,20 +102,8 @@ void BaseConnectionManager::initialize(int stage)
 			gridDim.z = std::max(1, gridDim.z);
 		}
 
-		//step 2 - initialize the matrix which represents our grid
-		NicEntries entries;
-		RowVector row;
-		NicMatrix matrix;
-
-		for (int i = 0; i < gridDim.z; ++i) {
-			row.push_back(entries);			//copy empty NicEntries to RowVector
-		}
-		for (int i = 0; i < gridDim.y; ++i) {//fill the ColVector with copies of
-			matrix.push_back(row);			 //the RowVector.
-		}
-		for (int i = 0; i < gridDim.x; ++i) {	//fill the grid with copies of
-			nicGrid.push_back(matrix);			//the matrix.
-		}
+		//step 2 - initialize the flat array which represents our grid
+		nicGrid.assign(gridDim.x * gridDim.y * gridDim.z, CellEntries());
 		ccEV << " using " << gridDim.x << "x" <<
 							 gridDim.y << "x" <<
 							 gridDim.z << " grid" << endl;
@@ -134,6 +141,9 @@ void BaseConnectionManager::initialize(int stage)
 		assert(GridCoord(*playgroundSize, findDistance).y == gridDim.y - 1);
 		assert(GridCoord(*playgroundSize, findDistance).z == gridDim.z - 1);
 		ccEV << "findDistance is " << findDistance.info() << endl;
+
+		//step 4 - precompute the neighbourhood of every cell
+		buildNeighborTable();
 	}
 	else if (stage == 1)
 	{
@@ -141,6 +151,23 @@ void BaseConnectionManager::initialize(int stage)
 	}
 }
 
+void BaseConnectionManager::finish()
+{
+	recordPoolStatistics("airFramePool", MiximAirFrame::getPool());
+	recordPoolStatistics("mappingPool", ConstMapping::getPool());
+}
+
+void BaseConnectionManager::recordPoolStatistics(const std::string& prefix, const MemoryPool& pool)
+{
+	ccEV << pool.getName() << " pool: " << pool.getHits() << " of "
+	     << pool.getRequests() << " allocations recycled, peak of "
+	     << pool.getPeakLive() << " live objects" << endl;
+
+	recordScalar((prefix + "Allocations").c_str(), pool.getRequests());
+	recordScalar((prefix + "HitRate").c_str()    , pool.getHitRate());
+	recordScalar((prefix + "PeakLive").c_str()   , pool.getPeakLive());
+}
+
 BaseConnectionManager::GridCoord BaseConnectionManager
 	::getCellForCoordinate(const Coord& c) const
 {
@@ -151,16 +178,10 @@ void BaseConnectionManager::updateConnections(NicEntry::t_nicid_cref nicID,
                                               const Coord* oldPos,
                                               const Coord* newPos)
 {
-	GridCoord oldCell = getCellForCoordinate(*oldPos);
-    GridCoord newCell = getCellForCoordinate(*newPos);
+	NicEntries::iterator it = nics.find(nicID);
+	assert(it != nics.end());
 
-	checkGrid(oldCell, newCell, nicID );
-}
-
-BaseConnectionManager::NicEntries& BaseConnectionManager
-	::getCellEntries(const BaseConnectionManager::GridCoord& cell)
-{
-    return nicGrid[cell.x][cell.y][cell.z];
+	checkGrid(getCellIndex(*oldPos), getCellIndex(*newPos), it->second);
 }
 
 void BaseConnectionManager::registerNicExt(NicEntry::t_nicid_cref nicID)
@@ -171,51 +192,33 @@ void BaseConnectionManager::registerNicExt(NicEntry::t_nicid_cref nicID)
 
 	ccEV <<" registering (ext) nic at loc " << cell.info() << std::endl;
 
-	// add to matrix
-	NicEntries& cellEntries = getCellEntries(cell);
-    cellEntries[nicID] = nicEntry;
+	// add to grid
+	nicGrid[getCellIndex(cell)].push_back(nicEntry);
 }
 
-void BaseConnectionManager::checkGrid(BaseConnectionManager::GridCoord& oldCell,
-                                      BaseConnectionManager::GridCoord& newCell,
-                                      NicEntry::t_nicid_cref            id)
-
+void BaseConnectionManager::removeFromCell(int cell, const NicEntry* nic)
 {
+	CellEntries& entries = nicGrid[cell];
+	for(CellEntries::iterator it = entries.begin(); it != entries.end(); ++it) {
+		if(*it == nic) {
+			//order inside a cell does not matter, so avoid shifting
+			*it = entries.back();
+			entries.pop_back();
+			return;
+		}
+	}
+	assert(false);
+}
 
-    // structure to find union of grid squares
-    CoordSet gridUnion(74);
-
-    // find nic at old position
-    NicEntries&             oldCellEntries = getCellEntries(oldCell);
-    NicEntries::iterator    it  = oldCellEntries.find(id);
-    NicEntries::mapped_type nic = it->second;
-
-
-    // move nic to a new position in matrix
-    if(oldCell != newCell) {
-    	oldCellEntries.erase(it);
-    	getCellEntries(newCell)[id] = nic;
-    }
-
-	if((gridDim.x == 1) && (gridDim.y == 1) && (gridDim.z == 1)) {
-		gridUnion.add(oldCell);
-    } else {
-		//add grid around oldPos
-		fillUnionWithNeighbors(gridUnion, oldCell);
-
-
-        if(oldCell != newCell) {
-            //add grid around newPos
-            fillUnionWithNeighbors(gridUnion, newCell);
-        }
-    }
+void BaseConnectionManager::checkGrid(int oldCell, int newCell, NicEntry* nic)
+{
+	// move nic to a new position in grid
+	if(oldCell != newCell) {
+		removeFromCell(oldCell, nic);
+		nicGrid[newCell].push_back(nic);
+	}
 
-    GridCoord* c = gridUnion.next();
-    while(c != 0) {
-		ccEV << "Update cons in [" << c->info() << "]" << endl;
-		updateNicConnections(getCellEntries(*c), nic);
-		c = gridUnion.next();
-    }
+	updateNicConnections(nic, newCell);
 }
 
 int BaseConnectionManager::wrapIfTorus(int value, int max) const {
@@ -236,23 +239,42 @@ int BaseConnectionManager::wrapIfTorus(int value, int max) const {
 	}
 }
 
-void BaseConnectionManager::fillUnionWithNeighbors(CoordSet&        gridUnion,
-                                                   const GridCoord& cell) const
+void BaseConnectionManager::buildNeighborTable()
 {
-	for(int iz = (int)cell.z - 1; iz <= (int)cell.z + 1; iz++) {
-		int cz = wrapIfTorus(iz, gridDim.z);
-		if(cz == -1) {
-			continue;
-		}
-		for(int ix = (int)cell.x - 1; ix <= (int)cell.x + 1; ix++) {
-			int cx = wrapIfTorus(ix, gridDim.x);
-			if(cx == -1) {
-				continue;
-			}
-			for(int iy = (int)cell.y - 1; iy <= (int)cell.y + 1; iy++) {
-				int cy = wrapIfTorus(iy, gridDim.y);
-				if(cy != -1) {
-					gridUnion.add(GridCoord(cx, cy, cz));
+	const int numCells = static_cast<int>(nicGrid.size());
+
+	cellNeighbors.assign(numCells * MAX_CELL_NEIGHBORS, -1);
+	cellNeighborCount.assign(numCells, 0);
+
+	for(int x = 0; x < gridDim.x; x++) {
+		for(int y = 0; y < gridDim.y; y++) {
+			for(int z = 0; z < gridDim.z; z++) {
+				const int cell   = getCellIndex(GridCoord(x, y, z));
+				int*      first  = &cellNeighbors[cell * MAX_CELL_NEIGHBORS];
+				int&      count  = cellNeighborCount[cell];
+
+				for(int iz = z - 1; iz <= z + 1; iz++) {
+					int cz = wrapIfTorus(iz, gridDim.z);
+					if(cz == -1) {
+						continue;
+					}
+					for(int ix = x - 1; ix <= x + 1; ix++) {
+						int cx = wrapIfTorus(ix, gridDim.x);
+						if(cx == -1) {
+							continue;
+						}
+						for(int iy = y - 1; iy <= y + 1; iy++) {
+							int cy = wrapIfTorus(iy, gridDim.y);
+							if(cy == -1) {
+								continue;
+							}
+							//small grids wrap onto the same cell several times
+							const int n = getCellIndex(GridCoord(cx, cy, cz));
+							if(std::find(first, first + count, n) == first + count) {
+								first[count++] = n;
+							}
+						}
+					}
 				}
 			}
 		}
@@ -271,38 +293,127 @@ bool BaseConnectionManager::isInRange(BaseConnectionManager::NicEntries::mapped_
     return (dDistance <= maxDistSquared);
 }
 
-void BaseConnectionManager::updateNicConnections(NicEntries& nmap, BaseConnectionManager::NicEntries::mapped_type   nic)
+void BaseConnectionManager::disconnectOutOfRange(NicEntry* nic)
 {
-    NicEntry::t_nicid_cref id = nic->nicId;
-
-    for(NicEntries::iterator i = nmap.begin(); i != nmap.end(); ++i) {
-    	NicEntries::mapped_type nic_i = i->second;
-
-        // no recursive connections
-        if ( nic_i->nicId == id ) continue;
-
-        bool inRange   = isInRange(nic, nic_i);
-        bool connected = nic->isConnected(nic_i);
-
-        if ( inRange && !connected ) {
-            // nodes within communication range: connect
-            // nodes within communication range && not yet connected
-            ccEV << "nic #" << id << " and #" << nic_i->nicId
-            	 << " are in range" << endl;
-            nic->connectTo( nic_i );
-            nic_i->connectTo( nic );
-        }
-        else if ( !inRange && connected ) {
-            // out of range: disconnect
-            // out of range, and still connected
-            ccEV << "nic #" << id << " and #" << nic_i->nicId
-            	 << " are NOT in range" << endl;
-            nic->disconnectFrom( nic_i );
-            nic_i->disconnectFrom( nic );
-        }
+    // every connected nic has been in range before, drop the ones which
+    // aren't anymore
+    const NicEntry::GateList& conns = nic->getGateList();
+    CellEntries outOfRange;
+    for(NicEntry::GateList::const_iterator i = conns.begin(); i != conns.end(); ++i) {
+    	// all entries are owned by this connection manager
+    	NicEntry* nic_i = const_cast<NicEntry*>(i->first);
+    	if ( !isInRange(nic, nic_i) ) {
+    		outOfRange.push_back(nic_i);
+    	}
+    }
+    for(CellEntries::iterator i = outOfRange.begin(); i != outOfRange.end(); ++i) {
+        // out of range, and still connected
+        ccEV << "nic #" << nic->nicId << " and #" << (*i)->nicId
+        	 << " are NOT in range" << endl;
+        nic->disconnectFrom( *i );
+        (*i)->disconnectFrom( nic );
     }
 }
 
+void BaseConnectionManager::connectIfInRange(NicEntry* nic, NicEntry* other)
+{
+	if ( !nic->isConnected(other) && isInRange(nic, other) ) {
+		// nodes within communication range && not yet connected
+		ccEV << "nic #" << nic->nicId << " and #" << other->nicId
+			 << " are in range" << endl;
+		nic->connectTo( other );
+		other->connectTo( nic );
+	}
+}
+
+void BaseConnectionManager::updateNicConnections(NicEntry* nic, int cell)
+{
+    // old neighbour set
+    disconnectOutOfRange(nic);
+
+    // new neighbour set: only nics around the current cell can be in range
+    const int* first = &cellNeighbors[cell * MAX_CELL_NEIGHBORS];
+    const int* last  = first + cellNeighborCount[cell];
+    for(const int* c = first; c != last; ++c) {
+    	CellEntries& entries = nicGrid[*c];
+    	for(CellEntries::iterator i = entries.begin(); i != entries.end(); ++i) {
+    		NicEntry* nic_i = *i;
+
+    		// no recursive connections
+    		if ( nic_i == nic ) continue;
+
+    		connectIfInRange(nic, nic_i);
+    	}
+    }
+}
+
+void BaseConnectionManager::handleMessage(cMessage* msg)
+{
+	if(msg == batchTimer) {
+		flushPositionUpdates();
+	} else {
+		error("Unknown message %s received.", msg->getName());
+	}
+}
+
+void BaseConnectionManager::flushPositionUpdates()
+{
+	if(pendingMoves.empty()) {
+		return;
+	}
+
+	Enter_Method_Silent();
+	if(batchTimer->isScheduled()) {
+		cancelEvent(batchTimer);
+	}
+
+	std::vector<Mover> movers;
+	movers.reserve(pendingMoves.size());
+	for(CellEntries::const_iterator it = pendingMoves.begin(); it != pendingMoves.end(); ++it) {
+		movers.push_back(Mover(getCellIndex((*it)->pos), *it));
+	}
+	pendingMoves.clear();
+
+	// a nic may have moved several times
+	std::sort(movers.begin(), movers.end());
+	movers.erase(std::unique(movers.begin(), movers.end()), movers.end());
+
+	ccEV << "Update cons of " << movers.size() << " moved nics" << endl;
+
+	// old neighbour sets
+	for(std::vector<Mover>::const_iterator m = movers.begin(); m != movers.end(); ++m) {
+		disconnectOutOfRange(m->nic);
+	}
+
+	// new neighbour sets, handled per cell holding movers
+	std::vector<Mover>::const_iterator cellBegin = movers.begin();
+	while(cellBegin != movers.end()) {
+		const int cell = cellBegin->cell;
+		std::vector<Mover>::const_iterator cellEnd = cellBegin;
+		while(cellEnd != movers.end() && cellEnd->cell == cell) {
+			++cellEnd;
+		}
+
+		const int* first = &cellNeighbors[cell * MAX_CELL_NEIGHBORS];
+		const int* last  = first + cellNeighborCount[cell];
+		for(const int* c = first; c != last; ++c) {
+			CellEntries& entries = nicGrid[*c];
+			for(CellEntries::iterator i = entries.begin(); i != entries.end(); ++i) {
+				const Mover other(*c, *i);
+				const bool  moved = std::binary_search(movers.begin(), movers.end(), other);
+
+				for(std::vector<Mover>::const_iterator m = cellBegin; m != cellEnd; ++m) {
+					// pairs of movers are checked by the smaller one only
+					if ( moved && !(*m < other) ) continue;
+
+					connectIfInRange(m->nic, other.nic);
+				}
+			}
+		}
+		cellBegin = cellEnd;
+	}
+}
+
 bool BaseConnectionManager::registerNic(cModule*                 nic,
                                         ConnectionManagerAccess* chAccess,
                                         const Coord*             nicPos)
@@ -360,37 +471,19 @@ bool BaseConnectionManager::unregisterNic(cModule* nicModule)
 
 	NicEntries::mapped_type nicEntry = nicEntryIt->second;
 
-	// get all affected grid squares
-	CoordSet gridUnion(74);
-	GridCoord cell = getCellForCoordinate(nicEntry->pos);
-	if((gridDim.x == 1) && (gridDim.y == 1) && (gridDim.z == 1)) {
-		gridUnion.add(cell);
-	} else {
-		fillUnionWithNeighbors(gridUnion, cell);
-	}
-
-	// disconnect from all NICs in these grid squares
-	GridCoord* c = gridUnion.next();
-	while(c != 0) {
-		ccEV << "Update cons in [" << c->info() << "]" << endl;
-		NicEntries& nmap = getCellEntries(*c);
-		for(NicEntries::iterator i = nmap.begin(); i != nmap.end(); ++i) {
-			NicEntries::mapped_type other = i->second;
-			if (other == nicEntry)
-				continue;
-			if (other->isConnected(nicEntry)) {
-				other->disconnectFrom(nicEntry);
-			}
-			if (nicEntry->isConnected(other)) {
-				nicEntry->disconnectFrom(other);
-			}
+	// disconnect from all connected NICs, connections are symmetric
+	while(!nicEntry->getGateList().empty()) {
+		NicEntry* other = const_cast<NicEntry*>(nicEntry->getGateList().begin()->first);
+		nicEntry->disconnectFrom(other);
+		if (other->isConnected(nicEntry)) {
+			other->disconnectFrom(nicEntry);
 		}
-		c = gridUnion.next();
 	}
 
 	// erase from grid
-	NicEntries& cellEntries = getCellEntries(cell);
-	cellEntries.erase(nicID);
+	removeFromCell(getCellIndex(nicEntry->pos), nicEntry);
+	pendingMoves.erase(std::remove(pendingMoves.begin(), pendingMoves.end(), nicEntry),
+	                   pendingMoves.end());
 
 	unregisterNicExt(nicID);
 
@@ -416,11 +509,30 @@ void BaseConnectionManager::updateNicPos(NicEntry::t_nicid_cref nicID, const Coo
 	Coord oldPos = ItNic->second->pos;
 	ItNic->second->pos = *newPos;
 
+	if(batchUpdates) {
+		Enter_Method_Silent();
+
+		const int oldCell = getCellIndex(oldPos);
+		const int newCell = getCellIndex(*newPos);
+		if(oldCell != newCell) {
+			removeFromCell(oldCell, ItNic->second);
+			nicGrid[newCell].push_back(ItNic->second);
+		}
+
+		pendingMoves.push_back(ItNic->second);
+		if(!batchTimer->isScheduled()) {
+			scheduleAt(simTime(), batchTimer);
+		}
+		return;
+	}
+
 	updateConnections(nicID, &oldPos, newPos);
 }
 
-const NicEntry::GateList& BaseConnectionManager::getGateList(NicEntry::t_nicid_cref nicID) const
+const NicEntry::GateList& BaseConnectionManager::getGateList(NicEntry::t_nicid_cref nicID)
 {
+	flushPositionUpdates();
+
 	NicEntries::const_iterator ItNic = nics.find(nicID);
 	if (ItNic == nics.end()) {
 		opp_warning("No nic with this ID (%d) is registered with this ConnectionManager, return empty GateList", nicID);
@@ -433,8 +545,10 @@ const NicEntry::GateList& BaseConnectionManager::getGateList(NicEntry::t_nicid_c
 }
 
 const cGate* BaseConnectionManager::getOutGateTo(const NicEntry* nic,
-                                                 const NicEntry* targetNic) const
+                                                 const NicEntry* targetNic)
 {
+	flushPositionUpdates();
+
 	NicEntries::const_iterator ItNic = nics.find(nic->nicId);
 	if (ItNic == nics.end())
 		error("No nic with this ID (%d) is registered with this ConnectionManager.", nic->nicId);
@@ -444,6 +558,7 @@ const cGate* BaseConnectionManager::getOutGateTo(const NicEntry* nic,
 
 BaseConnectionManager::~BaseConnectionManager()
 {
+	cancelAndDelete(batchTimer);
 	for (NicEntries::iterator ne = nics.begin(); ne != nics.end(); ++ne) {
 		delete ne->second;
 	}
@@ -8,6 +8,8 @@
 #include "MiXiMDefs.h"
 #include "NicEntry.h"
 
+class MemoryPool;
+
 class ConnectionManagerAccess;
 
 /**
@@ -101,100 +103,6 @@ private:
 		}
 	};
 
-	/**
-	 * @brief Represents an minimalistic (hash)set of GridCoords.
-	 *
-	 * It is a workaround because c++ doesn't come with an hash set.
-	 */
-	class CoordSet {
-	protected:
-		/** @brief Holds the hash table.*/
-		std::vector<GridCoord*> data;
-		/** @brief maximum size of the hash table.*/
-		unsigned maxSize;
-		/** @brief Current number of entries in the hash table.*/
-		unsigned size;
-		/** @brief Holds the current element when iterating over this table.*/
-		unsigned current;
-
-	protected:
-
-		/**
-		 * @brief Tries to insert a GridCoord at the specified position.
-		 *
-		 * If the same Coord already exists there nothing happens.
-		 * If an other Coord already exists there calculate
-		 * a new Position to insert end recursively call this Method again.
-		 * If the spot is empty the Coord is inserted.
-		 */
-		void insert(const GridCoord& c, unsigned pos) {
-			if(data[pos] == 0) {
-				data[pos] = new GridCoord(c);
-				size++;
-			} else {
-				if(*data[pos] != c) {
-					insert(c, (pos + 2) % maxSize);
-				}
-			}
-		}
-
-	public:
-		/**
-		 * @brief Initializes the set (hashtable) with the a specified size.
-		 */
-		CoordSet(unsigned sz)
-			:data(), maxSize(sz), size(0), current(0)
-		{
-			data.resize(maxSize);
-		}
-
-		/**
-		 * @brief Delete every created GridCoord
-		 */
-		~CoordSet() {
-			for(std::vector<GridCoord*>::const_iterator it = data.begin(); it != data.end(); ++it) {
-				if(*it) {
-					delete *it;
-				}
-			}
-		}
-
-		/**
-		 * @brief Adds a GridCoord to the set.
-		 * If a GridCoord with the same value already exists in the set
-		 * nothing happens.
-		 */
-		void add(const GridCoord& c) {
-			unsigned hash = (c.x * 10000 + c.y * 100 + c.z) % maxSize;
-			insert(c, hash);
-		}
-
-		/**
-		 * @brief Returns the next GridCoord in the set.
-		 * You can iterate through the set only one time with this function!
-		 */
-		GridCoord* next() {
-			for(;current < maxSize; current++) {
-				if(data[current] != 0) {
-					return data[current++];
-				}
-			}
-			return 0;
-		}
-
-		/**
-		 * @brief Returns the number of GridCoords currently saved in this set.
-		 */
-		unsigned getSize() const { return size; }
-
-		/**
-		 * @brief Returns the maximum number of elements which can be stored inside
-		 * this set.
-		 * To prevent collisions the set should never be more than 75% filled.
-		 */
-		unsigned getmaxSize() const { return maxSize; }
-	};
-
 protected:
 	/** @brief Type for map from nic-module id to nic-module pointer.*/
 	typedef std::map<NicEntry::t_nicid, NicEntry*> NicEntries;
@@ -225,67 +133,144 @@ protected:
 	 * TkEnv.*/
 	bool drawMIR;
 
-	/** @brief Type for 1-dimensional array of NicEntries.*/
-	typedef std::vector<NicEntries> RowVector;
-	/** @brief Type for 2-dimensional array of NicEntries.*/
-	typedef std::vector<RowVector> NicMatrix;
-	/** @brief Type for 3-dimensional array of NicEntries.*/
-    typedef std::vector<NicMatrix> NicCube;
+	/**
+	 * @brief Stores if position updates are collected and applied in one
+	 * sweep per simulation time.
+	 */
+	bool batchUpdates;
+
+	/** @brief Nics moved since the last flush of the batched updates.*/
+	std::vector<NicEntry*> pendingMoves;
+
+	/** @brief Self message which flushes the batched position updates.*/
+	cMessage* batchTimer;
+
+	/** @brief Type for the NICs located inside one grid cell.*/
+	typedef std::vector<NicEntry*> CellEntries;
+
+	/** @brief Maximum number of cells in the neighbourhood of a cell.*/
+	static const int MAX_CELL_NEIGHBORS = 27;
 
 	/**
 	 * @brief Register of all nics
-     *
-     * This matrix keeps all nics according to their position.  It
-     * allows to restrict the position update to a subset of all nics.
-     */
-    NicCube nicGrid;
-
-    /**
-     * @brief Distance that helps to find a node under a certain
-     * position.
-     *
-     * Can be larger then @see maxInterferenceDistance to
-     * allow nodes to be placed into the same square if the playground
-     * is too small for the grid speedup to work.
+	 *
+	 * This flat array keeps all nics according to their position,
+	 * indexed by the linear index of their grid cell (see getCellIndex()).
+	 * It allows to restrict the position update to a subset of all nics.
 	 */
-    Coord findDistance;
+	std::vector<CellEntries> nicGrid;
 
-    /** @brief The size of the grid */
-    GridCoord gridDim;
+	/**
+	 * @brief Precomputed neighbourhood of every grid cell.
+	 *
+	 * Holds MAX_CELL_NEIGHBORS slots per cell of which the first
+	 * "cellNeighborCount[cell]" contain the distinct indices of the cell itself
+	 * and its direct (possibly torus wrapped) neighbours.
+	 */
+	std::vector<int> cellNeighbors;
+
+	/** @brief Number of valid entries per cell in "cellNeighbors".*/
+	std::vector<int> cellNeighborCount;
+
+	/**
+	 * @brief Distance that helps to find a node under a certain
+	 * position.
+	 *
+	 * Can be larger then @see maxInterferenceDistance to
+	 * allow nodes to be placed into the same square if the playground
+	 * is too small for the grid speedup to work.
+	 */
+	Coord findDistance;
+
+	/** @brief The size of the grid */
+	GridCoord gridDim;
 
 private:
-	/** @brief Manages the connections of a registered nic. */
-    void updateNicConnections(NicEntries& nmap, NicEntries::mapped_type nic);
-
-    /**
-     * @brief Check connections of a nic in the grid
-     */
-    void checkGrid(GridCoord&           oldCell,
-                   GridCoord&           newCell,
-                   NicEntry::t_nicid_cref id);
-
-    /**
-     * @brief Calculates the corresponding cell of a coordinate.
-     */
-    GridCoord getCellForCoordinate(const Coord& c) const;
-
-    /**
-     * @brief Returns the NicEntries of the cell with specified
-     * coordinate.
-     */
-    NicEntries& getCellEntries(const GridCoord& cell);
+	/**
+	 * @brief A moved nic together with its new grid cell.
+	 *
+	 * Internal helper of the batched position updates, ordered by cell
+	 * and nic id.
+	 */
+	struct Mover {
+		int       cell;
+		NicEntry* nic;
+
+		Mover(int cell, NicEntry* nic)
+			: cell(cell), nic(nic) {}
+
+		bool operator<(const Mover& o) const {
+			return cell < o.cell || (cell == o.cell && nic->nicId < o.nic->nicId);
+		}
+		bool operator==(const Mover& o) const {
+			return nic == o.nic;
+		}
+	};
+
+	/**
+	 * @brief Drops every connection of the passed nic to a nic which
+	 * is not in range anymore.
+	 */
+	void disconnectOutOfRange(NicEntry* nic);
+
+	/**
+	 * @brief Connects the two nics if they are in range and not yet
+	 * connected.
+	 */
+	void connectIfInRange(NicEntry* nic, NicEntry* other);
+
+	/**
+	 * @brief Updates the connections of the passed nic after it has been
+	 * moved or registered.
+	 *
+	 * The nic's current connections (its old neighbour set) are checked
+	 * and dropped if out of range. Afterwards the nics of the cells around
+	 * "cell" (the new neighbour set) which are not yet connected are
+	 * connected if in range.
+	 */
+	void updateNicConnections(NicEntry* nic, int cell);
+
+	/**
+	 * @brief Moves a nic between grid cells and updates its connections.
+	 */
+	void checkGrid(int oldCell, int newCell, NicEntry* nic);
+
+	/**
+	 * @brief Calculates the corresponding cell of a coordinate.
+	 */
+	GridCoord getCellForCoordinate(const Coord& c) const;
+
+	/**
+	 * @brief Returns the linear index of a grid cell inside "nicGrid".
+	 */
+	int getCellIndex(const GridCoord& cell) const {
+		return (cell.x * gridDim.y + cell.y) * gridDim.z + cell.z;
+	}
+
+	/**
+	 * @brief Returns the linear index of the grid cell of a coordinate.
+	 */
+	int getCellIndex(const Coord& c) const {
+		return getCellIndex(getCellForCoordinate(c));
+	}
+
+	/**
+	 * @brief Removes a nic from the entries of the passed cell.
+	 */
+	void removeFromCell(int cell, const NicEntry* nic);
 
 	/**
 	 * If the value is outside of its bounds (zero and max) this function
 	 * returns -1 if useTorus is false and the wrapped value if useTorus is true.
 	 * Otherwise its just returns the value unchanged.
 	 */
-    int wrapIfTorus(int value, int max) const;
+	int wrapIfTorus(int value, int max) const;
 
 	/**
-	 * @brief Adds every direct Neighbor of a GridCoord to a union of coords.
+	 * @brief Fills "cellNeighbors" and "cellNeighborCount" with the
+	 * neighbourhood of every grid cell.
 	 */
-    void fillUnionWithNeighbors(CoordSet& gridUnion, const GridCoord& cell) const;
+	void buildNeighborTable();
 protected:
 
 	/**
@@ -353,6 +338,26 @@ protected:
 	 */
 	virtual bool isInRange(NicEntries::mapped_type pFromNic, NicEntries::mapped_type pToNic);
 
+	/**
+	 * @brief Records the hit rate and the peak number of live objects of
+	 * the passed memory pool as scalars starting with "prefix".
+	 */
+	void recordPoolStatistics(const std::string& prefix, const MemoryPool& pool);
+
+	/** @brief Flushes the batched position updates.*/
+	virtual void handleMessage(cMessage* msg);
+
+	/**
+	 * @brief Recomputes the connections of all nics moved since the last
+	 * flush in one sweep over the grid.
+	 *
+	 * The movers are sorted by their new cell, so every pair of a cell
+	 * holding movers and one of its neighbour cells is scanned only once,
+	 * and every pair of two movers is checked only once.
+	 * Does nothing if no position updates are pending.
+	 */
+	virtual void flushPositionUpdates();
+
 private:
 	/** @brief Copy constructor is not allowed.
 	 */
@@ -376,6 +381,15 @@ public:
 	 **/
 	virtual void initialize(int stage);
 
+	/**
+	 * @brief Records the statistics of the AirFrame and Mapping memory
+	 * pools.
+	 *
+	 * The pools are shared by all NICs, so they are reported once by the
+	 * connection manager.
+	 */
+	virtual void finish();
+
 	/**
 	 * @brief Registers a nic to have its connections managed by ConnectionManager.
 	 *
@@ -398,14 +412,29 @@ public:
 	 */
 	bool unregisterNic(cModule* nic);
 
-	/** @brief Updates the position information of a registered nic.*/
+	/**
+	 * @brief Updates the position information of a registered nic.
+	 *
+	 * If "batchPositionUpdates" is set only the grid cell of the nic is
+	 * updated and its connections are recomputed together with those of
+	 * all other nics moved at the same simulation time, "updateConnections()"
+	 * isn't called in that case.
+	 */
 	void updateNicPos(NicEntry::t_nicid_cref nicID, const Coord* newPos);
 
-	/** @brief Returns the ingates of all nics in range*/
-	const NicEntry::GateList& getGateList(NicEntry::t_nicid_cref nicID) const;
+	/**
+	 * @brief Returns the ingates of all nics in range
+	 *
+	 * Applies pending batched position updates first.
+	 */
+	const NicEntry::GateList& getGateList(NicEntry::t_nicid_cref nicID);
 
-	/** @brief Returns the ingate of the with id==targetID, or 0 if not in range*/
-	const cGate* getOutGateTo(const NicEntry* nic, const NicEntry* targetNic) const;
+	/**
+	 * @brief Returns the ingate of the with id==targetID, or 0 if not in range
+	 *
+	 * Applies pending batched position updates first.
+	 */
+	const cGate* getOutGateTo(const NicEntry* nic, const NicEntry* targetNic);
 };
 
 #endif /*BASECONNECTIONMANAGER_H_*/
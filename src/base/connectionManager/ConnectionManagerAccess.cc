@@ -156,6 +156,7 @@ void ConnectionManagerAccess::receiveSignal(cComponent */*source*/, simsignal_t
     	ChannelMobilityPtrType const mobility = check_and_cast<ChannelMobilityPtrType>(obj);
         Coord                        pos      = mobility->getCurrentPosition();
 
+        ++positionEpoch;
         if(isRegistered) {
             cc->updateNicPos(getNic()->getId(), &pos);
         }
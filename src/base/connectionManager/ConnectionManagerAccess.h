@@ -81,6 +81,9 @@ protected:
 	/** @brief Is this module already registered with ConnectionManager? */
 	bool isRegistered;
 
+	/** @brief Number of position changes of the host seen so far. */
+	unsigned long positionEpoch;
+
 protected:
 	/**
 	 * @brief Calculates the propagation delay to the passed receiving nic.
@@ -123,6 +126,7 @@ public:
 		, coreDebug(false)
 		, usePropagationDelay(false)
 		, isRegistered(false)
+		, positionEpoch(0)
 	{}
 	ConnectionManagerAccess(unsigned sz)
 		: MiximBatteryAccess(sz)
@@ -132,6 +136,7 @@ public:
 		, coreDebug(false)
 		, usePropagationDelay(false)
 		, isRegistered(false)
+		, positionEpoch(0)
 	{}
 	virtual ~ConnectionManagerAccess() {}
 
@@ -167,6 +172,14 @@ public:
         {
             return ChannelMobilityAccessType::get(this);
         }
+
+	/**
+	 * @brief Returns the number of position changes of the host so far.
+	 *
+	 * The value changes with every mobility state change notification, as
+	 * long as it stays the same the position of the host is unchanged.
+	 */
+	unsigned long getPositionEpoch() const { return positionEpoch; }
 };
 
 #endif
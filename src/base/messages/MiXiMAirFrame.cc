@@ -0,0 +1,11 @@
+#include "MiXiMAirFrame.h"
+
+Register_Class(MiximAirFrame);
+
+MemoryPool& MiximAirFrame::getPool()
+{
+	//use "construct-on-first-use" idiom and never delete the pool since
+	//AirFrames may still be deleted during the clean up of the simulation
+	static MemoryPool* pool = new MemoryPool("AirFrames");
+	return *pool;
+}
@@ -8,6 +8,35 @@
 #ifndef MIXIMAIRFRAME_H_
 #define MIXIMAIRFRAME_H_
 
+#include "MiXiMDefs.h"
+#include "MemoryPool.h"
 #include "messages/MiximAirFrame_m.h"
 
+/**
+ * @brief Format of the packets that are sent to the channel.
+ *
+ * Adds pooled allocation to the generated MiximAirFrame_Base. AirFrames are
+ * duplicated for every receiving NIC and deleted as soon as the channel
+ * does not need them anymore, so their memory (and the one of subclasses
+ * like AirFrameUWBIR) is recycled by a MemoryPool.
+ *
+ * @ingroup phyLayer
+ */
+class MIXIM_API MiximAirFrame : public MiximAirFrame_Base
+{
+  public:
+    MiximAirFrame(const char *name=NULL, int kind=0) : MiximAirFrame_Base(name,kind) {}
+    MiximAirFrame(const MiximAirFrame& other) : MiximAirFrame_Base(other.getName()) {operator=(other);}
+    MiximAirFrame& operator=(const MiximAirFrame& other) {MiximAirFrame_Base::operator=(other); return *this;}
+    virtual MiximAirFrame *dup() const {return new MiximAirFrame(*this);}
+
+    /** @brief AirFrames are allocated from the AirFrame memory pool.*/
+    static void* operator new(size_t size) { return getPool().allocate(size); }
+    /** @brief Returns the memory of the AirFrame to the AirFrame memory pool.*/
+    static void operator delete(void* p, size_t size) { getPool().release(p, size); }
+
+    /** @brief Returns the memory pool all AirFrames are allocated from.*/
+    static MemoryPool& getPool();
+};
+
 #endif /* MIXIMAIRFRAME_H_ */
@@ -29,6 +29,7 @@
 #endif
 
 #include "Mapping.h"
+#include "GridMapping.h"
 #include "Signal_.h"
 #include "MacToPhyInterface.h"
 #include "MacToNetwControlInfo.h"
@@ -282,7 +283,8 @@ ConstMapping* BaseMacLayer::createSingleFrequencyMapping(simtime_t_cref
                                                          Argument::mapped_type_cref halfBandwidth,
                                                          Argument::mapped_type_cref value)
 {
-    Mapping* res = MappingUtils::createMapping(Argument::MappedZero, DimensionSet::timeFreqDomain, Mapping::LINEAR);
+    // the four corners span a full rectangular grid
+    Mapping* res = new GridMapping(DimensionSet::timeFreqDomain, Argument::MappedZero);
 
     Argument pos(DimensionSet::timeFreqDomain);
 
@@ -0,0 +1,423 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef BOUNDEDMACQUEUE_H_
+#define BOUNDEDMACQUEUE_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "MiXiMDefs.h"
+#include "SimpleAddress.h"
+
+/**
+ * @brief Bounded packet queue for MAC layers with optional priority
+ * classes and per-destination sub-queues.
+ *
+ * Packets are stored in ring buffers which only grow until they reached the
+ * largest number of queued packets. Every combination of priority class
+ * and destination which was ever used has its own ring buffer, sub-queues
+ * are kept when they run empty so they can be reused without allocating.
+ * front() and pop_front() serve the highest priority class (0 is the
+ * highest) first and, within a class, the packet which has been queued
+ * first. front(dest) and pop_front(dest) serve the oldest packet of the
+ * highest priority class for one destination. Without destinations (the
+ * default) all packets of a class share one sub-queue.
+ *
+ * Every class remembers the sub-queue of its packets in the order they were
+ * queued. Packets served by pop_front(dest) are skipped in that order when
+ * they reach its front and are compacted away once they make up the larger
+ * part of it. push_back() and pop_front() therefore take amortised constant
+ * time for the last used destination, looking up another destination takes
+ * logarithmic time in the number of destinations. Once the buffers have
+ * grown, the queue does not allocate in steady state.
+ *
+ * The queue keeps statistics about its occupancy and about the sojourn time
+ * of the dequeued packets, see recordStatistics().
+ *
+ * Like std::list the queue does not own the stored packets.
+ *
+ * @ingroup baseModules
+ */
+template<class T, class Key = LAddress::L2Type>
+class BoundedMacQueue {
+protected:
+	/** @brief A queued packet.*/
+	struct Entry {
+		T             packet;
+		/** @brief Time the packet was queued.*/
+		simtime_t     enqueued;
+		/** @brief Running number which defines the order between sub-queues.*/
+		unsigned long seq;
+	};
+
+	/** @brief Sub-queue and running number of a queued packet.*/
+	struct Arrival {
+		size_t        subQueue;
+		unsigned long seq;
+	};
+
+	/** @brief FIFO ring buffer.*/
+	template<class E>
+	class RingBuffer {
+	protected:
+		std::vector<E> buffer;
+		size_t         head;
+		size_t         count;
+
+	public:
+		RingBuffer(): buffer(), head(0), count(0) {}
+
+		bool   empty() const { return count == 0; }
+		size_t size() const  { return count; }
+
+		const E& front() const {
+			assert(count > 0);
+			return buffer[head];
+		}
+
+		/** @brief Returns the i-th element counted from the front.*/
+		E& at(size_t i) {
+			assert(i < count);
+			return buffer[(head + i) % buffer.size()];
+		}
+
+		void push_back(const E& e) {
+			if(count == buffer.size()) {
+				// full, double the storage and unwrap the content
+				std::vector<E> grown;
+				grown.reserve(buffer.empty() ? 4 : 2 * buffer.size());
+				for(size_t i = 0; i < count; ++i)
+					grown.push_back(buffer[(head + i) % buffer.size()]);
+				grown.resize(grown.capacity());
+				buffer.swap(grown);
+				head = 0;
+			}
+			buffer[(head + count) % buffer.size()] = e;
+			++count;
+		}
+
+		void pop_front() {
+			assert(count > 0);
+			head = (head + 1) % buffer.size();
+			--count;
+		}
+
+		/** @brief Keeps only the first n elements.*/
+		void truncate(size_t n) {
+			assert(n <= count);
+			count = n;
+		}
+	};
+
+	/** @brief Packets of one priority class and destination.*/
+	typedef RingBuffer<Entry> SubQueue;
+
+	/** @brief Sub-queues of one priority class by destination, indices into subQueues.*/
+	typedef std::map<Key, size_t> SubQueueIndex;
+
+	/** @brief Marks an unused sub-queue index.*/
+	enum { NONE = -1 };
+
+	/** @brief The packets of one priority class.*/
+	struct PriorityClass {
+		SubQueueIndex         index;
+		/** @brief Sub-queue of every queued packet in queuing order, may hold served packets.*/
+		RingBuffer<Arrival>   arrivals;
+		/** @brief Number of queued packets of this class.*/
+		size_t                length;
+		/** @brief Destination and sub-queue of the last push_back().*/
+		Key                   lastDest;
+		size_t                lastSubQueue;
+
+		PriorityClass(): index(), arrivals(), length(0), lastDest(), lastSubQueue(NONE) {}
+	};
+
+	/** @brief The packets of every priority class.*/
+	std::vector<PriorityClass> classes;
+	/** @brief Every sub-queue ever used, empty ones are kept for reuse.*/
+	std::vector<SubQueue>      subQueues;
+	/** @brief Maximum number of queued packets, 0 for unbounded.*/
+	size_t                     capacity;
+	/** @brief Number of queued packets.*/
+	size_t                     length;
+	/** @brief Running number of the next queued packet.*/
+	unsigned long              nextSeq;
+
+	/** @name Statistics.*/
+	/*@{*/
+	/** @brief Start of the statistics period.*/
+	simtime_t     statsStart;
+	/** @brief Last time the queue length changed.*/
+	simtime_t     lastChange;
+	/** @brief Integral of the queue length over time.*/
+	double        lengthIntegral;
+	/** @brief Maximum queue length.*/
+	size_t        maxLength;
+	/** @brief Number of queued packets.*/
+	unsigned long nbEnqueued;
+	/** @brief Number of dequeued packets.*/
+	unsigned long nbDequeued;
+	/** @brief Number of packets refused because the queue was full.*/
+	unsigned long nbDropped;
+	/** @brief Sum and maximum of the sojourn times of the dequeued packets.*/
+	double        sojournSum, sojournMax;
+	/*@}*/
+
+protected:
+	/** @brief Adds the time since the last length change to the length integral.*/
+	void updateLengthIntegral() {
+		const simtime_t now = simTime();
+		lengthIntegral += length * SIMTIME_DBL(now - lastChange);
+		lastChange      = now;
+	}
+
+	/** @brief Returns the sub-queue of a class for dest, NONE if it was never used.*/
+	size_t findSubQueue(const PriorityClass& pc, const Key& dest) const {
+		if(pc.lastSubQueue != size_t(NONE) && pc.lastDest == dest)
+			return pc.lastSubQueue;
+		typename SubQueueIndex::const_iterator it = pc.index.find(dest);
+		return it == pc.index.end() ? size_t(NONE) : it->second;
+	}
+
+	/** @brief Returns true if the packet of the passed arrival was not served yet.*/
+	bool isQueued(const Arrival& a) const {
+		const SubQueue& subQueue = subQueues[a.subQueue];
+		return !subQueue.empty() && subQueue.front().seq <= a.seq;
+	}
+
+	/** @brief Returns the class holding the next packet, NULL if the queue is empty.*/
+	PriorityClass* nextClass() const {
+		for(size_t c = 0; c < classes.size(); ++c) {
+			if(classes[c].length > 0)
+				return const_cast<PriorityClass*>(&classes[c]);
+		}
+		return NULL;
+	}
+
+	/** @brief Returns the class holding the next packet for dest, NULL if there is none.*/
+	PriorityClass* nextClass(const Key& dest) const {
+		for(size_t c = 0; c < classes.size(); ++c) {
+			const size_t s = findSubQueue(classes[c], dest);
+			if(s != size_t(NONE) && !subQueues[s].empty())
+				return const_cast<PriorityClass*>(&classes[c]);
+		}
+		return NULL;
+	}
+
+	/**
+	 * @brief Removes the first packet of the passed sub-queue of a class
+	 * and updates the statistics.
+	 *
+	 * Afterwards the front of the arrivals of the class is a queued packet
+	 * again, served packets are dropped from it.
+	 */
+	void pop(PriorityClass* pc, size_t s) {
+		assert(pc && s < subQueues.size());
+		SubQueue& subQueue = subQueues[s];
+
+		updateLengthIntegral();
+		const double sojourn = SIMTIME_DBL(simTime() - subQueue.front().enqueued);
+		sojournSum += sojourn;
+		if(sojourn > sojournMax)
+			sojournMax = sojourn;
+		++nbDequeued;
+
+		subQueue.pop_front();
+		--length;
+		--pc->length;
+
+		RingBuffer<Arrival>& arrivals = pc->arrivals;
+		while(!arrivals.empty() && !isQueued(arrivals.front()))
+			arrivals.pop_front();
+
+		// packets served by destination are compacted away once they dominate
+		if(arrivals.size() > 2 * pc->length + 16) {
+			size_t kept = 0;
+			for(size_t i = 0; i < arrivals.size(); ++i) {
+				if(isQueued(arrivals.at(i)))
+					arrivals.at(kept++) = arrivals.at(i);
+			}
+			arrivals.truncate(kept);
+		}
+	}
+
+public:
+	/**
+	 * @brief Initializes an empty queue.
+	 *
+	 * @param capacity     Maximum number of queued packets, 0 for unbounded.
+	 * @param nbPriorities Number of priority classes.
+	 */
+	BoundedMacQueue(size_t capacity = 0, int nbPriorities = 1):
+		classes(nbPriorities), subQueues(), capacity(capacity), length(0), nextSeq(0),
+		statsStart(), lastChange(), lengthIntegral(0), maxLength(0),
+		nbEnqueued(0), nbDequeued(0), nbDropped(0), sojournSum(0), sojournMax(0)
+	{
+		assert(nbPriorities > 0);
+	}
+
+	/** @brief Sets the maximum number of queued packets, 0 for unbounded.*/
+	void setCapacity(size_t newCapacity) { capacity = newCapacity; }
+
+	/** @brief Returns the maximum number of queued packets, 0 for unbounded.*/
+	size_t getCapacity() const { return capacity; }
+
+	/** @brief Sets the number of priority classes, only allowed while the queue is empty.*/
+	void setNbPriorities(int nbPriorities) {
+		assert(nbPriorities > 0 && empty());
+		classes.resize(nbPriorities);
+	}
+
+	/** @brief Returns the number of priority classes.*/
+	int getNbPriorities() const { return static_cast<int>(classes.size()); }
+
+	/** @brief Returns the number of queued packets.*/
+	size_t size() const { return length; }
+
+	/** @brief Returns true if no packet is queued.*/
+	bool empty() const { return length == 0; }
+
+	/** @brief Returns true if no further packet can be queued.*/
+	bool full() const { return capacity > 0 && length >= capacity; }
+
+	/**
+	 * @brief Queues a packet unless the queue is full.
+	 *
+	 * @param packet   The packet to queue.
+	 * @param priority Priority class of the packet, 0 is the highest.
+	 * @param dest     Destination sub-queue of the packet.
+	 * @return false if the queue was full and the packet was not queued,
+	 *         the caller keeps ownership of the packet then.
+	 */
+	bool push_back(const T& packet, int priority = 0, const Key& dest = Key()) {
+		assert(priority >= 0 && priority < getNbPriorities());
+		if(full()) {
+			++nbDropped;
+			return false;
+		}
+		updateLengthIntegral();
+
+		Entry e;
+		e.packet   = packet;
+		e.enqueued = simTime();
+		e.seq      = nextSeq++;
+
+		PriorityClass& pc = classes[priority];
+		Arrival        a;
+		a.subQueue = findSubQueue(pc, dest);
+		a.seq      = e.seq;
+		if(a.subQueue == size_t(NONE)) {
+			a.subQueue = subQueues.size();
+			subQueues.push_back(SubQueue());
+			pc.index[dest] = a.subQueue;
+		}
+		pc.lastDest     = dest;
+		pc.lastSubQueue = a.subQueue;
+		subQueues[a.subQueue].push_back(e);
+		pc.arrivals.push_back(a);
+
+		++pc.length;
+		++length;
+		++nbEnqueued;
+		if(length > maxLength)
+			maxLength = length;
+		return true;
+	}
+
+	/** @brief Returns the next packet, the queue must not be empty.*/
+	const T& front() const {
+		const PriorityClass* pc = nextClass();
+		assert(pc);
+		return subQueues[pc->arrivals.front().subQueue].front().packet;
+	}
+
+	/** @brief Removes the next packet, the queue must not be empty.*/
+	void pop_front() {
+		PriorityClass* pc = nextClass();
+		assert(pc);
+		pop(pc, pc->arrivals.front().subQueue);
+	}
+
+	/** @brief Returns true if a packet for the passed destination is queued.*/
+	bool hasPacketFor(const Key& dest) const { return nextClass(dest) != NULL; }
+
+	/** @brief Returns the next packet for the passed destination, there must be one.*/
+	const T& front(const Key& dest) const {
+		const PriorityClass* pc = nextClass(dest);
+		assert(pc);
+		return subQueues[findSubQueue(*pc, dest)].front().packet;
+	}
+
+	/** @brief Removes the next packet for the passed destination, there must be one.*/
+	void pop_front(const Key& dest) {
+		PriorityClass* pc = nextClass(dest);
+		assert(pc);
+		pop(pc, findSubQueue(*pc, dest));
+	}
+
+	/** @brief Restarts the statistics period, the queued packets are kept.*/
+	void resetStatistics() {
+		statsStart     = simTime();
+		lastChange     = statsStart;
+		lengthIntegral = 0;
+		maxLength      = length;
+		nbEnqueued     = nbDequeued = nbDropped = 0;
+		sojournSum     = sojournMax = 0;
+	}
+
+	/** @brief Returns the time average of the queue length.*/
+	double getMeanLength() const {
+		const double duration = SIMTIME_DBL(simTime() - statsStart);
+		if(duration <= 0)
+			return length;
+		return (lengthIntegral + length * SIMTIME_DBL(simTime() - lastChange)) / duration;
+	}
+
+	/** @brief Returns the maximum queue length.*/
+	size_t getMaxLength() const { return maxLength; }
+
+	/** @brief Returns the number of queued packets.*/
+	unsigned long getNbEnqueued() const { return nbEnqueued; }
+
+	/** @brief Returns the number of packets refused because the queue was full.*/
+	unsigned long getNbDropped() const { return nbDropped; }
+
+	/** @brief Returns the mean sojourn time of the dequeued packets.*/
+	double getMeanSojournTime() const { return nbDequeued > 0 ? sojournSum / nbDequeued : 0; }
+
+	/** @brief Returns the maximum sojourn time of the dequeued packets.*/
+	double getMaxSojournTime() const { return sojournMax; }
+
+	/**
+	 * @brief Records the queue statistics as scalars of the passed module,
+	 * each scalar name starts with prefix.
+	 */
+	void recordStatistics(cComponent* module, const std::string& prefix = "queue") const {
+		module->recordScalar((prefix + "MeanLength").c_str(),      getMeanLength());
+		module->recordScalar((prefix + "MaxLength").c_str(),       getMaxLength());
+		module->recordScalar((prefix + "NbEnqueued").c_str(),      getNbEnqueued());
+		module->recordScalar((prefix + "NbDropped").c_str(),       getNbDropped());
+		module->recordScalar((prefix + "MeanSojournTime").c_str(), getMeanSojournTime());
+		module->recordScalar((prefix + "MaxSojournTime").c_str(),  getMaxSojournTime());
+	}
+};
+
+#endif /* BOUNDEDMACQUEUE_H_ */
@@ -0,0 +1,128 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef DUPLICATECACHE_H_
+#define DUPLICATECACHE_H_
+
+#include <cstddef>
+
+#include "MiXiMDefs.h"
+#include "NeighborTable.h"
+
+/**
+ * @brief Remembers the ids of already seen messages for duplicate
+ * suppression in network layers.
+ *
+ * Ids are typically (source address, sequence number) pairs. They are kept
+ * in a hash table, so insert() and contains() take constant time regardless
+ * of the number of remembered messages.
+ *
+ * An id is forgotten lifetime seconds after it has been inserted for the last
+ * time. Since all ids have the same lifetime, the order of their last
+ * insertion is also the order in which they expire: the table keeps its
+ * entries in this order and removes expired ids from its old end, so the
+ * expiry costs constant time per id, too.
+ *
+ * If the maximum number of ids is reached, inserting a new id forgets the
+ * one which would expire next.
+ *
+ * @ingroup baseModules
+ */
+template<class Key, class Hash = NeighborKeyHash<Key> >
+class DuplicateCache {
+protected:
+	/** @brief Expiry time of every remembered id, least recently inserted first.*/
+	NeighborTable<simtime_t, Key, Hash> ids;
+	/** @brief Time an id is remembered, 0 for ever.*/
+	simtime_t                           lifetime;
+
+protected:
+	/** @brief Returns true if the passed expiry time has been passed at now.*/
+	bool expired(simtime_t_cref expiry, simtime_t_cref now) const {
+		return lifetime > SIMTIME_ZERO && expiry < now;
+	}
+
+public:
+	/**
+	 * @brief Initializes an empty cache.
+	 *
+	 * @param maxEntries Maximum number of remembered ids, 0 for unbounded.
+	 * @param lifetime   Time an id is remembered, 0 for ever.
+	 */
+	DuplicateCache(size_t maxEntries = 0, simtime_t_cref lifetime = SIMTIME_ZERO):
+		ids(), lifetime(lifetime)
+	{
+		setMaxEntries(maxEntries);
+	}
+
+	/** @brief Forgets all ids and sets the maximum number of ids, 0 for unbounded.*/
+	void setMaxEntries(size_t maxEntries) {
+		ids.setCapacity(maxEntries, maxEntries == 0);
+	}
+
+	/** @brief Sets the time an id is remembered after its last insertion, 0 for ever.*/
+	void setLifetime(simtime_t_cref newLifetime) { lifetime = newLifetime; }
+
+	/** @brief Returns the number of remembered ids, including expired ones not yet purged.*/
+	size_t size() const { return ids.size(); }
+
+	/** @brief Forgets all ids.*/
+	void clear() { ids.clear(); }
+
+	/** @brief Forgets the ids which have expired at now.*/
+	void purge(simtime_t_cref now) {
+		const simtime_t* oldest = ids.oldest();
+		while(oldest != NULL && expired(*oldest, now)) {
+			ids.eraseOldest();
+			oldest = ids.oldest();
+		}
+	}
+
+	/** @brief Forgets the expired ids.*/
+	void purge() { purge(simTime()); }
+
+	/** @brief Returns true if the id is remembered at now.*/
+	bool contains(const Key& id, simtime_t_cref now) const {
+		const simtime_t* expiry = ids.find(id);
+		return expiry != NULL && !expired(*expiry, now);
+	}
+
+	/** @brief Returns true if the id is remembered.*/
+	bool contains(const Key& id) const { return contains(id, simTime()); }
+
+	/**
+	 * @brief Remembers an id for another lifetime starting at now.
+	 *
+	 * Calls have to be in order of time.
+	 *
+	 * @return true if the id was not remembered before, i.e. the message has
+	 *         not been seen yet.
+	 */
+	bool insert(const Key& id, simtime_t_cref now) {
+		purge(now);
+		bool isNew = false;
+		simtime_t* expiry = ids.update(id, &isNew);
+		*expiry = now + lifetime;
+		return isNew;
+	}
+
+	/** @brief Remembers an id for another lifetime starting now.*/
+	bool insert(const Key& id) { return insert(id, simTime()); }
+
+	/** @brief Forgets an id, returns false if it was not remembered.*/
+	bool erase(const Key& id) { return ids.erase(id); }
+};
+
+#endif /* DUPLICATECACHE_H_ */
@@ -0,0 +1,322 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef NEIGHBORTABLE_H_
+#define NEIGHBORTABLE_H_
+
+#include <cassert>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "MiXiMDefs.h"
+#include "SimpleAddress.h"
+
+/**
+ * @brief Hash function for the keys of a NeighborTable.
+ *
+ * The default uses the documented cast of layer addresses to long.
+ *
+ * @ingroup baseModules
+ */
+template<class Key>
+struct NeighborKeyHash {
+	size_t operator()(const Key& key) const { return static_cast<size_t>(key); }
+};
+
+#ifdef MIXIM_INET
+/** @brief Hash function for INET MAC addresses.*/
+template<>
+struct NeighborKeyHash<MACAddress> {
+	size_t operator()(const MACAddress& key) const {
+		const uint64 bits = key.getInt();
+		return static_cast<size_t>(bits ^ (bits >> 32));
+	}
+};
+#endif
+
+/** @brief Hash function for composed keys, e.g. (source address, sequence number).*/
+template<class A, class B>
+struct NeighborKeyHash< std::pair<A, B> > {
+	size_t operator()(const std::pair<A, B>& key) const {
+		return NeighborKeyHash<A>()(key.first) * 31 + NeighborKeyHash<B>()(key.second);
+	}
+};
+
+/**
+ * @brief Bounded table of per-neighbor state with least recently used
+ * replacement.
+ *
+ * Lookups go through an open addressing hash index with linear probing,
+ * so find() and update() take constant time independent of the number of
+ * neighbors. The entries are additionally kept in least recently used order:
+ * update() marks an entry as the most recently used one and, if the key is
+ * not yet known and the table is full, replaces the least recently used
+ * entry. find() does not change the order, so entries age by the time of
+ * their last update().
+ *
+ * All storage is allocated by setCapacity(), Entry has to be default
+ * constructible and assignable. A growable table doubles its capacity
+ * instead of replacing entries.
+ *
+ * @ingroup baseModules
+ */
+template<class Entry, class Key = LAddress::L2Type, class Hash = NeighborKeyHash<Key> >
+class NeighborTable {
+protected:
+	/** @brief Marks an empty bucket or the end of a list.*/
+	enum { NONE = -1 };
+
+	/** @brief Storage of one entry.*/
+	struct Slot {
+		Key   key;
+		Entry entry;
+		/** @brief Neighbors in the usage list, or next free slot.*/
+		int   prev, next;
+
+		Slot(): key(), entry(), prev(NONE), next(NONE) {}
+	};
+
+	/** @brief Entry storage, never grows beyond capacity.*/
+	std::vector<Slot> slots;
+	/** @brief Hash index of slot numbers, its size is a power of two.*/
+	std::vector<int>  buckets;
+	/** @brief Maximum number of entries.*/
+	size_t            capacity;
+	/** @brief Grow instead of replacing the least recently used entry.*/
+	bool              growable;
+	/** @brief Number of entries.*/
+	size_t            count;
+	/** @brief Most and least recently used slot.*/
+	int               mru, lru;
+	/** @brief First slot released by erase().*/
+	int               freeSlots;
+	Hash              hash;
+
+protected:
+	/** @brief Returns the home bucket of a key.*/
+	size_t bucketOf(const Key& key) const {
+		size_t h = hash(key);
+		// spread sequential addresses over the index
+		h ^= h >> 16;
+		h *= 0x45d9f3b;
+		h ^= h >> 16;
+		return h & (buckets.size() - 1);
+	}
+
+	/** @brief Returns the bucket holding key, or the empty bucket ending its probe sequence.*/
+	size_t probe(const Key& key) const {
+		size_t b = bucketOf(key);
+		while(buckets[b] != NONE && !(slots[buckets[b]].key == key))
+			b = (b + 1) & (buckets.size() - 1);
+		return b;
+	}
+
+	/** @brief Returns the slot holding key, NONE if it is unknown.*/
+	int lookup(const Key& key) const {
+		if(count == 0)
+			return NONE;
+		return buckets[probe(key)];
+	}
+
+	/** @brief Removes the key of the passed slot from the hash index.*/
+	void unindex(int s) {
+		const size_t mask = buckets.size() - 1;
+		size_t hole = probe(slots[s].key);
+		assert(buckets[hole] == s);
+		buckets[hole] = NONE;
+		// move later members of the probe sequence into the hole
+		for(size_t b = (hole + 1) & mask; buckets[b] != NONE; b = (b + 1) & mask) {
+			const size_t home = bucketOf(slots[buckets[b]].key);
+			const bool reachable = (hole <= b) ? (hole < home && home <= b)
+			                                   : (hole < home || home <= b);
+			if(!reachable) {
+				buckets[hole] = buckets[b];
+				buckets[b]    = NONE;
+				hole          = b;
+			}
+		}
+	}
+
+	/** @brief Removes a slot from the usage list.*/
+	void unlink(int s) {
+		Slot& slot = slots[s];
+		if(slot.prev != NONE) slots[slot.prev].next = slot.next; else mru = slot.next;
+		if(slot.next != NONE) slots[slot.next].prev = slot.prev; else lru = slot.prev;
+		slot.prev = slot.next = NONE;
+	}
+
+	/** @brief Removes the entry of a slot and puts the slot on the free list.*/
+	void release(int s) {
+		unindex(s);
+		unlink(s);
+		slots[s].next = freeSlots;
+		freeSlots     = s;
+		--count;
+	}
+
+	/** @brief Doubles the capacity and rebuilds the hash index.*/
+	void grow() {
+		capacity = (capacity > 0) ? 2 * capacity : 16;
+		slots.reserve(capacity);
+		size_t nbBuckets = buckets.size();
+		while(nbBuckets < 2 * capacity)
+			nbBuckets <<= 1;
+		buckets.assign(nbBuckets, NONE);
+		for(int s = mru; s != NONE; s = slots[s].next)
+			buckets[probe(slots[s].key)] = s;
+	}
+
+	/** @brief Inserts a slot as the most recently used one.*/
+	void pushFront(int s) {
+		slots[s].prev = NONE;
+		slots[s].next = mru;
+		if(mru != NONE) slots[mru].prev = s; else lru = s;
+		mru = s;
+	}
+
+public:
+	/** @brief Initializes a table for at most capacity entries.*/
+	NeighborTable(size_t capacity = 0, bool growable = false):
+		slots(), buckets(), capacity(0), growable(false), count(0), mru(NONE),
+		lru(NONE), freeSlots(NONE), hash()
+	{
+		setCapacity(capacity, growable);
+	}
+
+	/**
+	 * @brief Removes all entries and sets the maximum number of entries.
+	 *
+	 * A growable table uses newCapacity as initial capacity.
+	 */
+	void setCapacity(size_t newCapacity, bool isGrowable = false) {
+		capacity = newCapacity;
+		growable = isGrowable;
+		size_t nbBuckets = 1;
+		while(nbBuckets < 2 * capacity)
+			nbBuckets <<= 1;
+		buckets.assign(nbBuckets, NONE);
+		slots.clear();
+		slots.reserve(capacity);
+		count     = 0;
+		mru       = lru = NONE;
+		freeSlots = NONE;
+	}
+
+	/** @brief Returns the maximum number of entries.*/
+	size_t getCapacity() const { return capacity; }
+
+	/** @brief Returns the number of entries.*/
+	size_t size() const { return count; }
+
+	/** @brief Returns true if the table has no entries.*/
+	bool empty() const { return count == 0; }
+
+	/** @brief Returns true if a new key replaces the least recently used entry.*/
+	bool full() const { return !growable && count >= capacity; }
+
+	/** @brief Removes all entries.*/
+	void clear() { setCapacity(capacity, growable); }
+
+	/** @brief Returns the entry of key, NULL if it is unknown.*/
+	Entry* find(const Key& key) {
+		const int s = lookup(key);
+		return (s == NONE) ? NULL : &slots[s].entry;
+	}
+
+	/** @brief Returns the entry of key, NULL if it is unknown.*/
+	const Entry* find(const Key& key) const {
+		const int s = lookup(key);
+		return (s == NONE) ? NULL : &slots[s].entry;
+	}
+
+	/**
+	 * @brief Returns the entry of key and marks it as most recently used.
+	 *
+	 * An unknown key gets a default constructed entry, which replaces the
+	 * least recently used entry if the table is full.
+	 *
+	 * @param key      The key to update.
+	 * @param inserted If not NULL, set to true if the entry is new.
+	 * @return The entry of key, NULL if the capacity of a table which is
+	 *         not growable is 0.
+	 */
+	Entry* update(const Key& key, bool* inserted = NULL) {
+		if(inserted)
+			*inserted = false;
+		if(capacity == 0 && !growable)
+			return NULL;
+
+		int s = lookup(key);
+		if(s != NONE) {
+			if(s != mru) {
+				unlink(s);
+				pushFront(s);
+			}
+			return &slots[s].entry;
+		}
+
+		if(count >= capacity && !growable) {
+			// replace the least recently used entry
+			s = lru;
+			unindex(s);
+			unlink(s);
+			--count;
+		}
+		else {
+			if(count >= capacity)
+				grow();
+			if(freeSlots != NONE) {
+				s         = freeSlots;
+				freeSlots = slots[s].next;
+			}
+			else {
+				s = static_cast<int>(slots.size());
+				slots.push_back(Slot());
+			}
+		}
+
+		slots[s].key   = key;
+		slots[s].entry = Entry();
+		buckets[probe(key)] = s;
+		pushFront(s);
+		++count;
+		if(inserted)
+			*inserted = true;
+		return &slots[s].entry;
+	}
+
+	/** @brief Removes the entry of key, returns false if it is unknown.*/
+	bool erase(const Key& key) {
+		const int s = lookup(key);
+		if(s == NONE)
+			return false;
+		release(s);
+		return true;
+	}
+
+	/** @brief Removes the least recently updated entry, returns false if the table is empty.*/
+	bool eraseOldest() {
+		if(lru == NONE)
+			return false;
+		release(lru);
+		return true;
+	}
+
+	/** @brief Returns the least recently updated entry, NULL if the table is empty.*/
+	Entry* oldest() { return (lru == NONE) ? NULL : &slots[lru].entry; }
+};
+
+#endif /* NEIGHBORTABLE_H_ */
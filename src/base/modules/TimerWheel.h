@@ -0,0 +1,328 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "MiXiMDefs.h"
+
+/**
+ * @brief Module local set of timers, e.g. one expiry per neighbor, which
+ * needs only a single scheduled self message per module.
+ *
+ * The timers are kept in a hierarchical timer wheel: LEVELS wheels of SLOTS
+ * slots each, a slot of level l spans SLOTS^l ticks of the set resolution.
+ * A timer is put into the lowest level whose range covers its expiry and is
+ * moved down a level when the wheel reaches its slot, so schedule(),
+ * reschedule() and cancel() take constant time independent of the number
+ * of timers. Timers expire at their exact time, the resolution only
+ * controls how the timers are spread over the slots. Timers with the same
+ * expiry are returned in the order they have been scheduled, like the
+ * entries of a std::multimap<simtime_t, T>.
+ *
+ * The owning module schedules its self message to nextExpiry() and calls
+ * popExpired() when it arrives:
+ *
+ * @code
+ * T data;
+ * while(timers.popExpired(simTime(), data))
+ *     handleExpiry(data);
+ * if(!timers.empty())
+ *     scheduleAt(timers.nextExpiry(), wakeUp);
+ * @endcode
+ *
+ * @ingroup baseModules
+ */
+template<class T>
+class TimerWheel {
+public:
+	/** @brief Identifies a scheduled timer, stays valid until it expires or is canceled.*/
+	typedef int handle_t;
+
+protected:
+	enum {
+		/** @brief Marks an empty slot or the end of a list.*/
+		NONE      = -1,
+		SLOT_BITS = 6,
+		SLOTS     = 1 << SLOT_BITS,
+		LEVELS    = 4
+	};
+
+	/** @brief Storage of one timer.*/
+	struct Timer {
+		simtime_t expiry;
+		/** @brief The tick of the expiry.*/
+		int64     tick;
+		/** @brief Orders timers with the same expiry.*/
+		uint64    seq;
+		T         data;
+		/** @brief Neighbors in the slot list, or next free timer.*/
+		int       prev, next;
+		/** @brief The slot holding the timer, NONE if it is free.*/
+		int       slot;
+
+		Timer(): expiry(), tick(0), seq(0), data(), prev(NONE), next(NONE), slot(NONE) {}
+	};
+
+	/** @brief Timer storage, the handles are indices into it.*/
+	std::vector<Timer> timers;
+	/** @brief First and last timer of every slot, level after level.*/
+	std::vector<int>   heads, tails;
+	/** @brief Number of timers per level.*/
+	size_t             levelCount[LEVELS];
+	/** @brief Length of one tick.*/
+	simtime_t          resolution;
+	/** @brief The position of the wheel, never after the earliest timer.*/
+	int64              currentTick;
+	uint64             nextSeq;
+	/** @brief Number of scheduled timers.*/
+	size_t             count;
+	/** @brief First timer released by cancel() or popExpired().*/
+	int                freeTimers;
+
+protected:
+	int64 tickOf(simtime_t_cref t) const {
+		return SIMTIME_RAW(t) / SIMTIME_RAW(resolution);
+	}
+
+	/** @brief Returns true if timer a expires before timer b.*/
+	bool before(int a, int b) const {
+		return timers[a].expiry < timers[b].expiry
+		       || (timers[a].expiry == timers[b].expiry && timers[a].seq < timers[b].seq);
+	}
+
+	/** @brief Puts a timer into the slot which covers its expiry.*/
+	void link(int t) {
+		const int64 maxDelta = (static_cast<int64>(1) << (SLOT_BITS * LEVELS)) - 1;
+		int64       delta    = timers[t].tick - currentTick;
+		if(delta < 0)
+			delta = 0;      // already due, handled with the current tick
+		else if(delta > maxDelta)
+			delta = maxDelta; // moved down again once the last level reaches it
+
+		int level = 0;
+		while(level < LEVELS - 1 && delta >= (static_cast<int64>(1) << (SLOT_BITS * (level + 1))))
+			++level;
+
+		const int slot = level * SLOTS + static_cast<int>(((currentTick + delta) >> (SLOT_BITS * level)) & (SLOTS - 1));
+		timers[t].slot = slot;
+		timers[t].prev = tails[slot];
+		timers[t].next = NONE;
+		if(tails[slot] != NONE) timers[tails[slot]].next = t; else heads[slot] = t;
+		tails[slot] = t;
+		++levelCount[level];
+	}
+
+	/** @brief Removes a timer from its slot.*/
+	void unlink(int t) {
+		Timer&    timer = timers[t];
+		const int slot  = timer.slot;
+		if(timer.prev != NONE) timers[timer.prev].next = timer.next; else heads[slot] = timer.next;
+		if(timer.next != NONE) timers[timer.next].prev = timer.prev; else tails[slot] = timer.prev;
+		timer.prev = timer.next = NONE;
+		timer.slot = NONE;
+		--levelCount[slot / SLOTS];
+	}
+
+	/** @brief Unlinks a timer and puts it on the free list.*/
+	void release(int t) {
+		unlink(t);
+		timers[t].data = T();
+		timers[t].next = freeTimers;
+		freeTimers     = t;
+		--count;
+	}
+
+	/** @brief Moves the timers of a slot to the levels below.*/
+	void cascade(int level, int index) {
+		const int slot = level * SLOTS + index;
+		int       t    = heads[slot];
+
+		heads[slot] = tails[slot] = NONE;
+		while(t != NONE) {
+			const int next = timers[t].next;
+			--levelCount[level];
+			link(t);
+			t = next;
+		}
+	}
+
+	/**
+	 * @brief Moves the wheel to the next tick at which timers of a higher
+	 * level reach a lower one.
+	 *
+	 * Must only be called if the current block of level 0 has no timers.
+	 * Empty slots of the lowest used level are skipped at once.
+	 */
+	void advance() {
+		int lowest = 0;
+		while(lowest < LEVELS && levelCount[lowest] == 0)
+			++lowest;
+		assert(lowest < LEVELS);
+
+		// the timers left in level 0 belong to its next block
+		const int level = (lowest == 0) ? 1 : lowest;
+		const int shift = SLOT_BITS * level;
+		int64     block = currentTick >> shift;
+		int       index = static_cast<int>(block & (SLOTS - 1));
+		do {
+			++block;
+			++index;
+		} while(lowest > 0 && index < SLOTS && heads[level * SLOTS + index] == NONE);
+
+		currentTick = block << shift;
+		for(int l = level; l < LEVELS; ++l) {
+			const int i = static_cast<int>((currentTick >> (SLOT_BITS * l)) & (SLOTS - 1));
+			cascade(l, i);
+			if(i != 0)
+				break;
+		}
+	}
+
+	/** @brief Returns the timer which expires next, NONE if there is none.*/
+	int earliest() {
+		if(count == 0)
+			return NONE;
+
+		for(;;) {
+			if(levelCount[0] > 0) {
+				for(int index = static_cast<int>(currentTick & (SLOTS - 1)); index < SLOTS; ++index) {
+					if(heads[index] == NONE)
+						continue;
+
+					currentTick = (currentTick & ~static_cast<int64>(SLOTS - 1)) | index;
+					int first = heads[index];
+					for(int t = timers[first].next; t != NONE; t = timers[t].next) {
+						if(before(t, first))
+							first = t;
+					}
+					return first;
+				}
+			}
+			advance();
+		}
+	}
+
+public:
+	/** @brief Initializes an empty wheel with the passed tick length.*/
+	TimerWheel(simtime_t_cref resolution = 0.001):
+		timers(), heads(LEVELS * SLOTS, NONE), tails(LEVELS * SLOTS, NONE),
+		resolution(), currentTick(0), nextSeq(0), count(0), freeTimers(NONE)
+	{
+		setResolution(resolution);
+	}
+
+	/**
+	 * @brief Cancels all timers and sets the tick length.
+	 *
+	 * About SLOTS ticks should cover the usual delay of a timer.
+	 */
+	void setResolution(simtime_t_cref newResolution) {
+		assert(newResolution > SIMTIME_ZERO);
+		resolution = newResolution;
+		clear();
+	}
+
+	/** @brief Returns the number of scheduled timers.*/
+	size_t size() const { return count; }
+
+	/** @brief Returns true if no timer is scheduled.*/
+	bool empty() const { return count == 0; }
+
+	/** @brief Cancels all timers.*/
+	void clear() {
+		timers.clear();
+		heads.assign(LEVELS * SLOTS, NONE);
+		tails.assign(LEVELS * SLOTS, NONE);
+		for(int l = 0; l < LEVELS; ++l)
+			levelCount[l] = 0;
+		currentTick = 0;
+		count       = 0;
+		freeTimers  = NONE;
+	}
+
+	/** @brief Schedules a new timer and returns its handle.*/
+	handle_t schedule(simtime_t_cref expiry, const T& data) {
+		int t;
+		if(freeTimers != NONE) {
+			t          = freeTimers;
+			freeTimers = timers[t].next;
+		}
+		else {
+			t = static_cast<int>(timers.size());
+			timers.push_back(Timer());
+		}
+
+		timers[t].expiry = expiry;
+		timers[t].tick   = tickOf(expiry);
+		timers[t].seq    = nextSeq++;
+		timers[t].data   = data;
+		link(t);
+		++count;
+		return t;
+	}
+
+	/** @brief Moves a scheduled timer to a new expiry.*/
+	void reschedule(handle_t t, simtime_t_cref expiry) {
+		assert(timers[t].slot != NONE);
+		unlink(t);
+		timers[t].expiry = expiry;
+		timers[t].tick   = tickOf(expiry);
+		timers[t].seq    = nextSeq++;
+		link(t);
+	}
+
+	/** @brief Cancels a scheduled timer, its handle becomes invalid.*/
+	void cancel(handle_t t) {
+		assert(timers[t].slot != NONE);
+		release(t);
+	}
+
+	/** @brief Returns the expiry of a scheduled timer.*/
+	simtime_t_cref getExpiry(handle_t t) const { return timers[t].expiry; }
+
+	/** @brief Returns the data of a scheduled timer.*/
+	const T& getData(handle_t t) const { return timers[t].data; }
+
+	/** @brief Returns the earliest expiry of all timers, MAXTIME if there is none.*/
+	simtime_t nextExpiry() {
+		const int t = earliest();
+		return (t == NONE) ? MAXTIME : timers[t].expiry;
+	}
+
+	/**
+	 * @brief Removes the timer which expires next if it expires at or
+	 * before now.
+	 *
+	 * @param now  The current simulation time.
+	 * @param data Set to the data of the removed timer.
+	 * @return false if no timer has expired.
+	 */
+	bool popExpired(simtime_t_cref now, T& data) {
+		const int t = earliest();
+		if(t == NONE || now < timers[t].expiry)
+			return false;
+
+		data = timers[t].data;
+		release(t);
+		return true;
+	}
+};
+
+#endif /* TIMERWHEEL_H_ */
@@ -119,7 +119,7 @@ double BaseDecider::getFrameReceivingPower(airframe_ptr_t frame) const {
 	Signal&   signal         = frame->getSignal();
 	simtime_t receivingStart = MappingUtils::post(signal.getReceptionStart());
 
-	return signal.getReceivingPower()->getValue(Argument(receivingStart));
+	return signal.getReceivingPower(Argument(receivingStart));
 }
 
 simtime_t BaseDecider::processNewSignal(airframe_ptr_t frame) {
@@ -427,6 +427,49 @@ Mapping* BaseDecider::calculateSnrMapping(const airframe_ptr_t frame) const
 	return snrMap;
 }
 
+bool BaseDecider::calculateSnrStatistics( const airframe_ptr_t         frame
+                                        , const Argument&              min
+                                        , const Argument&              max
+                                        , MappingUtils::QuotientStats& stats) const
+{
+	const Signal& signal = frame->getSignal();
+
+	simtime_t     start = signal.getReceptionStart();
+	simtime_t     end   = signal.getReceptionEnd();
+
+	const ConstMapping *const recvPowerMap = signal.getReceivingPower();
+	assert(recvPowerMap);
+
+	AirFrameVector               airFrames;
+	MappingUtils::MappingSummands noise;
+
+	// collect all AirFrames that intersect with [start, end]
+	getChannelInfo(start, end, airFrames);
+
+	ConstMapping* thermalNoise = phy->getThermalNoise(start, end);
+	if(thermalNoise) {
+		noise.push_back(thermalNoise);
+	}
+	for (AirFrameVector::const_iterator it = airFrames.begin(); it != airFrames.end(); ++it) {
+		assert (*it != 0);
+
+		if ( *it == frame ) {
+			// calculateRSSIMapping adds the thermal noise a second time
+			// for the excluded AirFrame, keep the results identical
+			if (thermalNoise) {
+				noise.push_back(thermalNoise);
+			}
+			continue;
+		}
+		const ConstMapping *const noisePowerMap = (*it)->getSignal().getReceivingPower();
+		assert(noisePowerMap);
+
+		noise.push_back(noisePowerMap);
+	}
+
+	return MappingUtils::findQuotientStats(*recvPowerMap, noise, min, max, stats);
+}
+
 void BaseDecider::getChannelInfo( simtime_t_cref  start
                                 , simtime_t_cref  end
                                 , AirFrameVector& out) const
@@ -10,6 +10,7 @@
 
 #include "MiXiMDefs.h"
 #include "Decider.h"
+#include "MappingUtils.h"
 
 class Mapping;
 class DeciderResult;
@@ -463,6 +464,25 @@ protected:
 	 */
 	virtual Mapping* calculateSnrMapping(const airframe_ptr_t frame) const;
 
+	/**
+	 * @brief Calculates the minimum, maximum and mean SNR of a Signal in
+	 * the passed range without building the SNR-Mapping.
+	 *
+	 * Sums up the same noise as "calculateSnrMapping()" but evaluates
+	 * the quotient in one pass over the key entries of the receiving power
+	 * mappings (see MappingUtils::findQuotientStats()).
+	 *
+	 * @param[in]  frame The AirFrame to calculate the SNR statistics for.
+	 * @param[in]  min   The start of the range to evaluate.
+	 * @param[in]  max   The end of the range to evaluate.
+	 * @param[out] stats The statistics of the SNR in the range.
+	 * @return false if there was no position in range to evaluate.
+	 */
+	virtual bool calculateSnrStatistics( const airframe_ptr_t         frame
+	                                   , const Argument&              min
+	                                   , const Argument&              max
+	                                   , MappingUtils::QuotientStats& stats) const;
+
 	/** @brief Return type of BaseDecider::calculateRSSIMapping function.
 	 *
 	 *  The pair consists in first part the RSSI map pointer and in second part
@@ -1,11 +1,10 @@
 #include "ChannelInfo.h"
 
 #include <iostream>
+#include <algorithm>
 #include <assert.h>
 
-const_simtime_t                   ChannelInfo::invalidSimTime(-1);
-const ChannelInfo::const_iterator ChannelInfo::cConstItEnd(NULL, SIMTIME_ZERO, SIMTIME_ZERO);
-const ChannelInfo::iterator       ChannelInfo::cItEnd(NULL, SIMTIME_ZERO, SIMTIME_ZERO);
+const_simtime_t ChannelInfo::invalidSimTime(-1);
 
 void ChannelInfo::addAirFrame(airframe_ptr_t frame, simtime_t_cref startTime)
 {
@@ -14,12 +13,7 @@ void ChannelInfo::addAirFrame(airframe_ptr_t frame, simtime_t_cref startTime)
 	//calculate endTime of AirFrame
 	simtime_t endTime = startTime + frame->getDuration();
 
-	AirFrameMatrix::iterator pos = activeAirFrames.lower_bound(endTime);
-	if(pos == activeAirFrames.end() || (activeAirFrames.key_comp()(endTime, pos->first))) {
-	    // key does not exists
-		pos = activeAirFrames.insert(pos, std::make_pair(endTime, AirFrameMatrix::mapped_type()));
-	}
-	pos->second.insert(std::make_pair(startTime, frame));
+	insertInterval(frame, startTime, endTime);
 
 	//add to start time map
 	airFrameStarts[frame->getTreeId()] = startTime;
@@ -27,7 +21,7 @@ void ChannelInfo::addAirFrame(airframe_ptr_t frame, simtime_t_cref startTime)
 	assert(!isChannelEmpty());
 }
 
-void ChannelInfo::addToInactives(airframe_ptr_t frame,
+void ChannelInfo::addToInactives(size_t         slot,
                                  simtime_t_cref startTime,
                                  simtime_t_cref endTime)
 {
@@ -36,33 +30,23 @@ void ChannelInfo::addToInactives(airframe_ptr_t frame,
 	checkAndCleanInterval(startTime, endTime);
 
 	if(!canDiscardInterval(startTime, endTime)) {
-		AirFrameMatrix::iterator pos = inactiveAirFrames.lower_bound(endTime);
-		if(pos == inactiveAirFrames.end() || (inactiveAirFrames.key_comp()(endTime, pos->first))) {
-		    // key does not exists
-			pos = inactiveAirFrames.insert(pos, std::make_pair(endTime, AirFrameMatrix::mapped_type()));
-		}
-		pos->second.insert(std::make_pair(startTime, frame));
+		IntervalEntry& entry = entries[slot];
+
+		entry.state = INACTIVE;
+		entry.order = ++orderCounter;
+		updateIndex(slot);
 	}
 	else {
-		airFrameStarts.erase(frame->getTreeId());
-		delete frame;
+		releaseInterval(slot);
 	}
 }
 
 simtime_t ChannelInfo::findEarliestInfoPoint(simtime_t_cref returnTimeIfEmpty /*= invalidSimTime*/) const
 {
-	c_min_start_time_fctr fctrMin;
-
-	AirFrameMatrix::const_iterator itActivesMin   = std::min_element(activeAirFrames.begin()  , activeAirFrames.end()  , fctrMin);
-	AirFrameMatrix::const_iterator itInactivesMin = std::min_element(inactiveAirFrames.begin(), inactiveAirFrames.end(), fctrMin);
-
-	if (itActivesMin != activeAirFrames.end() && itInactivesMin != inactiveAirFrames.end()) {
-		return std::min(itActivesMin->second.begin()->first, itInactivesMin->second.begin()->first);
-	}
-	if (itActivesMin != activeAirFrames.end())
-		return itActivesMin->second.begin()->first;
-	if (itInactivesMin != inactiveAirFrames.end())
-		return itInactivesMin->second.begin()->first;
+	// the entries are sorted by start time and head points to the first
+	// one which is still stored
+	if(head < entries.size())
+		return entries[head].start;
 
 	return returnTimeIfEmpty;
 }
@@ -78,10 +62,12 @@ simtime_t ChannelInfo::removeAirFrame(airframe_ptr_t frame, simtime_t_cref retur
 	simtime_t      endTime   = startTime + frame->getDuration();
 
 	//remove this AirFrame from active AirFrames
-	deleteAirFrame(activeAirFrames, frame, startTime, endTime);
+	const size_t slot = findInterval(frame, startTime);
+	entries[slot].state = NONE;
+	updateIndex(slot);
 
 	//add to inactive AirFrames
-	addToInactives(frame, startTime, endTime);
+	addToInactives(slot, startTime, endTime);
 
 
 	// Now check, whether the earliest time-point we need to store information
@@ -92,57 +78,228 @@ simtime_t ChannelInfo::removeAirFrame(airframe_ptr_t frame, simtime_t_cref retur
 	return findEarliestInfoPoint(returnTimeIfEmpty);
 }
 
+void ChannelInfo::getAirFrames( simtime_t_cref            from
+                              , simtime_t_cref            to
+                              , AirFrameVector&           out
+                              , airframe_filter_fctr *const fctrFilter /*= NULL*/) const
+{
+	queryBuffer.clear();
+	findIntersections(from, to, ACTIVE | INACTIVE, queryBuffer);
+
+	// return inactive AirFrames before the active ones, each sorted by
+	// end and start time
+	std::sort(queryBuffer.begin(), queryBuffer.end(), c_interval_order_fctr(entries));
+
+	const IntervalSlots::const_iterator itEnd = queryBuffer.end();
+	for(IntervalSlots::const_iterator it = queryBuffer.begin(); it != itEnd; ++it) {
+		const airframe_ptr_t frame = entries[*it].frame;
+
+		if (fctrFilter != NULL) {
+			if (!fctrFilter->pass(frame))
+				continue;
+		}
+		out.push_back(frame);
+	}
+}
+
 void ChannelInfo::assertNoIntersections() const {
 	const bool bIsValidStartTime = recordStartTime >= SIMTIME_ZERO;
 
-	for(AirFrameMatrix::const_iterator it1 = inactiveAirFrames.begin(); it1 != inactiveAirFrames.end(); ++it1)
+	for(IntervalVector::const_iterator it1 = entries.begin(); it1 != entries.end(); ++it1)
 	{
-		simtime_t_cref e0 = it1->first;
-		for(AirFrameMatrix::mapped_type::const_iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2)
+		if(it1->state != INACTIVE)
+			continue;
+
+		simtime_t_cref e0 = it1->end;
+		simtime_t_cref s0 = it1->start;
+
+		bool bIntersects = (bIsValidStartTime && recordStartTime <= e0);
+
+		for(IntervalVector::const_iterator it2 = entries.begin();
+			it2 != entries.end() && !bIntersects; ++it2)
 		{
-			simtime_t_cref s0 = it2->first;
-
-			bool bIntersects = (bIsValidStartTime && recordStartTime <= e0);
-
-			for(AirFrameMatrix::const_iterator it3 = activeAirFrames.begin();
-				it3 != activeAirFrames.end() && !bIntersects; ++it3)
-			{
-				simtime_t_cref e1 = it3->first;
-				for(AirFrameMatrix::mapped_type::const_iterator it4 = it3->second.begin();
-					it4 != it3->second.end() && !bIntersects; ++it4)
-				{
-					simtime_t_cref s1 = it4->first;
-
-					if(e0 >= s1 && s0 <= e1)
-						bIntersects = true;
-				}
-			}
-			assert(bIntersects);
+			if(it2->state != ACTIVE)
+				continue;
+
+			simtime_t_cref e1 = it2->end;
+			simtime_t_cref s1 = it2->start;
+
+			if(e0 >= s1 && s0 <= e1)
+				bIntersects = true;
 		}
+		assert(bIntersects);
+	}
+}
+
+void ChannelInfo::updateIndex(size_t slot)
+{
+	const IntervalEntry& entry = entries[slot];
+	size_t               node  = leafCount + slot;
+
+	activeMaxEnd[node]   = (entry.state == ACTIVE)   ? entry.end : invalidSimTime;
+	inactiveMaxEnd[node] = (entry.state == INACTIVE) ? entry.end : invalidSimTime;
+
+	for(node >>= 1; node > 0; node >>= 1) {
+		activeMaxEnd[node]   = std::max(activeMaxEnd[2*node],   activeMaxEnd[2*node + 1]);
+		inactiveMaxEnd[node] = std::max(inactiveMaxEnd[2*node], inactiveMaxEnd[2*node + 1]);
+	}
+}
+
+void ChannelInfo::rebuildIndex()
+{
+	// drop the released entries
+	IntervalVector::iterator itLast = entries.begin();
+	for(IntervalVector::iterator it = entries.begin(); it != entries.end(); ++it) {
+		if(it->frame != NULL) {
+			*itLast = *it;
+			++itLast;
+		}
+	}
+	entries.erase(itLast, entries.end());
+	head          = 0;
+	releasedCount = 0;
+
+	// leave room for as many AirFrames as currently stored
+	leafCount = 1;
+	while(leafCount < 2 * entries.size())
+		leafCount <<= 1;
+
+	activeMaxEnd.assign(2 * leafCount, invalidSimTime);
+	inactiveMaxEnd.assign(2 * leafCount, invalidSimTime);
+
+	for(size_t slot = 0; slot < entries.size(); ++slot) {
+		const IntervalEntry& entry = entries[slot];
+
+		if(entry.state == ACTIVE)
+			activeMaxEnd[leafCount + slot] = entry.end;
+		else if(entry.state == INACTIVE)
+			inactiveMaxEnd[leafCount + slot] = entry.end;
+	}
+	for(size_t node = leafCount - 1; node > 0; --node) {
+		activeMaxEnd[node]   = std::max(activeMaxEnd[2*node],   activeMaxEnd[2*node + 1]);
+		inactiveMaxEnd[node] = std::max(inactiveMaxEnd[2*node], inactiveMaxEnd[2*node + 1]);
+	}
+}
+
+size_t ChannelInfo::insertInterval(airframe_ptr_t frame, simtime_t_cref startTime, simtime_t_cref endTime)
+{
+	const IntervalEntry entry(startTime, endTime, frame, ++orderCounter);
+
+	if(!entries.empty() && startTime < entries.back().start) {
+		// AirFrames should be added chronologically, but keep the entries
+		// sorted anyway
+		IntervalVector::iterator pos = entries.begin() + head;
+		while(pos != entries.end() && !(startTime < pos->start))
+			++pos;
+
+		entries.insert(pos, entry);
+		rebuildIndex();
+		return findInterval(frame, startTime);
+	}
+
+	// compact the released entries if they make up the most part of the
+	// index, or make room for the new AirFrame
+	if(entries.size() == leafCount || (releasedCount > 32 && 2 * releasedCount > entries.size())) {
+		rebuildIndex();
 	}
+
+	entries.push_back(entry);
+	updateIndex(entries.size() - 1);
+
+	return entries.size() - 1;
 }
 
-void ChannelInfo::deleteAirFrame(AirFrameMatrix& airFrames,
-                                 airframe_ptr_t frame,
-                                 simtime_t_cref startTime, simtime_t_cref endTime)
+size_t ChannelInfo::findInterval(airframe_ptr_t frame, simtime_t_cref startTime) const
 {
-	AirFrameMatrix::iterator listIt = airFrames.find(endTime);
-
-	if (listIt != airFrames.end()) {
-		AirFrameMatrix::mapped_type&          startTimeList = listIt->second;
-		AirFrameMatrix::mapped_type::iterator itEnd         = startTimeList.upper_bound(startTime);
-
-		for(AirFrameMatrix::mapped_type::iterator it = startTimeList.lower_bound(startTime); it != itEnd; ++it) {
-			if(it->second == frame || it->second->getTreeId() == frame->getTreeId()) {
-				startTimeList.erase(it);
-				if(startTimeList.empty()) {
-					airFrames.erase(listIt);
-				}
-				return;
-			}
+	// first entry which does not start before the AirFrame
+	size_t first = head;
+	size_t count = entries.size() - head;
+	while(count > 0) {
+		const size_t step = count / 2;
+		if(entries[first + step].start < startTime) {
+			first += step + 1;
+			count -= step + 1;
+		}
+		else {
+			count = step;
+		}
+	}
+
+	for(size_t slot = first; slot < entries.size() && entries[slot].start == startTime; ++slot) {
+		const airframe_ptr_t other = entries[slot].frame;
+
+		if(other != NULL && (other == frame || other->getTreeId() == frame->getTreeId())) {
+			return slot;
 		}
 	}
 	assert(false);
+	return entries.size();
+}
+
+void ChannelInfo::releaseInterval(size_t slot)
+{
+	IntervalEntry& entry = entries[slot];
+
+	airFrameStarts.erase(entry.frame->getTreeId());
+	delete entry.frame;
+
+	entry.frame = NULL;
+	entry.state = NONE;
+	updateIndex(slot);
+	++releasedCount;
+
+	while(head < entries.size() && entries[head].frame == NULL)
+		++head;
+}
+
+bool ChannelInfo::findIntersections( simtime_t_cref from, simtime_t_cref to
+                                   , int states, IntervalSlots& out, bool firstOnly) const
+{
+	// only entries which start before or at the end of the interval can
+	// intersect, they form a prefix of the start time sorted entries
+	size_t limit = head;
+	size_t count = entries.size() - head;
+	while(count > 0) {
+		const size_t step = count / 2;
+		if(!(to < entries[limit + step].start)) {
+			limit += step + 1;
+			count -= step + 1;
+		}
+		else {
+			count = step;
+		}
+	}
+	if(limit == head)
+		return false;
+
+	return findIntersections(1, 0, leafCount, limit, from, states, out, firstOnly);
+}
+
+bool ChannelInfo::findIntersections( size_t node, size_t first, size_t last, size_t limit
+                                   , simtime_t_cref from, int states, IntervalSlots& out, bool firstOnly) const
+{
+	// nothing in this subtree starts before the end of the interval or
+	// ends after the start of the interval
+	if(first >= limit || last <= head)
+		return false;
+	if(    !((states & ACTIVE)   && !(activeMaxEnd[node]   < from))
+	    && !((states & INACTIVE) && !(inactiveMaxEnd[node] < from)))
+		return false;
+
+	if(last - first == 1) {
+		if(!(entries[first].state & states))
+			return false;
+		out.push_back(first);
+		return true;
+	}
+
+	const size_t middle = first + (last - first) / 2;
+	bool         bFound = findIntersections(2*node, first, middle, limit, from, states, out, firstOnly);
+
+	if(bFound && firstOnly)
+		return true;
+
+	return findIntersections(2*node + 1, middle, last, limit, from, states, out, firstOnly) || bFound;
 }
 
 bool ChannelInfo::canDiscardInterval(simtime_t_cref startTime,
@@ -154,36 +311,22 @@ bool ChannelInfo::canDiscardInterval(simtime_t_cref startTime,
 	// we aren't recording at all and it does not intersect with any active one
 	// anymore this AirFrame can be deleted
 	return (recordStartTime > endTime || recordStartTime == invalidSimTime)
-		   && !isIntersecting(activeAirFrames, startTime, endTime);
+		   && !isIntersecting(startTime, endTime, ACTIVE);
 }
 
 void ChannelInfo::checkAndCleanInterval(simtime_t_cref startTime,
                                         simtime_t_cref endTime)
 {
 	// get through inactive AirFrame which intersected with the passed interval
-	iterator itInactiveFrames(&inactiveAirFrames, startTime, endTime);
-	iterator itEnd = end();
-	for (; itInactiveFrames != itEnd;) {
-		airframe_ptr_t pInactiveFrame = itInactiveFrames->second;
-		simtime_t      currentEnd     = itInactiveFrames->first + pInactiveFrame->getDuration();
+	IntervalSlots inactives;
+	findIntersections(startTime, endTime, INACTIVE, inactives);
 
-		if(canDiscardInterval(itInactiveFrames->first, currentEnd)) {
-			erase(itInactiveFrames++);
+	const IntervalSlots::const_iterator itEnd = inactives.end();
+	for(IntervalSlots::const_iterator it = inactives.begin(); it != itEnd; ++it) {
+		const IntervalEntry& entry = entries[*it];
 
-			airFrameStarts.erase(pInactiveFrame->getTreeId());
-			delete pInactiveFrame;
-			continue;
+		if(canDiscardInterval(entry.start, entry.end)) {
+			releaseInterval(*it);
 		}
-		++itInactiveFrames;
 	}
 }
-
-bool ChannelInfo::isIntersecting( const AirFrameMatrix& airFrames
-                                , simtime_t_cref        from
-                                , simtime_t_cref        to)
-{
-	const_iterator it(&airFrames, from, to);
-	return (it != cConstItEnd);
-}
-
-
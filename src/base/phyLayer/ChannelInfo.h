@@ -3,6 +3,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 #include <omnetpp.h>
 
 #include "MiXiMDefs.h"
@@ -64,270 +65,107 @@ public:
 		}
     };
 protected:
-	/**
-	 * The AirFrames are stored in a Matrix with start- and end time as
-	 * dimensions.
-	 */
-	typedef std::map<simtime_t, std::multimap<simtime_t, airframe_ptr_t> > AirFrameMatrix;
-
-	struct c_min_start_time_fctr {
-		bool operator() (const AirFrameMatrix::value_type& a, const AirFrameMatrix::value_type& b) {
-			return a.second.key_comp()(a.second.begin()->first, b.second.begin()->first);
-		}
+	/** @brief State of an AirFrame stored in the interval index.*/
+	enum IntervalState {
+		/** @brief The AirFrame is not (or no longer) part of any query.*/
+		NONE     = 0,
+		/** @brief The AirFrame has been added but not yet removed.*/
+		ACTIVE   = 1,
+		/** @brief The AirFrame has been removed but is still needed.*/
+		INACTIVE = 2
 	};
 
-	/**
-	 * @brief Iterator for every intersection of a specific interval in a
-	 * AirFrameMatrix.
-	 *
-	 * A time interval A_start to A_end intersects with another interval B_start
-	 * to B_end iff the following two conditions are fulfilled:
-	 *
-	 * 		1. A_end >= B_start.
-	 * 		2. A_start <= B_end and
-	 *
-	 * Or the defined by the
-	 * opposite: The two intervals do not intersect iff A_end < B_start or
-	 * A_start > B_end.
-	 *
-	 * To iterate over a two dimensional (end-time x start-time) container
-	 * of AirFrames this class iterates over all AirFrame-lists whose end-time
-	 * is bigger or equal than the interval start (intersect condition 1) and in
-	 * each of these lists iterates over all entries but only stops at and
-	 * returns entries which start-time is smaller or equal than the interval
-	 * end (intersection condition 2).
-	 *
-	 * In template form to work as const- and non-const iterator.
-	 */
-	template<typename C, typename ItMatrix = typename C::const_iterator, typename ItSubMatrix = typename C::mapped_type::const_iterator>
-	class BaseIntersectionIterator
-	{
-	public:
-		typedef typename ItSubMatrix::value_type value_type;
-		typedef typename ItSubMatrix::reference  reference;
-		typedef typename ItSubMatrix::pointer    pointer;
-
-		typedef BaseIntersectionIterator<C, ItMatrix, ItSubMatrix> iterator;
-
-		typedef std::bidirectional_iterator_tag iterator_category;
-		typedef ptrdiff_t                       difference_type;
-
-	protected:
-		friend class ChannelInfo;
-		typedef BaseIntersectionIterator<C, ItMatrix, ItSubMatrix> _Self;
-		//typedef _Rb_tree_node_base::_Const_Base_ptr _Base_ptr;
-		//typedef const _Rb_tree_node<_Tp>*           _Link_type;
-
-		/** @brief Pointer to the matrix holding the intervals.*/
-		C* intervals;
-
-		/** @brief Point in time to start iterating over intersections.*/
-		simtime_t_cref from;
-
-		/** @brief Point in time to end iterating over intersections.*/
-		simtime_t_cref to;
-
-		/** @brief Iterator over AirFrame end times.*/
-		ItMatrix endIt;
-
-		/** @brief Iterator over AirFrame start times.*/
-		ItSubMatrix startIt;
-		ItSubMatrix startItEnd;
-
-		/** Jumps top next valid entry.
-		 *
-		 * ATTENTION: startIt and startItEnd must be set!
-		 */
-	    _Self& jumpToNextValid(ItMatrix endItEnd)
-	    {
-			for (; endIt != endItEnd; startIt = endIt->second.begin()) {
-				// while there are entries left at the current end-time
-				if (startIt != startItEnd) {
-					// check if this entry fulfills the intersection condition
-					// 2 (condition 1 is already fulfilled in the constructor by
-					// the start-value of the end-time-iterator)
-					return *this;
-				}
-				if (++endIt != endItEnd) {
-					startItEnd = endIt->second.upper_bound(to);
-				}
-			}
-
-			intervals = NULL;
-			return *this;
-	    }
-	public:
-		/**
-		 * @brief Creates an iterator for the specified interval at the
-		 * specified AirFrameMatrix.
-		 */
-		BaseIntersectionIterator(C* airFrames, simtime_t_cref from, simtime_t_cref to) :
-			intervals(airFrames), from(from), to(to), endIt(), startIt(), startItEnd()
-		{
-			// begin at the smallest end-time-entry fulfilling the intersection
-			// condition 1
-			if (intervals) {
-				endIt = intervals->lower_bound(from);
-				if(endIt != intervals->end()) {
-					startIt    = endIt->second.begin();
-					startItEnd = endIt->second.upper_bound(to);
-					jumpToNextValid(intervals->end());
-				}
-				else {
-					intervals = NULL;
-					startIt   = startItEnd;
-				}
-			}
-			else {
-				startIt = startItEnd;
-			}
-			//we are already pointing at the first unchecked interval
-		}
-		BaseIntersectionIterator(const iterator& __it) :
-			intervals(__it.intervals), from(__it.from), to(__it.to), endIt(__it.endIt), startIt(__it.startIt),  startItEnd(__it.startItEnd)
-		{ }
-
-		reference
-	    operator*() const
-		{
-			if(intervals == NULL || endIt == intervals->end() || startIt == startItEnd)
-				return NULL;
-			return startIt.operator*();
-		}
-
-		pointer
-	    operator->() const
-		{
-			if(intervals == NULL || endIt == intervals->end() || startIt == startItEnd)
-				return NULL;
-			return startIt.operator->();
-		}
+	/** @brief An AirFrame together with its interval on the channel.*/
+	struct IntervalEntry {
+		/** @brief The start of the AirFrame.*/
+		simtime_t      start;
+		/** @brief The end of the AirFrame.*/
+		simtime_t      end;
+		/** @brief The AirFrame, NULL if the entry has been released.*/
+		airframe_ptr_t frame;
+		/** @brief One of the IntervalState values.*/
+		int            state;
+		/** @brief Sequence number of the last state change, used to keep the
+		 * order of returned AirFrames stable.*/
+		unsigned long  order;
+
+		IntervalEntry(simtime_t_cref start, simtime_t_cref end, airframe_ptr_t frame, unsigned long order)
+			: start(start), end(end), frame(frame), state(ACTIVE), order(order)
+		{}
+	};
 
-		/**  @brief Increases the iterator to the next intersecting AirFrame.
-		 */
-		_Self&
-		operator++()
-		{
-			if (!intervals)
-				return *this;
+	/** @brief Type for the start time sorted list of AirFrame intervals.*/
+	typedef std::vector<IntervalEntry> IntervalVector;
 
-			const ItMatrix endItEnd = intervals->end();
-			if(endIt == endItEnd) {
-				intervals = NULL;
-				return *this;
-			}
+	/** @brief Type for the maximum end times of the nodes of the index.*/
+	typedef std::vector<simtime_t>     MaxEndVector;
 
-			if (startIt != startItEnd)
-				++startIt;
+	/** @brief Type for a list of positions in the IntervalVector.*/
+	typedef std::vector<size_t>        IntervalSlots;
 
-			return jumpToNextValid(endItEnd);
+	/**
+	 * @brief Orders interval slots the same way the AirFrames were returned
+	 * before: inactive AirFrames first, then by end and start time.
+	 */
+	struct c_interval_order_fctr {
+		const IntervalVector& entries;
+
+		c_interval_order_fctr(const IntervalVector& entries) : entries(entries) {}
+
+		bool operator() (size_t a, size_t b) const {
+			const IntervalEntry& ea = entries[a];
+			const IntervalEntry& eb = entries[b];
+
+			if(ea.state != eb.state)
+				return ea.state == INACTIVE;
+			if(ea.end != eb.end)
+				return ea.end < eb.end;
+			if(ea.start != eb.start)
+				return ea.start < eb.start;
+			return ea.order < eb.order;
 		}
-
-		/**  @brief Increases the iterator to the next intersecting AirFrame.
-		 */
-		_Self
-		operator++(int)
-	    {
-			_Self __tmp = *this;
-			++(*this);
-			return __tmp;
-	    }
-
-		/**  @brief Compares two iterators for equality.
-		 */
-	    bool
-	    operator==(const _Self& __x) const
-	    {
-	    	if (intervals == NULL) {
-	    		if (__x.intervals == NULL)
-	    			return true;
-	    		return (__x.endIt == __x.intervals->end() || __x.startIt == __x.startItEnd); // we have no next element
-	    	}
-	    	if (__x.intervals == NULL) {
-	    		return (endIt == intervals->end() || startIt == endIt->second.end()); // we have no next element
-	    	}
-	    	if( (endIt == intervals->end() && __x.endIt == __x.intervals->end()) || (startIt == startItEnd && __x.startIt == __x.startItEnd) )
-	    		return true;
-	    	return intervals == __x.intervals && from == __x.from && to == __x.to && endIt == __x.endIt && startIt == __x.startIt && startItEnd == __x.startItEnd;
-	    }
-
-		/**  @brief Compares two iterators for inequality.
-		 */
-	    bool
-	    operator!=(const _Self& __x) const
-	    { return !(*this == __x); }
 	};
 
-	/** @brief Type for a const-iterator over an AirFrame interval matrix.*/
-	typedef BaseIntersectionIterator<const AirFrameMatrix,
-									 AirFrameMatrix::const_iterator,
-									 AirFrameMatrix::mapped_type::const_iterator> const_iterator;
-
-	/** @brief The end iterator for the matrix.*/
-	const static const_iterator cConstItEnd;
-
-    /**
-     *  Returns a read-only (constant) iterator that points one past the last
-     *  pair in the AirFrameMatrix.  Iteration is done in ascending order according to
-     *  the end, and start time.
-     */
-	const_iterator end() const {
-		return cConstItEnd;
-	}
-
-	/** @brief Type for a iterator over an AirFrame interval matrix.*/
-	typedef BaseIntersectionIterator<AirFrameMatrix,
-									 AirFrameMatrix::iterator,
-									 AirFrameMatrix::mapped_type::iterator> iterator;
-
-	/** @brief The end iterator for the matrix.*/
-	const static iterator cItEnd;
-    /**
-     *  Returns a read/write iterator that points one past the last
-     *  pair in the AirFrameMatrix.  Iteration is done in ascending order according to
-     *  the end, and start time.
-     */
-	iterator end() {
-		return cItEnd;
-	}
-
-    /**
-     *  @brief Erases an element from a AirFrameMatrix.
-     *  @param  position  An iterator pointing to the element to be erased.
-     *
-     *  This function erases an element, pointed to by the given
-     *  iterator, from a AirFrameMatrix.  Note that this function only erases
-     *  the element, and that if the element is itself a pointer,
-     *  the pointed-to memory is not touched in any way.  Managing
-     *  the pointer is the user's responsibility.
-     */
-	void erase(const iterator& __position) {
-		assert(__position.endIt   != __position.intervals->end());
-		assert(__position.startIt != __position.startItEnd);
-
-		//erase AirFrame from list
-		__position.endIt->second.erase(__position.startIt);
-
-		//check if we deleted the only entry in the list
-		if(__position.endIt->second.empty()) {
-			__position.intervals->erase(__position.endIt); //delete list from map
-		}
-	}
-
 	/**
-	 * @brief Stores the currently active AirFrames.
+	 * @brief Stores every AirFrame on the channel sorted by its start time.
 	 *
-	 * This means every AirFrame which was added but not yet removed.
+	 * Together with activeMaxEnd and inactiveMaxEnd this forms an augmented
+	 * interval tree: the entries are the leafs of an implicit binary tree in
+	 * which every node stores the maximum end time of the AirFrames below it.
+	 * AirFrames are added in chronological order, so new AirFrames are
+	 * appended at the end. Released entries stay in place until the next
+	 * compaction.
 	 */
-	AirFrameMatrix activeAirFrames;
+	IntervalVector entries;
 
 	/**
-	 * @brief Stores inactive AirFrames.
+	 * @brief Maximum end time of the active AirFrames below each node of the
+	 * interval tree.
 	 *
-	 * This means every AirFrame which has been already removed but still is
-	 * needed because it intersect with one or more active AirFrames.
+	 * Node 1 is the root, the children of node i are 2i and 2i+1 and the leaf
+	 * for entry i is node leafCount + i. invalidSimTime marks nodes without
+	 * any active AirFrame.
 	 */
-	AirFrameMatrix inactiveAirFrames;
+	MaxEndVector activeMaxEnd;
+
+	/** @brief Maximum end time of the inactive AirFrames below each node of
+	 * the interval tree (see activeMaxEnd).*/
+	MaxEndVector inactiveMaxEnd;
+
+	/** @brief Number of leafs of the interval tree (a power of two).*/
+	size_t leafCount;
+
+	/** @brief Position of the first not released entry.*/
+	size_t head;
+
+	/** @brief Number of released entries which are not yet compacted.*/
+	size_t releasedCount;
+
+	/** @brief Counter for the order member of the entries.*/
+	unsigned long orderCounter;
+
+	/** @brief Buffer for the slots found by a query.*/
+	mutable IntervalSlots queryBuffer;
 
 	/** @brief Type for a map of AirFrame pointers to their start time.*/
 	typedef std::map<long, simtime_t> AirFrameStartMap;
@@ -354,36 +192,68 @@ protected:
 	 */
 	void assertNoIntersections() const;
 
+	/**
+	 * @brief Recalculates the leaf of the passed entry and all of its parent
+	 * nodes in the interval tree.
+	 */
+	void updateIndex(size_t slot);
+
+	/**
+	 * @brief Removes all released entries and rebuilds the interval tree
+	 * with enough leafs for further AirFrames.
+	 */
+	void rebuildIndex();
 
 	/**
-	 * @brief Returns every AirFrame of an AirFrameMatrix which intersect with a
-	 * given interval.
+	 * @brief Adds an active AirFrame to the interval index and returns its
+	 * position.
+	 */
+	size_t insertInterval(airframe_ptr_t a, simtime_t_cref startTime, simtime_t_cref endTime);
+
+	/**
+	 * @brief Returns the position of the passed AirFrame in the interval
+	 * index.
+	 */
+	size_t findInterval(airframe_ptr_t a, simtime_t_cref startTime) const;
+
+	/**
+	 * @brief Marks the entry at the passed position as released and deletes
+	 * its AirFrame.
+	 */
+	void releaseInterval(size_t slot);
+
+	/**
+	 * @brief Collects the positions of all AirFrames in one of the passed
+	 * states which intersect with the given interval.
+	 *
+	 * Walks down the interval tree and skips every subtree whose AirFrames
+	 * start after the interval or all end before it.
 	 *
-	 * The intersecting AirFrames are stored in the AirFrameVector reference
-	 * passed as parameter.
+	 * @param from      The start of the interval.
+	 * @param to        The end of the interval.
+	 * @param states    Bitwise or of the IntervalStates to look for.
+	 * @param out       The positions of the found AirFrames are appended here.
+	 * @param firstOnly Stop after the first intersecting AirFrame.
+	 * @return true if at least one AirFrame was found.
 	 */
-	static void getIntersections( const AirFrameMatrix&     airFrames
-                                , simtime_t_cref            from
-                                , simtime_t_cref            to
-                                , AirFrameVector&           outVector
-                                , airframe_filter_fctr *const fctrFilter = NULL)
-	{
-	    const_iterator itEnd = cConstItEnd;
-	    for (const_iterator it(&airFrames, from, to); it != itEnd; ++it) {
-	        if (fctrFilter != NULL) {
-	            if (!fctrFilter->pass(it->second))
-	                continue;
-	        }
-	        outVector.push_back(it->second);
-	    }
-	}
+	bool findIntersections( simtime_t_cref from, simtime_t_cref to
+	                      , int states, IntervalSlots& out, bool firstOnly = false) const;
+
+	/**
+	 * @brief Recursive part of findIntersections() for the subtree at the
+	 * passed node, which covers the entries from first to last (excluded).
+	 */
+	bool findIntersections( size_t node, size_t first, size_t last, size_t limit
+	                      , simtime_t_cref from, int states, IntervalSlots& out, bool firstOnly) const;
 
 	/**
 	 * @brief Returns true if there is at least one AirFrame in the passed
-	 * AirFrameMatrix which intersect with the given interval.
+	 * states which intersect with the given interval.
 	 */
-	static bool isIntersecting( const AirFrameMatrix& airFrames,
-	                            simtime_t_cref from, simtime_t_cref to );
+	bool isIntersecting(simtime_t_cref from, simtime_t_cref to, int states) const {
+		queryBuffer.clear();
+		return findIntersections(from, to, states, queryBuffer, true);
+	}
 
 	/**
 	 * @brief Moves a previously active AirFrame to the inactive AirFrames.
@@ -394,14 +264,7 @@ protected:
 	 * It also checks if the AirFrame to in-activate still intersect with at
 	 * least one active AirFrame before it is moved to inactive AirFrames.
 	 */
-	void addToInactives(airframe_ptr_t a, simtime_t_cref startTime, simtime_t_cref endTime);
-
-	/**
-	 * @brief Deletes an AirFrame from an AirFrameMatrix.
-	 */
-	static void deleteAirFrame(AirFrameMatrix& airFrames,
-	                           airframe_ptr_t  a,
-	                           simtime_t_cref  startTime, simtime_t_cref endTime);
+	void addToInactives(size_t slot, simtime_t_cref startTime, simtime_t_cref endTime);
 
 	/**
 	 * @brief Returns the start time of the odlest AirFrame on the channel.
@@ -442,17 +305,23 @@ protected:
 	 */
 	void checkAndCleanFrom(simtime_t_cref start) {
 		//nothing to do
-		if(inactiveAirFrames.empty())
+		if(inactiveMaxEnd[1] == invalidSimTime)
 			return;
 
 		//take last ended inactive airframe as end of interval
-		checkAndCleanInterval(start, inactiveAirFrames.rbegin()->first);
+		checkAndCleanInterval(start, inactiveMaxEnd[1]);
 	}
 
 public:
 	ChannelInfo()
-		: activeAirFrames()
-		, inactiveAirFrames()
+		: entries()
+		, activeMaxEnd(2, invalidSimTime)
+		, inactiveMaxEnd(2, invalidSimTime)
+		, leafCount(1)
+		, head(0)
+		, releasedCount(0)
+		, orderCounter(0)
+		, queryBuffer()
 		, airFrameStarts()
 		, recordStartTime(invalidSimTime)
 	{}
@@ -492,14 +361,7 @@ public:
 	void getAirFrames( simtime_t_cref            from
                      , simtime_t_cref            to
                      , AirFrameVector&           out
-                     , airframe_filter_fctr *const fctrFilter = NULL) const
-	{
-	    //check for intersecting inactive AirFrames
-	    getIntersections(inactiveAirFrames, from, to, out, fctrFilter);
-
-	    //check for intersecting active AirFrames
-	    getIntersections(activeAirFrames, from, to, out, fctrFilter);
-	}
+                     , airframe_filter_fctr *const fctrFilter = NULL) const;
 
 	/**
 	 * @brief Returns the current time-point from that information concerning
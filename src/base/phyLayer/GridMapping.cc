@@ -0,0 +1,635 @@
+/*
+ * GridMapping.cc
+ *
+ *  Dense two dimensional mapping, see class GridMapping.
+ */
+
+#include "GridMapping.h"
+
+#include "MappingUtils.h"
+
+namespace {
+
+/** @brief Gives access to the interpolation the rows of a MultiDimMapping use. */
+struct RowInterpolator : public Linear<TimeMappingMapStorage> {
+	using Linear<TimeMappingMapStorage>::linearInterpolation;
+};
+
+/** @brief Gives access to the interpolation factor a MultiDimMapping uses between its rows. */
+struct SubMappingInterpolator : public Linear< std::map<Argument::mapped_type, Mapping*> > {
+	using Linear< std::map<Argument::mapped_type, Mapping*> >::linearInterpolationFactor;
+};
+
+}
+
+//--GridMapping implementation------------------------
+
+const size_t GridMapping::npos = static_cast<size_t>(-1);
+
+GridMapping::GridMapping(const DimensionSet& dims):
+	Mapping(dims),
+	rowDimension(*dims.rbegin()),
+	times(), rows(), values(), defined(),
+	continueOutOfRange(true),
+	outOfRangeValue(Argument::MappedZero)
+{
+	assert(dims.size() == 2);
+}
+
+GridMapping::GridMapping(const DimensionSet& dims, argument_value_cref_t outOfRangeVal):
+	Mapping(dims),
+	rowDimension(*dims.rbegin()),
+	times(), rows(), values(), defined(),
+	continueOutOfRange(false),
+	outOfRangeValue(outOfRangeVal)
+{
+	assert(dims.size() == 2);
+}
+
+void GridMapping::insertRow(size_t row, argument_value_cref_t pos)
+{
+	const size_t nCols = columns();
+
+	rows.insert(rows.begin() + row, pos);
+	values.insert(values.begin() + row * nCols, nCols, Argument::MappedZero);
+	defined.insert(defined.begin() + row * nCols, nCols, 0);
+}
+
+void GridMapping::insertColumn(size_t col, simtime_t_cref t)
+{
+	const size_t nRows = rows.size();
+	const size_t nCols = columns();
+
+	times.insert(times.begin() + col, t);
+	if (nRows <= 1) {
+		values.insert(values.begin() + col, nRows, Argument::MappedZero);
+		defined.insert(defined.begin() + col, nRows, 0);
+		return;
+	}
+
+	std::vector<argument_value_t> newValues(nRows * (nCols + 1), Argument::MappedZero);
+	std::vector<char>             newDefined(nRows * (nCols + 1), 0);
+	for (size_t r = 0; r < nRows; ++r) {
+		const size_t src = r * nCols;
+		const size_t dst = r * (nCols + 1);
+
+		std::copy(values.begin() + src, values.begin() + src + col, newValues.begin() + dst);
+		std::copy(values.begin() + src + col, values.begin() + src + nCols, newValues.begin() + dst + col + 1);
+		std::copy(defined.begin() + src, defined.begin() + src + col, newDefined.begin() + dst);
+		std::copy(defined.begin() + src + col, defined.begin() + src + nCols, newDefined.begin() + dst + col + 1);
+	}
+	values.swap(newValues);
+	defined.swap(newDefined);
+}
+
+size_t GridMapping::setRowValue(size_t row, simtime_t_cref t, size_t right, argument_value_cref_t value)
+{
+	const size_t left = prevSet(row, right);
+	if (left != npos && times[left] == t) {
+		values[index(row, left)] = value;
+		return left;
+	}
+
+	// the column may already exist for other rows
+	size_t col = upperColumn(t);
+	if (col > 0 && times[col - 1] == t)
+		--col;
+	else
+		insertColumn(col, t);
+
+	values[index(row, col)]  = value;
+	defined[index(row, col)] = 1;
+	return col;
+}
+
+GridMapping::argument_value_t GridMapping::getRowValue(size_t row, simtime_t_cref t, size_t right) const
+{
+	const size_t left = prevSet(row, right);
+
+	if (left == npos) {
+		if (right == columns())
+			return continueOutOfRange ? Argument::MappedZero : outOfRangeValue;
+		return outOfRange(row, right);
+	}
+	if (times[left] == t)
+		return values[index(row, left)];
+	if (right == columns())
+		return outOfRange(row, left);
+
+	return RowInterpolator::linearInterpolation(t, times[left], times[right],
+	                                            values[index(row, left)], values[index(row, right)]);
+}
+
+GridMapping::argument_value_t GridMapping::getValue(const Argument& pos) const
+{
+	assert(pos.hasArgVal(rowDimension));
+
+	if (rows.empty())
+		return continueOutOfRange ? Argument::MappedZero : outOfRangeValue;
+
+	argument_value_cref_t rowPos = pos.getArgValue(rowDimension);
+	simtime_t_cref        t      = pos.getTime();
+	const size_t          up     = upperRow(rowPos);
+	const size_t          col    = upperColumn(t);
+
+	if (up == 0) {
+		if (!continueOutOfRange)
+			return outOfRangeValue;
+		return getRowValue(0, t, nextSet(0, col));
+	}
+
+	const size_t lo = up - 1;
+	if (rows[lo] == rowPos)
+		return getRowValue(lo, t, nextSet(lo, col));
+
+	if (up == rows.size()) {
+		if (!continueOutOfRange)
+			return outOfRangeValue;
+		return getRowValue(lo, t, nextSet(lo, col));
+	}
+
+	// bilinear interpolation between the two neighbor rows
+	argument_value_cref_t factor = SubMappingInterpolator::linearInterpolationFactor(rowPos, rows[lo], rows[up]);
+	argument_value_cref_t v0     = getRowValue(lo, t, nextSet(lo, col));
+	argument_value_cref_t v1     = getRowValue(up, t, nextSet(up, col));
+
+	return v0 * (Argument::MappedOne - factor) + v1 * factor;
+}
+
+void GridMapping::setValue(const Argument& pos, argument_value_cref_t value)
+{
+	argument_value_cref_t rowPos = pos.getArgValue(rowDimension);
+	const size_t          up     = upperRow(rowPos);
+	size_t                row    = up;
+
+	if (up > 0 && rows[up - 1] == rowPos)
+		row = up - 1;
+	else
+		insertRow(row, rowPos);
+
+	setRowValue(row, pos.getTime(), nextSet(row, upperColumn(pos.getTime())), value);
+}
+
+bool GridMapping::hasSameFullGrid(const GridMapping& o) const
+{
+	if (rows.empty() || times.empty())
+		return false;
+	if (!(rowDimension == o.rowDimension) || rows != o.rows || times != o.times)
+		return false;
+
+	return std::find(defined.begin(), defined.end(), 0) == defined.end()
+	       && std::find(o.defined.begin(), o.defined.end(), 0) == o.defined.end();
+}
+
+//--GridMappingIterator implementation----------------
+
+GridMappingIterator::GridMappingIterator(GridMapping& pMapping):
+	MappingIterator(), mapping(pMapping),
+	rowPos(), rightRow(0),
+	subMapping(), hasSub(false), sub(), upperSub(), constPos(),
+	position(), nextPosition()
+{
+	rowsJumpToBegin();
+	subMapping = rowsValue();
+	if (!subMapping.isInterpolated && subMapping.kind != SUB_NONE) {
+		subCreate(NULL);
+		position = Argument();
+		applySubPosition(position);
+		position.setArgValue(mapping.rowDimension, rowPos);
+	} else {
+		position = Argument(mapping.dimensions);
+	}
+	nextPosition = position;
+
+	updateNextPosition();
+}
+
+GridMappingIterator::GridMappingIterator(GridMapping& pMapping, const Argument& pos):
+	MappingIterator(), mapping(pMapping),
+	rowPos(), rightRow(0),
+	subMapping(), hasSub(false), sub(), upperSub(), constPos(),
+	position(pos), nextPosition()
+{
+	rowsJumpToBegin();
+	rowsJumpTo(position.getArgValue(mapping.rowDimension));
+	subMapping = rowsValue();
+	if (subMapping.kind != SUB_NONE)
+		subCreate(&position);
+	nextPosition = position;
+
+	updateNextPosition();
+}
+
+void GridMappingIterator::rowsJumpTo(argument_value_cref_t pos)
+{
+	if (pos == rowPos)
+		return;
+
+	if (!mapping.rows.empty())
+		rightRow = mapping.upperRow(pos);
+	rowPos = pos;
+}
+
+void GridMappingIterator::rowsIterateTo(argument_value_cref_t pos)
+{
+	if (pos == rowPos)
+		return;
+
+	const size_t nRows = mapping.rows.size();
+	while (rightRow < nRows && !(pos < mapping.rows[rightRow]))
+		++rightRow;
+	rowPos = pos;
+}
+
+void GridMappingIterator::rowsJumpToBegin()
+{
+	rightRow = 0;
+	if (!mapping.rows.empty()) {
+		rowPos = mapping.rows[0];
+		++rightRow;
+	} else {
+		rowPos = argument_value_t();
+	}
+}
+
+bool GridMappingIterator::rowsInRange() const
+{
+	if (mapping.rows.empty())
+		return false;
+
+	return !(rowPos < mapping.rows.front()) && !(mapping.rows.back() < rowPos);
+}
+
+bool GridMappingIterator::rowsHaveNext() const
+{
+	return rightRow < mapping.rows.size();
+}
+
+GridMappingIterator::argument_value_t GridMappingIterator::rowsNextPosition() const
+{
+	if (rowsHaveNext())
+		return mapping.rows[rightRow];
+	return rowPos + 1;
+}
+
+GridMappingIterator::SubMapping GridMappingIterator::rowsValue() const
+{
+	SubMapping   res;
+	const size_t nRows = mapping.rows.size();
+
+	if (nRows == 0) {
+		res.kind = mapping.continueOutOfRange ? SUB_NONE : SUB_CONST;
+		return res;
+	}
+
+	// outside of the rows either the border row or the out of range value
+	if (rightRow == 0 || (rightRow == nRows && !(mapping.rows[rightRow - 1] == rowPos))) {
+		res.kind = mapping.continueOutOfRange ? SUB_ROW : SUB_CONST;
+		res.row  = (rightRow == 0) ? 0 : rightRow - 1;
+		return res;
+	}
+
+	const size_t lo = rightRow - 1;
+	if (mapping.rows[lo] == rowPos) {
+		res.kind           = SUB_ROW;
+		res.row            = lo;
+		res.isInterpolated = false;
+		return res;
+	}
+
+	res.kind     = SUB_INTPL;
+	res.row      = lo;
+	res.upperRow = rightRow;
+	res.factor   = SubMappingInterpolator::linearInterpolationFactor(rowPos, mapping.rows[lo], mapping.rows[rightRow]);
+	return res;
+}
+
+void GridMappingIterator::rowBegin(RowPosition& p, size_t row) const
+{
+	const size_t nCols = mapping.columns();
+	const size_t first = mapping.nextSet(row, 0);
+
+	p.row = row;
+	if (first < nCols) {
+		p.time  = mapping.times[first];
+		p.right = mapping.nextSet(row, first + 1);
+	} else {
+		p.time  = simtime_t();
+		p.right = nCols;
+	}
+	updateRowNextTime(p);
+}
+
+void GridMappingIterator::rowJumpTo(RowPosition& p, size_t row, simtime_t_cref t) const
+{
+	p.row   = row;
+	p.time  = t;
+	p.right = mapping.nextSet(row, mapping.upperColumn(t));
+	updateRowNextTime(p);
+}
+
+void GridMappingIterator::rowIterateTo(RowPosition& p, simtime_t_cref t) const
+{
+	const size_t nCols = mapping.columns();
+
+	while (p.right < nCols && !(t < mapping.times[p.right]))
+		p.right = mapping.nextSet(p.row, p.right + 1);
+	p.time = t;
+	updateRowNextTime(p);
+}
+
+void GridMappingIterator::rowNext(RowPosition& p) const
+{
+	if (p.right < mapping.columns()) {
+		p.time  = mapping.times[p.right];
+		p.right = mapping.nextSet(p.row, p.right + 1);
+	} else {
+		p.time += 1;
+	}
+	updateRowNextTime(p);
+}
+
+void GridMappingIterator::updateRowNextTime(RowPosition& p) const
+{
+	if (p.right < mapping.columns())
+		p.nextTime = mapping.times[p.right];
+	else
+		p.nextTime = p.time + 1;
+}
+
+bool GridMappingIterator::rowInRange(const RowPosition& p) const
+{
+	const size_t nCols = mapping.columns();
+	const size_t first = mapping.nextSet(p.row, 0);
+
+	if (first == nCols)
+		return false;
+
+	const size_t last = mapping.prevSet(p.row, nCols);
+	return !(p.time < mapping.times[first]) && !(mapping.times[last] < p.time);
+}
+
+GridMappingIterator::argument_value_t GridMappingIterator::rowValue(const RowPosition& p) const
+{
+	return mapping.getRowValue(p.row, p.time, p.right);
+}
+
+void GridMappingIterator::subCreate(const Argument* pos)
+{
+	hasSub = true;
+	switch (subMapping.kind) {
+	case SUB_ROW:
+		if (pos)
+			rowJumpTo(sub, subMapping.row, pos->getTime());
+		else
+			rowBegin(sub, subMapping.row);
+		break;
+	case SUB_INTPL:
+		// interpolations between rows can only be accessed at a position
+		assert(pos);
+		rowJumpTo(sub, subMapping.row, pos->getTime());
+		rowJumpTo(upperSub, subMapping.upperRow, pos->getTime());
+		break;
+	case SUB_CONST:
+		if (pos) {
+			constPos = Argument(mapping.dimensions, pos->getTime());
+			constPos.setArgValues(*pos, true);
+		} else {
+			constPos = Argument(mapping.dimensions);
+		}
+		break;
+	case SUB_NONE:
+		hasSub = false;
+		break;
+	}
+}
+
+void GridMappingIterator::subJumpTo(const Argument& pos)
+{
+	switch (subMapping.kind) {
+	case SUB_ROW:
+		rowJumpTo(sub, sub.row, pos.getTime());
+		break;
+	case SUB_INTPL:
+		rowJumpTo(sub, sub.row, pos.getTime());
+		rowJumpTo(upperSub, upperSub.row, pos.getTime());
+		break;
+	case SUB_CONST:
+		constPos.setArgValues(pos, true);
+		break;
+	case SUB_NONE:
+		break;
+	}
+}
+
+void GridMappingIterator::subIterateTo(const Argument& pos)
+{
+	switch (subMapping.kind) {
+	case SUB_ROW:
+		rowIterateTo(sub, pos.getTime());
+		break;
+	case SUB_INTPL:
+		rowIterateTo(sub, pos.getTime());
+		rowIterateTo(upperSub, pos.getTime());
+		break;
+	case SUB_CONST:
+		constPos.setArgValues(pos, true);
+		break;
+	case SUB_NONE:
+		break;
+	}
+}
+
+void GridMappingIterator::subJumpToBegin()
+{
+	switch (subMapping.kind) {
+	case SUB_ROW: {
+		// like TimeMappingIterator::jumpToBegin() this does not update the next position
+		const simtime_t nextTime = sub.nextTime;
+		rowBegin(sub, sub.row);
+		sub.nextTime = nextTime;
+		break;
+	}
+	case SUB_INTPL:
+		assert(false);
+		break;
+	case SUB_CONST:
+		constPos = Argument(mapping.dimensions);
+		break;
+	case SUB_NONE:
+		break;
+	}
+}
+
+bool GridMappingIterator::subHasNext() const
+{
+	return subMapping.kind == SUB_ROW && sub.right < mapping.columns();
+}
+
+void GridMappingIterator::applySubPosition(Argument& pos) const
+{
+	if (subMapping.kind == SUB_CONST)
+		pos.setArgValues(constPos);
+	else
+		pos.setTime(sub.time);
+}
+
+GridMappingIterator::argument_value_t GridMappingIterator::subValue() const
+{
+	switch (subMapping.kind) {
+	case SUB_ROW:
+		return rowValue(sub);
+	case SUB_INTPL: {
+		argument_value_cref_t v0 = rowValue(sub);
+		argument_value_cref_t v1 = rowValue(upperSub);
+		return v0 + (v1 - v0) * subMapping.factor;
+	}
+	case SUB_CONST:
+		return mapping.outOfRangeValue;
+	case SUB_NONE:
+		break;
+	}
+	return Argument::MappedZero;
+}
+
+void GridMappingIterator::updateSubIterator(const Argument& pos)
+{
+	const SubMapping subM = rowsValue();
+
+	if (!(subM == subMapping)) {
+		subMapping = subM;
+		subCreate(&pos);
+	} else if (hasSub) {
+		subJumpTo(pos);
+	}
+}
+
+void GridMappingIterator::updateSubIterator()
+{
+	const SubMapping subM = rowsValue();
+
+	if (!(subM == subMapping)) {
+		subMapping = subM;
+		subCreate(subMapping.isInterpolated ? &position : NULL);
+	} else if (hasSub) {
+		subJumpToBegin();
+	}
+}
+
+void GridMappingIterator::updateNextPosition()
+{
+	const bool intp      = subMapping.isInterpolated;
+	const bool noSubIt   = !hasSub;
+	const bool hasNoNext = !intp && !noSubIt && !subHasNext();
+
+	if (intp || noSubIt || hasNoNext) {
+		if (rowsHaveNext()) {
+			// first entry of the next row
+			const size_t first = mapping.nextSet(rightRow, 0);
+			nextPosition.setTime(first < mapping.columns() ? mapping.times[first] : simtime_t());
+		} else {
+			nextPosition = position;
+		}
+		nextPosition.setArgValue(mapping.rowDimension, rowsNextPosition());
+	} else {
+		nextPosition.setTime(sub.nextTime);
+	}
+}
+
+void GridMappingIterator::jumpTo(const Argument& pos)
+{
+	argument_value_cref_t argVal = pos.getArgValue(mapping.rowDimension);
+
+	if (argVal != rowPos && pos.hasArgVal(mapping.rowDimension)) {
+		rowsJumpTo(argVal);
+		updateSubIterator(pos);
+	} else if (hasSub) {
+		subJumpTo(pos);
+	}
+
+	position.setArgValues(pos);
+	nextPosition.setArgValues(position);
+	updateNextPosition();
+}
+
+void GridMappingIterator::iterateTo(const Argument& pos)
+{
+	argument_value_cref_t argVal = pos.getArgValue(mapping.rowDimension);
+
+	if (argVal != rowPos && pos.hasArgVal(mapping.rowDimension)) {
+		rowsIterateTo(argVal);
+		updateSubIterator(pos);
+	} else if (hasSub) {
+		subIterateTo(pos);
+	}
+
+	position.setArgValues(pos);
+	updateNextPosition();
+}
+
+void GridMappingIterator::next()
+{
+	if (!subMapping.isInterpolated && hasSub && subHasNext()) {
+		rowNext(sub);
+	} else {
+		if (rowsHaveNext())
+			rowPos = mapping.rows[rightRow++];
+		else
+			rowPos += 1;
+		updateSubIterator();
+	}
+
+	if (hasSub)
+		applySubPosition(position);
+	position.setArgValue(mapping.rowDimension, rowPos);
+
+	updateNextPosition();
+}
+
+bool GridMappingIterator::inRange() const
+{
+	return rowsInRange() && (subMapping.isInterpolated || (hasSub && rowInRange(sub)));
+}
+
+bool GridMappingIterator::hasNext() const
+{
+	return rowsHaveNext() || (hasSub && subHasNext() && rowsInRange());
+}
+
+GridMappingIterator::argument_value_t GridMappingIterator::getValue() const
+{
+	if (hasSub)
+		return subValue();
+	return Argument::MappedZero;
+}
+
+void GridMappingIterator::jumpToBegin()
+{
+	rowsJumpToBegin();
+	updateSubIterator();
+	if (hasSub)
+		applySubPosition(position);
+	position.setArgValue(mapping.rowDimension, rowPos);
+
+	updateNextPosition();
+}
+
+void GridMappingIterator::setValue(argument_value_cref_t value)
+{
+	if (subMapping.isInterpolated) {
+		// add a new row at the current position
+		if (rightRow > 0 && mapping.rows[rightRow - 1] == rowPos) {
+			const size_t nCols = mapping.columns();
+			std::fill(mapping.defined.begin() + mapping.index(rightRow - 1, 0),
+			          mapping.defined.begin() + mapping.index(rightRow - 1, 0) + nCols, 0);
+		} else {
+			mapping.insertRow(rightRow, rowPos);
+			++rightRow;
+		}
+		updateSubIterator(position);
+	}
+	assert(hasSub && subMapping.kind == SUB_ROW);
+
+	const size_t col = mapping.setRowValue(sub.row, sub.time, sub.right, value);
+	sub.right = mapping.nextSet(sub.row, col + 1);
+}
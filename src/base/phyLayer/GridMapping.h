@@ -0,0 +1,366 @@
+/*
+ * GridMapping.h
+ *
+ *  Dense two dimensional mapping, see class GridMapping.
+ */
+
+#ifndef GRIDMAPPING_H_
+#define GRIDMAPPING_H_
+
+#include <vector>
+#include <algorithm>
+
+#include "MiXiMDefs.h"
+#include "MappingBase.h"
+
+class GridMapping;
+
+/**
+ * @brief Iterator for GridMappings.
+ *
+ * Iterates over the set grid points row by row (first by the position in
+ * the second dimension, then by time), which is the same order and the same
+ * behavior as the MultiDimMappingIterator of a MultiDimMapping<Linear> with
+ * the same key entries.
+ *
+ * Every step of the iterator has constant complexity for densely filled
+ * grids, no sub iterators are allocated.
+ *
+ * @ingroup mapping
+ */
+class MIXIM_API GridMappingIterator : public MappingIterator {
+protected:
+	/** @brief Kind of the mapping a row position of the iterator refers to. */
+	enum SubKind {
+		/** @brief No mapping (empty grid without out of range value). */
+		SUB_NONE,
+		/** @brief A row of the grid. */
+		SUB_ROW,
+		/** @brief Interpolation between two rows of the grid. */
+		SUB_INTPL,
+		/** @brief The constant out of range value. */
+		SUB_CONST
+	};
+
+	/** @brief Identifies the mapping at the current row position. */
+	struct SubMapping {
+		SubKind          kind;
+		bool             isInterpolated;
+		/** @brief The row (SUB_ROW) or the lower row (SUB_INTPL). */
+		size_t           row;
+		/** @brief The upper row (SUB_INTPL). */
+		size_t           upperRow;
+		argument_value_t factor;
+
+		SubMapping(): kind(SUB_NONE), isInterpolated(true), row(0), upperRow(0), factor(0) {}
+
+		bool operator==(const SubMapping& o) const {
+			// interpolations are temporary objects and never compare equal
+			return kind == o.kind && isInterpolated == o.isInterpolated
+			       && (kind == SUB_NONE || kind == SUB_CONST || (kind == SUB_ROW && row == o.row));
+		}
+	};
+
+	/** @brief Position of the iterator inside one row. */
+	struct RowPosition {
+		size_t    row;
+		simtime_t time;
+		/** @brief First set column of the row after "time", or the number of columns. */
+		size_t    right;
+		/** @brief Time a call to "next()" would jump to. */
+		simtime_t nextTime;
+
+		RowPosition(): row(0), time(), right(0), nextTime() {}
+	};
+
+	/** @brief The mapping to iterate over. */
+	GridMapping& mapping;
+
+	/** @brief The current position in the second dimension. */
+	argument_value_t rowPos;
+	/** @brief Index of the first row after rowPos. */
+	size_t           rightRow;
+
+	/** @brief The mapping at the current row position. */
+	SubMapping       subMapping;
+	/** @brief True if the position inside subMapping is valid. */
+	bool             hasSub;
+	/** @brief Position inside the row (SUB_ROW) or the lower row (SUB_INTPL). */
+	RowPosition      sub;
+	/** @brief Position inside the upper row (SUB_INTPL). */
+	RowPosition      upperSub;
+	/** @brief Position inside the constant out of range mapping (SUB_CONST). */
+	Argument         constPos;
+
+	/** @brief The current position of the iterator. */
+	Argument         position;
+	/** @brief The position a call to "next()" would jump to. */
+	Argument         nextPosition;
+
+private:
+	/** @brief Copy constructor is not allowed. */
+	GridMappingIterator(const GridMappingIterator&);
+	/** @brief Assignment operator is not allowed. */
+	GridMappingIterator& operator=(const GridMappingIterator&);
+
+protected:
+	/** @name Position in the second dimension.*/
+	/*@{*/
+	void rowsJumpTo(argument_value_cref_t pos);
+	void rowsIterateTo(argument_value_cref_t pos);
+	void rowsJumpToBegin();
+	bool rowsInRange() const;
+	bool rowsHaveNext() const;
+	argument_value_t rowsNextPosition() const;
+	/** @brief Returns the mapping at the current row position. */
+	SubMapping rowsValue() const;
+	/*@}*/
+
+	/** @name Position inside a single row.*/
+	/*@{*/
+	void rowBegin(RowPosition& p, size_t row) const;
+	void rowJumpTo(RowPosition& p, size_t row, simtime_t_cref t) const;
+	void rowIterateTo(RowPosition& p, simtime_t_cref t) const;
+	void rowNext(RowPosition& p) const;
+	void updateRowNextTime(RowPosition& p) const;
+	bool rowInRange(const RowPosition& p) const;
+	argument_value_t rowValue(const RowPosition& p) const;
+	/*@}*/
+
+	/** @name Position inside the mapping at the current row position.*/
+	/*@{*/
+	void subCreate(const Argument* pos);
+	void subJumpTo(const Argument& pos);
+	void subIterateTo(const Argument& pos);
+	void subJumpToBegin();
+	bool subHasNext() const;
+	/** @brief Sets the passed Argument to the position inside the sub mapping. */
+	void applySubPosition(Argument& pos) const;
+	argument_value_t subValue() const;
+	/*@}*/
+
+	/**
+	 * @brief Updates the sub mapping and sets the position inside it to
+	 * the passed position.
+	 */
+	void updateSubIterator(const Argument& pos);
+
+	/**
+	 * @brief Updates the sub mapping and sets the position inside it to
+	 * its beginning.
+	 */
+	void updateSubIterator();
+
+	/** @brief Updates the nextPosition member. */
+	void updateNextPosition();
+
+public:
+	/** @brief Initializes the iterator at the first entry of the mapping. */
+	GridMappingIterator(GridMapping& mapping);
+
+	/** @brief Initializes the iterator at the passed position. */
+	GridMappingIterator(GridMapping& mapping, const Argument& pos);
+
+	virtual ~GridMappingIterator() {}
+
+	virtual void jumpTo(const Argument& pos);
+
+	virtual void iterateTo(const Argument& pos);
+
+	virtual void next();
+
+	virtual bool inRange() const;
+
+	virtual const Argument& getPosition() const { return position; }
+
+	virtual const Argument& getNextPosition() const { return nextPosition; }
+
+	virtual argument_value_t getValue() const;
+
+	virtual void jumpToBegin();
+
+	virtual bool hasNext() const;
+
+	virtual void setValue(argument_value_cref_t value);
+};
+
+/**
+ * @brief Linear interpolated Mapping over time and one further dimension
+ * (usually frequency) which stores its values in one contiguous matrix.
+ *
+ * All rows (positions in the second dimension) share one time axis. Points
+ * of the grid which were never set are skipped by the iterators and
+ * interpolated from the set points of their row, so the mapping returns
+ * the same values and iterates the same positions as a
+ * MultiDimMapping<Linear> with the same key entries. For rectangular
+ * signals, like the ones created by BaseMacLayer::createSingleFrequencyMapping,
+ * every grid point is set and lookups are a plain bilinear interpolation.
+ *
+ * The grid is only efficient if (nearly) every point of it is set: lookups
+ * in sparsely set rows search linearly for the set neighbours and every new
+ * time copies the whole grid. Therefore MappingUtils::createMapping() keeps
+ * returning a MultiDimMapping, use a GridMapping only if the mapping is
+ * known to be rectangular.
+ *
+ * @ingroup mapping
+ */
+class MIXIM_API GridMapping : public Mapping {
+public:
+	/** @brief Type of the time axis.*/
+	typedef std::vector<simtime_t>        time_axis_type;
+	/** @brief Type of the axis of the second dimension.*/
+	typedef std::vector<argument_value_t> row_axis_type;
+
+	/** @brief Index returned by the search methods if no column was found. */
+	static const size_t npos;
+
+protected:
+	/** @brief The second dimension of the domain. */
+	Dimension                     rowDimension;
+	/** @brief The time axis shared by all rows. */
+	time_axis_type                times;
+	/** @brief The positions of the rows in the second dimension. */
+	row_axis_type                 rows;
+	/** @brief The values of the grid, row after row. */
+	std::vector<argument_value_t> values;
+	/** @brief Stores which grid points have been set. */
+	std::vector<char>             defined;
+
+	/** @brief Return the border values outside the set points instead of outOfRangeValue. */
+	bool                          continueOutOfRange;
+	argument_value_t              outOfRangeValue;
+
+	friend class GridMappingIterator;
+
+protected:
+	size_t columns() const { return times.size(); }
+
+	size_t index(size_t row, size_t col) const { return row * times.size() + col; }
+
+	bool isSet(size_t row, size_t col) const { return defined[index(row, col)] != 0; }
+
+	/** @brief Returns the first set column of the row at or after col, or the number of columns. */
+	size_t nextSet(size_t row, size_t col) const {
+		const size_t nCols = columns();
+		while (col < nCols && !isSet(row, col))
+			++col;
+		return col;
+	}
+
+	/** @brief Returns the last set column of the row before col, or npos. */
+	size_t prevSet(size_t row, size_t col) const {
+		while (col > 0) {
+			--col;
+			if (isSet(row, col))
+				return col;
+		}
+		return npos;
+	}
+
+	/** @brief Returns the index of the first row after pos. */
+	size_t upperRow(argument_value_cref_t pos) const {
+		return std::upper_bound(rows.begin(), rows.end(), pos) - rows.begin();
+	}
+
+	/** @brief Returns the index of the first column after t. */
+	size_t upperColumn(simtime_t_cref t) const {
+		return std::upper_bound(times.begin(), times.end(), t) - times.begin();
+	}
+
+	/** @brief Inserts an empty row at the passed index. */
+	void insertRow(size_t row, argument_value_cref_t pos);
+
+	/** @brief Inserts an empty column at the passed index. */
+	void insertColumn(size_t col, simtime_t_cref t);
+
+	/**
+	 * @brief Sets the value of the row at time t and returns the column
+	 * of the set point.
+	 *
+	 * The parameter right has to be the first set column of the row after t.
+	 */
+	size_t setRowValue(size_t row, simtime_t_cref t, size_t right, argument_value_cref_t value);
+
+	/** @brief Returns the value at the border of the set points of a row. */
+	argument_value_t outOfRange(size_t row, size_t col) const {
+		return continueOutOfRange ? values[index(row, col)] : outOfRangeValue;
+	}
+
+	/**
+	 * @brief Returns the value of a row at time t, interpolated between the
+	 * set points of the row.
+	 *
+	 * The parameter right has to be the first set column of the row after t.
+	 */
+	argument_value_t getRowValue(size_t row, simtime_t_cref t, size_t right) const;
+
+public:
+	/** @brief Initializes an empty mapping over the passed two dimensional domain. */
+	GridMapping(const DimensionSet& dims);
+
+	/**
+	 * @brief Initializes an empty mapping over the passed two dimensional domain
+	 * which returns the passed value outside of its set points.
+	 */
+	GridMapping(const DimensionSet& dims, argument_value_cref_t outOfRangeVal);
+
+	virtual ~GridMapping() {}
+
+	virtual Mapping* clone() const { return new GridMapping(*this); }
+
+	/**
+	 * @brief Returns the value at the passed position.
+	 *
+	 * Has logarithmic complexity over the number of rows and columns if the
+	 * grid is fully set, otherwise searching the set neighbours in a row is
+	 * linear over the number of unset columns.
+	 */
+	virtual argument_value_t getValue(const Argument& pos) const;
+
+	/**
+	 * @brief Sets the value at the passed position.
+	 *
+	 * Adding a new column has linear complexity over the size of the grid,
+	 * setting a point of an existing column logarithmic complexity plus the
+	 * search for the set neighbours in the row (see getValue()).
+	 */
+	virtual void setValue(const Argument& pos, argument_value_cref_t value);
+
+	virtual MappingIterator* createIterator() {
+		return new GridMappingIterator(*this);
+	}
+
+	virtual MappingIterator* createIterator(const Argument& pos) {
+		return new GridMappingIterator(*this, pos);
+	}
+
+	/** @brief Returns the second dimension of the domain. */
+	Dimension getRowDimension() const { return rowDimension; }
+
+	/**
+	 * @brief Returns true if both mappings have the same axes and every
+	 * point of both grids is set.
+	 */
+	bool hasSameFullGrid(const GridMapping& o) const;
+
+	/**
+	 * @brief Sets this mapping to the grid of the passed mappings with the
+	 * result of "op" on their values at every grid point.
+	 *
+	 * Both mappings have to have the same full grid, see hasSameFullGrid().
+	 */
+	template<class Operator>
+	void setElementWise(const GridMapping& f1, const GridMapping& f2, Operator op) {
+		assert(f1.hasSameFullGrid(f2));
+
+		times   = f1.times;
+		rows    = f1.rows;
+		defined = f1.defined;
+		values.resize(f1.values.size());
+		for (size_t i = 0; i < values.size(); ++i) {
+			values[i] = op(f1.values[i], f2.values[i]);
+		}
+	}
+};
+
+#endif /* GRIDMAPPING_H_ */
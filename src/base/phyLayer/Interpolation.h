@@ -3,6 +3,7 @@
 
 #include <limits>
 #include <map>
+#include <vector>
 #include <algorithm>
 #include <assert.h>
 
@@ -97,6 +98,131 @@ public:
 	}
 };
 
+/**
+ * @brief Sorted, contiguous key-value storage with the subset of the std::map
+ * interface needed by InterpolateableMap and its iterators.
+ *
+ * Keys and values are stored as pairs inside one std::vector ordered by key.
+ * Appending entries in increasing key order (the common case when a signal is
+ * built from left to right) is amortized constant and needs no per entry
+ * allocation, look ups are binary searches over contiguous memory.
+ * Inserting in front of existing entries is still possible but has linear
+ * complexity.
+ *
+ * NOTE: Unlike std::map, inserting an entry invalidates all iterators into
+ * this container.
+ *
+ * @ingroup mappingDetails
+ */
+template<class TKey, class TMapped>
+class SortedVectorMap {
+public:
+	typedef TKey                                  key_type;
+	typedef TMapped                               mapped_type;
+	typedef std::pair<key_type, mapped_type>      value_type;
+protected:
+	typedef std::vector<value_type>               storage_type;
+	typedef PairLess<value_type, key_type>        comparator_type;
+public:
+	typedef typename storage_type::iterator       iterator;
+	typedef typename storage_type::const_iterator const_iterator;
+	typedef typename storage_type::size_type      size_type;
+
+protected:
+	/** @brief The key-value-pairs ordered by key.*/
+	storage_type entries;
+
+public:
+	SortedVectorMap():
+		entries() {}
+
+	iterator       begin()       { return entries.begin(); }
+	const_iterator begin() const { return entries.begin(); }
+	iterator       end()         { return entries.end(); }
+	const_iterator end()   const { return entries.end(); }
+
+	size_type size()  const { return entries.size(); }
+	bool      empty() const { return entries.empty(); }
+	void      clear()       { entries.clear(); }
+
+	/** @brief Reserves memory for the passed number of entries.*/
+	void reserve(size_type n) { entries.reserve(n); }
+
+	void swap(SortedVectorMap& o) { entries.swap(o.entries); }
+
+	iterator lower_bound(const key_type& k) {
+		return std::lower_bound(entries.begin(), entries.end(), k, comparator_type());
+	}
+	const_iterator lower_bound(const key_type& k) const {
+		return std::lower_bound(entries.begin(), entries.end(), k, comparator_type());
+	}
+
+	iterator upper_bound(const key_type& k) {
+		if(entries.empty() || entries.back().first < k)
+			return entries.end();
+		return std::upper_bound(entries.begin(), entries.end(), k, comparator_type());
+	}
+	const_iterator upper_bound(const key_type& k) const {
+		if(entries.empty() || entries.back().first < k)
+			return entries.end();
+		return std::upper_bound(entries.begin(), entries.end(), k, comparator_type());
+	}
+
+	iterator find(const key_type& k) {
+		iterator it = lower_bound(k);
+		return (it != entries.end() && !(k < it->first)) ? it : entries.end();
+	}
+	const_iterator find(const key_type& k) const {
+		const_iterator it = lower_bound(k);
+		return (it != entries.end() && !(k < it->first)) ? it : entries.end();
+	}
+
+	/**
+	 * @brief Returns the value for the passed key, a default constructed
+	 * value is inserted if there is no entry for the key yet.
+	 */
+	mapped_type& operator[](const key_type& k) {
+		return insert(entries.end(), value_type(k, mapped_type()))->second;
+	}
+
+	/**
+	 * @brief Inserts the passed pair if there is no entry with the same key.
+	 *
+	 * Like std::map an existing entry is not changed. The passed hint is used
+	 * if the new entry belongs directly in front of it, which makes appending
+	 * with end() as hint amortized constant.
+	 *
+	 * @return An iterator to the entry with the key of the passed pair.
+	 */
+	iterator insert(iterator hint, const value_type& v) {
+		const bool bHintValid = (hint == entries.begin() || (hint - 1)->first < v.first)
+		                     && (hint == entries.end()   || v.first < hint->first);
+		if(!bHintValid) {
+			hint = lower_bound(v.first);
+			if(hint != entries.end() && !(v.first < hint->first))
+				return hint;
+		}
+		if(hint == entries.end()) {
+			entries.push_back(v);
+			return entries.end() - 1;
+		}
+		return entries.insert(hint, v);
+	}
+
+	/**
+	 * @brief Inserts the passed pair if there is no entry with the same key.
+	 */
+	std::pair<iterator, bool> insert(const value_type& v) {
+		const size_type nOldSize = entries.size();
+		iterator        it       = insert(entries.end(), v);
+
+		return std::make_pair(it, entries.size() != nOldSize);
+	}
+
+	void erase(iterator pos) { entries.erase(pos); }
+	void erase(iterator first, iterator last) { entries.erase(first, last); }
+};
+
 template<class _ContainerType>
 class InterpolatorBase {
 public:
@@ -747,19 +873,21 @@ public:
 	 * current position of the iterator to the passed value
 	 */
 	void setValue(mapped_cref_type value) {
-		//container is empty or position is smaller first entry
-		if(this->right == this->first) {
-			//insert new entry before first entry and store new entry as new first
-			this->first = cont.insert(this->first, std::make_pair(this->position, value));
-		} else {
+		if(this->right != this->first) {
 			iterator left = this->right;
 			--left;
 			if(left->first == this->position) {
 				left->second = value;
-			} else {
-				cont.insert(this->right, std::make_pair(this->position, value));
+				return;
 			}
 		}
+		//insert new entry in front of the next bigger entry, since contiguous
+		//containers (like SortedVectorMap) may reallocate on insert all
+		//stored iterators are re-synchronized afterwards
+		iterator newEntry = cont.insert(this->right, std::make_pair(this->position, value));
+		this->first = cont.begin();
+		this->last  = cont.end();
+		this->right = ++newEntry;
 	}
 };
 
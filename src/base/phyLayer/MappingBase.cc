@@ -71,22 +71,63 @@ const DimensionSet DimensionSet::timeFreqDomain(Dimension::time, Dimension::freq
 //--Argument implementation---------------------------
 
 Argument::Argument(simtime_t_cref timeVal):
-	time(timeVal), values()
+	time(timeVal), values(inlineValues), count(0), capacity(INLINE_VALUES)
 {}
 
 Argument::Argument(const DimensionSet & dims, simtime_t_cref timeVal):
-	time(timeVal), values()
+	time(timeVal), values(inlineValues), count(0), capacity(INLINE_VALUES)
 {
 	DimensionSet::const_iterator       it    = dims.begin();
 	const DimensionSet::const_iterator itEnd = dims.end();
 
 	assert((*it) == Dimension::time);
 
+	// the DimensionSet is already sorted
+	reserve(dims.size() - 1);
 	for ( ++it; it != itEnd; ++it) {
-		values.insert( Argument::value_type(*it, Argument::MappedZero) );
+		values[count++] = Argument::value_type(*it, Argument::MappedZero);
 	}
 }
 
+Argument::Argument(const Argument& o):
+	time(o.time), values(inlineValues), count(0), capacity(INLINE_VALUES)
+{
+	reserve(o.count);
+	std::copy(o.begin(), o.end(), values);
+	count = o.count;
+}
+
+Argument::~Argument()
+{
+	if (values != inlineValues)
+		delete[] values;
+}
+
+void Argument::reserve(size_t n)
+{
+	if (n <= capacity)
+		return;
+
+	value_type* newValues = new value_type[n];
+	std::copy(begin(), end(), newValues);
+	if (values != inlineValues)
+		delete[] values;
+	values   = newValues;
+	capacity = n;
+}
+
+Argument::iterator Argument::insertAt(iterator pos, const Argument::value_type& valPair)
+{
+	const size_t idx = pos - values;
+
+	if (count == capacity)
+		reserve(2 * capacity);
+	std::copy_backward(values + idx, end(), end() + 1);
+	values[idx] = valPair;
+	++count;
+	return values + idx;
+}
+
 simtime_t_cref Argument::getTime() const
 {
 	return time;
@@ -98,38 +139,47 @@ void Argument::setTime(simtime_t_cref time)
 }
 
 Argument::iterator Argument::find(const Argument::key_type& dim){
-	assert(!(dim == Dimension::time));
+	iterator it = lower_bound(dim);
 
-	return values.find(dim);
+	return (it != end() && it->first == dim) ? it : end();
 }
 
 Argument::const_iterator Argument::find(const Argument::key_type& dim) const{
-	assert(!(dim == Dimension::time));
+	const_iterator it = lower_bound(dim);
 
-	return values.find(dim);
+	return (it != end() && it->first == dim) ? it : end();
 }
 
 Argument::iterator Argument::lower_bound(const Argument::key_type& dim){
 	assert(!(dim == Dimension::time));
 
-	return values.lower_bound(dim);
+	// Arguments have only few dimensions, a linear search is the fastest
+	iterator       it    = begin();
+	const iterator itEnd = end();
+	while (it != itEnd && it->first < dim)
+		++it;
+	return it;
 }
 
 Argument::const_iterator Argument::lower_bound(const Argument::key_type& dim) const{
 	assert(!(dim == Dimension::time));
 
-	return values.lower_bound(dim);
+	const_iterator       it    = begin();
+	const const_iterator itEnd = end();
+	while (it != itEnd && it->first < dim)
+		++it;
+	return it;
 }
 
 bool Argument::hasArgVal(const Argument::key_type& dim) const{
-	return values.find(dim) != values.end();
+	return find(dim) != end();
 }
 
 Argument::mapped_type_cref Argument::getArgValue(const Argument::key_type & dim) const
 {
 	const_iterator it = find(dim);
 
-	if(it == values.end())
+	if(it == end())
 		return MappedZero;
 
 	return it->second;
@@ -139,19 +189,21 @@ void Argument::setArgValue(const Argument::key_type& dim, Argument::mapped_type_
 {
 	assert(!(dim == Dimension::time));
 
-	iterator pos = values.lower_bound(dim);
-	if(pos != values.end() && !(values.key_comp()(dim, pos->first))) {
+	iterator pos = lower_bound(dim);
+	if(pos != end() && !(dim < pos->first)) {
 	    // key already exists
 	    // update pos->second if you care to
 		pos->second = value;
 		return;
 	}
-	values.insert(pos, Argument::value_type(dim, value));
+	insertAt(pos, Argument::value_type(dim, value));
 }
 
 inline Argument::iterator Argument::insertValue(iterator pos, const Argument::value_type& valPair, iterator& itEnd, bool ignoreUnknown) {
-	pos = values.lower_bound(valPair.first);
-	if(pos != itEnd && !(values.key_comp()(valPair.first, pos->first))) {
+	// the values are inserted in ascending order, continue searching at pos
+	while (pos != itEnd && pos->first < valPair.first)
+		++pos;
+	if(pos != itEnd && !(valPair.first < pos->first)) {
 	    // key already exists
 	    // update pos->second if you care to
 		pos->second = valPair.second;
@@ -160,8 +212,8 @@ inline Argument::iterator Argument::insertValue(iterator pos, const Argument::va
 	if (ignoreUnknown)
 		return pos;
 
-	pos   = values.insert(pos, valPair);
-	itEnd = values.end();
+	pos   = insertAt(pos, valPair);
+	itEnd = end();
 	return pos;
 }
 
@@ -170,7 +222,7 @@ void Argument::setArgValues(const Argument& o, bool ignoreUnknown){
 
 	iterator             pos      = begin();
 	const const_iterator oEndIter = o.end();
-	iterator             EndIter  = values.end();
+	iterator             EndIter  = end();
 
 	for(const_iterator it = o.begin(); it != oEndIter; ++it) {
 		pos = insertValue(pos, *it, EndIter, ignoreUnknown);
@@ -185,11 +237,11 @@ bool Argument::isSamePosition(const Argument & o) const
 		return false;
 	}
 
-	if(values.size() < o.values.size()){
+	if(count < o.count){
 		return false;
 	}
 
-	if(o.values.empty())
+	if(o.count == 0)
 		return true;
 
 	const_iterator       itO    = o.begin();
@@ -216,7 +268,7 @@ bool Argument::isSamePosition(const Argument & o) const
 }
 
 bool Argument::isClose(const Argument& o, Argument::mapped_type_cref epsilon) const{
-	if(values.size() != o.values.size())
+	if(count != o.count)
 		return false;
 
 	if(fabs(SIMTIME_DBL(time - o.time)) > epsilon)
@@ -240,14 +292,18 @@ bool Argument::isClose(const Argument& o, Argument::mapped_type_cref epsilon) co
 
 bool Argument::operator==(const Argument & o) const
 {
-	if(time != o.time || values.size() != o.values.size())
+	if(time != o.time || count != o.count)
 		return false;
 
 	return compare(o) == 0;
 }
 
 Argument& Argument::operator=(const Argument& o){
-	values = o.values;
+	if (this != &o) {
+		reserve(o.count);
+		std::copy(o.begin(), o.end(), values);
+		count = o.count;
+	}
 	time   = o.time;
 	return *this;
 }
@@ -264,14 +320,13 @@ int Argument::compare(const Argument& o, const DimensionSet *const dims /*= NULL
 	DimensionSet::const_iterator                 DimItLast; if (dims != NULL) DimItLast = dims->end();
 	const DimensionSet::const_iterator           DimItEnd  = DimItLast;
 
-	const container_type::const_reverse_iterator rItEnd = values.rend();
-	const container_type::const_iterator         itEndO = o.values.end();
-	container_type::const_reverse_iterator       rIt;
-	container_type::const_iterator               itO;
+	const const_reverse_iterator                 rItEnd = const_reverse_iterator(begin());
+	const const_iterator                         itEndO = o.end();
+	const_iterator                               itO;
 	bool                                         bDidCompare = false;
 
 	//iterate through passed dimensions and compare arguments in these dimensions
-	for (container_type::const_reverse_iterator rIt = values.rbegin(); rIt != rItEnd; ++rIt) {
+	for (const_reverse_iterator rIt = const_reverse_iterator(end()); rIt != rItEnd; ++rIt) {
 		bool bMissedDimsEntry = false;
 
 		if (dims != NULL) {
@@ -286,7 +341,7 @@ int Argument::compare(const Argument& o, const DimensionSet *const dims /*= NULL
 		}
 		bDidCompare = true;
 		//catch special cases time, missing dimension values (after which we can abort)
-		if( bMissedDimsEntry || (itO = o.values.find(rIt->first)) == itEndO ) {
+		if( bMissedDimsEntry || (itO = o.find(rIt->first)) == itEndO ) {
 			if (time == o.time)
 				return 0;
 			return (time < o.time) ? -1 : 1;
@@ -307,6 +362,21 @@ int Argument::compare(const Argument& o, const DimensionSet *const dims /*= NULL
 
 //---Mapping implementation---------------------------------------
 
+MemoryPool& ConstMapping::getPool() {
+	//use "construct-on-first-use" idiom and never delete the pool since
+	//Mappings may still be deleted during the clean up of the simulation
+	static MemoryPool* pool = new MemoryPool("Mappings");
+	return *pool;
+}
+
+void* ConstMappingIterator::operator new(size_t size) {
+	return ConstMapping::getPool().allocate(size);
+}
+
+void ConstMappingIterator::operator delete(void* p, size_t size) {
+	ConstMapping::getPool().release(p, size);
+}
+
 SimpleConstMappingIterator::SimpleConstMappingIterator(const ConstMapping*                            mapping,
                                                        const SimpleConstMappingIterator::KeyEntrySet* keyEntries,
                                                        const Argument&                                start)
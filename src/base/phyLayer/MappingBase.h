@@ -11,6 +11,7 @@
 #include <iomanip>
 
 #include "MiXiMDefs.h"
+#include "MemoryPool.h"
 #include "Interpolation.h"
 
 /**
@@ -424,21 +425,50 @@ public:
 	/** @brief One value of a Argument value. */
 	const static mapped_type         MappedOne;
 protected:
-	typedef std::map<key_type, mapped_type> container_type;
-	typedef container_type::value_type      value_type;
+	/** @brief Type of a Dimension<->Value-pair of this Argument. */
+	typedef std::pair<key_type, mapped_type> value_type;
+
+	/** @brief Number of values (besides time) stored inside the Argument itself. */
+	enum { INLINE_VALUES = 4 };
+
 	/** @brief Stores the time dimension in Omnet's time type */
 	simtime_t      time;
 
-	/** @brief Maps the dimensions of this Argument to their values. */
-	container_type values;
+	/**
+	 * @brief The values of this Argument, sorted by their Dimension.
+	 *
+	 * Points to inlineValues as long as they are big enough, otherwise to
+	 * an array on the heap.
+	 */
+	value_type*    values;
+	/** @brief Number of values in this Argument. */
+	size_t         count;
+	/** @brief Number of values the "values" array can hold. */
+	size_t         capacity;
+	/** @brief Inline storage for the values, avoids allocations for Arguments with few dimensions. */
+	value_type     inlineValues[INLINE_VALUES];
 
 public:
 	/** @brief Iterator type for this set.*/
-	typedef container_type::iterator       iterator;
+	typedef value_type*       iterator;
 	/** @brief Const-iterator type for this set.*/
-	typedef container_type::const_iterator const_iterator;
+	typedef const value_type* const_iterator;
 
 protected:
+	/** @brief Reverse const-iterator type for this set.*/
+	typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+	/** @brief Ensures that the "values" array can hold at least n values. */
+	void reserve(size_t n);
+
+	/**
+	 * @brief Inserts the passed Dimension<->Value-pair in front of the passed
+	 * position and returns the position of the new pair.
+	 *
+	 * Invalidates all iterators of this Argument.
+	 */
+	iterator insertAt(iterator pos, const Argument::value_type& valPair);
+
 	/**
 	 * @brief Inserts the passed value for the passed Dimension into
 	 * this Argument.
@@ -454,24 +484,6 @@ protected:
 	 */
 	inline iterator insertValue(iterator pos, const Argument::value_type& valPair, iterator& itEnd, bool ignoreUnknown = false);
 
-	template<typename IteratorType>
-	class key_iterator : public IteratorType
-	{
-	public:
-	    typedef typename IteratorType::value_type::first_type& reference;
-	    typedef typename IteratorType::value_type::first_type* pointer;
-
-	    key_iterator(const IteratorType& other) : IteratorType(other) {} ;
-
-	    const reference operator *() const
-	    {
-	        return IteratorType::operator*().first;
-	    }
-	    pointer operator ->() const
-	    {
-	        return &IteratorType::operator->()->first;
-	    }
-	};
 public:
 	/**
 	 * @brief Initialize this argument with the passed value for
@@ -486,6 +498,14 @@ public:
 	 */
 	Argument(const DimensionSet& dims, simtime_t_cref timeVal = SIMTIME_ZERO);
 
+	/**
+	 * @brief Copy constructor, does not allocate as long as the values
+	 * fit into the inline storage.
+	 */
+	Argument(const Argument& o);
+
+	~Argument();
+
 	/**
 	 * @brief Returns the time value of this argument.
 	 */
@@ -597,12 +617,11 @@ public:
 	 * dimensions inside this Argument.
 	 */
 	DimensionSet getDimensions() const {
-		typedef key_iterator<const_iterator> key_const_iterator;
-
 		DimensionSet res(Dimension::time);
 
-		res.insert(key_const_iterator(values.begin()), key_const_iterator(values.end()));
-
+		for (const_iterator it = begin(); it != end(); ++it) {
+			res.insert(res.end(), it->first);
+		}
 		return res;
 	}
 
@@ -631,21 +650,21 @@ public:
 	/**
 	 * @brief Returns an iterator to the first argument value in this Argument.
 	 */
-	iterator begin() { return values.begin(); }
+	iterator begin() { return values; }
 	/**
 	 * @brief Returns an iterator to the first argument value in this Argument.
 	 */
-	const_iterator begin() const { return values.begin(); }
+	const_iterator begin() const { return values; }
 
 
 	/**
 	 * @brief Returns an iterator to the value behind the last argument value.
 	 */
-	iterator end() { return values.end(); }
+	iterator end() { return values + count; }
 	/**
 	 * @brief Returns an iterator to the value behind the last argument value.
 	 */
-	const_iterator end() const { return values.end(); }
+	const_iterator end() const { return values + count; }
 
 	/**
 	 * @brief Returns an iterator to the Argument value for the passed Dimension.
@@ -713,6 +732,11 @@ public:
 	ConstMappingIterator() {}
 	virtual ~ConstMappingIterator() {}
 
+	/** @brief Iterators are allocated from the Mapping memory pool.*/
+	static void* operator new(size_t size);
+	/** @brief Returns the memory of the iterator to the Mapping memory pool.*/
+	static void operator delete(void* p, size_t size);
+
 	/**
 	 * @brief Copy constructor.
 	 */
@@ -927,6 +951,17 @@ public:
 
 	virtual ~ConstMapping() {}
 
+	/** @brief Mappings are allocated from the Mapping memory pool.*/
+	static void* operator new(size_t size) { return getPool().allocate(size); }
+	/** @brief Returns the memory of the Mapping to the Mapping memory pool.*/
+	static void operator delete(void* p, size_t size) { getPool().release(p, size); }
+
+	/**
+	 * @brief Returns the memory pool all Mappings and their iterators are
+	 * allocated from.
+	 */
+	static MemoryPool& getPool();
+
 	/**
 	 * @brief Returns the value of this Mapping at the position specified
 	 * by the passed Argument.
@@ -86,13 +86,13 @@ Mapping* MappingUtils::createMapping(const DimensionSet& domain, Mapping::Interp
 	if(domain.size() == 1){
 		switch(intpl){
 		case Mapping::LINEAR:
-			return new TimeMapping<Linear>();
+			return new TimeMapping<Linear, TimeMappingVectorStorage>();
 			break;
 		case Mapping::NEAREST:
-			return new TimeMapping<Nearest>();
+			return new TimeMapping<Nearest, TimeMappingVectorStorage>();
 			break;
 		case Mapping::STEPS:
-			return new TimeMapping<NextSmaller>();
+			return new TimeMapping<NextSmaller, TimeMappingVectorStorage>();
 			break;
 		}
 		return 0;
@@ -118,13 +118,13 @@ Mapping* MappingUtils::createMapping(Mapping::argument_value_cref_t outOfRangeVa
 	if(domain.size() == 1){
 		switch(intpl){
 		case Mapping::LINEAR:
-			return new TimeMapping<Linear>(outOfRangeVal);
+			return new TimeMapping<Linear, TimeMappingVectorStorage>(outOfRangeVal);
 			break;
 		case Mapping::NEAREST:
-			return new TimeMapping<Nearest>(outOfRangeVal);
+			return new TimeMapping<Nearest, TimeMappingVectorStorage>(outOfRangeVal);
 			break;
 		case Mapping::STEPS:
-			return new TimeMapping<NextSmaller>(outOfRangeVal);
+			return new TimeMapping<NextSmaller, TimeMappingVectorStorage>(outOfRangeVal);
 			break;
 		}
 		return 0;
@@ -370,6 +370,184 @@ Mapping::argument_value_t MappingUtils::findMin(const ConstMapping& m, const Arg
 }
 
 
+/**
+ * @brief Returns true if the passed position lies inside [pRangeFrom, pRangeTo]
+ * in every dimension of the position.
+ */
+static bool isInRange(const Argument& pos, const Argument& pRangeFrom, const Argument& pRangeTo) {
+	if(pos.getTime() < pRangeFrom.getTime() || pRangeTo.getTime() < pos.getTime())
+		return false;
+
+	const Argument::const_iterator itAEnd = pos.end();
+	for(Argument::const_iterator itA = pos.begin(); itA != itAEnd; ++itA) {
+		if(pRangeFrom.getArgValue(itA->first) > itA->second || itA->second > pRangeTo.getArgValue(itA->first)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief Returns true if the passed positions differ at most in time.
+ */
+static bool isSameExceptTime(const Argument& a, const Argument& b) {
+	Argument::const_iterator       itB    = b.begin();
+	const Argument::const_iterator itBEnd = b.end();
+	const Argument::const_iterator itAEnd = a.end();
+
+	for(Argument::const_iterator itA = a.begin(); itA != itAEnd; ++itA, ++itB) {
+		if(itB == itBEnd || !(itA->first == itB->first) || itA->second != itB->second)
+			return false;
+	}
+	return itB == itBEnd;
+}
+
+/**
+ * @brief Running sums for the mean calculated by findQuotientStats().
+ */
+struct QuotientSums {
+	Argument::mapped_type sum;         ///< the sum of all quotients
+	Argument::mapped_type integral;    ///< the quotients integrated over time
+	double                duration;    ///< the time covered by the integral
+	Argument              lastPos;     ///< the position of the last quotient
+	Argument::mapped_type lastVal;     ///< the last quotient
+
+	QuotientSums()
+		: sum(Argument::MappedZero)
+		, integral(Argument::MappedZero)
+		, duration(0)
+		, lastPos()
+		, lastVal(Argument::MappedZero)
+	{}
+};
+
+/**
+ * @brief Adds the quotient at the current position of the passed iterators
+ * to the passed statistics.
+ *
+ * The first iterator has to point into the numerator, the other iterators
+ * into the key entry defining denominator mappings.
+ *
+ * The quotient is integrated with the trapezoidal rule from the last
+ * position if both positions differ only in time.
+ */
+static void addQuotient(const std::vector<ConstMappingIterator*>& itDrivers,
+                        const MappingUtils::MappingSummands&      sampled,
+                        MappingUtils::QuotientStats&              stats,
+                        QuotientSums&                             sums) {
+	const Argument&       pos         = itDrivers.front()->getPosition();
+	Argument::mapped_type denominator = Argument::MappedZero;
+
+	for(std::size_t i = 1; i < itDrivers.size(); ++i) {
+		denominator += itDrivers[i]->getValue();
+	}
+	const MappingUtils::MappingSummands::const_iterator itSampledEnd = sampled.end();
+	for(MappingUtils::MappingSummands::const_iterator it = sampled.begin(); it != itSampledEnd; ++it) {
+		denominator += (*it)->getValue(pos);
+	}
+	const Argument::mapped_type val = itDrivers.front()->getValue() / denominator;
+
+	if(stats.count == 0 || val < stats.min)
+		stats.min = val;
+	if(stats.count == 0 || val > stats.max)
+		stats.max = val;
+	if(stats.count > 0 && isSameExceptTime(pos, sums.lastPos)) {
+		const double dt = SIMTIME_DBL(pos.getTime() - sums.lastPos.getTime());
+
+		sums.integral += (sums.lastVal + val) / 2 * dt;
+		sums.duration += dt;
+	}
+	sums.sum     += val;
+	sums.lastPos  = pos;
+	sums.lastVal  = val;
+	++stats.count;
+}
+
+bool MappingUtils::findQuotientStats(const ConstMapping& numerator, const MappingSummands& denominator,
+                                     const Argument& pRangeFrom, const Argument& pRangeTo, QuotientStats& stats) {
+	typedef std::vector<ConstMappingIterator*> IteratorVector;
+
+	const DimensionSet& rDimSet = numerator.getDimensionSet();
+	//the passed interval should define a value for every dimension
+	//of the mapping.
+	assert(pRangeFrom.getDimensions().isSubSet(rDimSet));
+	assert(pRangeTo.getDimensions().isSubSet(rDimSet));
+
+	//mappings over the same domain as the numerator drive the walk over
+	//the key entries, every other mapping is sampled at the walked positions
+	IteratorVector  itDrivers;
+	MappingSummands sampled;
+
+	itDrivers.reserve(denominator.size() + 1);
+	itDrivers.push_back(numerator.createConstIterator(pRangeFrom));
+
+	const MappingSummands::const_iterator itDenomEnd = denominator.end();
+	for(MappingSummands::const_iterator it = denominator.begin(); it != itDenomEnd; ++it) {
+		assert(rDimSet.isSubSet((*it)->getDimensionSet()));
+
+		if((*it)->getDimensionSet() == rDimSet)
+			itDrivers.push_back((*it)->createConstIterator(pRangeFrom));
+		else
+			sampled.push_back(*it);
+	}
+
+	const IteratorVector::iterator itDriversEnd = itDrivers.end();
+	QuotientStats                  result;
+	QuotientSums                   sums;
+	bool                           bInRange     = false;
+
+	for(IteratorVector::iterator it = itDrivers.begin(); it != itDriversEnd && !bInRange; ++it) {
+		bInRange = (*it)->inRange();
+	}
+	if(bInRange) {
+		addQuotient(itDrivers, sampled, result, sums);
+	}
+
+	while(true) {
+		//find the iterator with the nearest next key entry before the end of the range
+		ConstMappingIterator* itNext = NULL;
+		for(IteratorVector::iterator it = itDrivers.begin(); it != itDriversEnd; ++it) {
+			if(!(*it)->hasNext() || (*it)->getNextPosition().compare(pRangeTo, &rDimSet) >= 0)
+				continue;
+			if(itNext == NULL || (*it)->getNextPosition() < itNext->getNextPosition())
+				itNext = *it;
+		}
+		if(itNext == NULL)
+			break;
+
+		itNext->next();
+		const Argument& next = itNext->getPosition();
+		for(IteratorVector::iterator it = itDrivers.begin(); it != itDriversEnd; ++it) {
+			if(*it != itNext)
+				(*it)->iterateTo(next);
+		}
+		if(isInRange(next, pRangeFrom, pRangeTo)) {
+			addQuotient(itDrivers, sampled, result, sums);
+		}
+	}
+
+	bInRange = false;
+	for(IteratorVector::iterator it = itDrivers.begin(); it != itDriversEnd; ++it) {
+		(*it)->iterateTo(pRangeTo);
+		bInRange = bInRange || (*it)->inRange();
+	}
+	if(bInRange) {
+		addQuotient(itDrivers, sampled, result, sums);
+	}
+
+	for(IteratorVector::iterator it = itDrivers.begin(); it != itDriversEnd; ++it) {
+		delete *it;
+	}
+	if(result.count == 0) {
+		return false;
+	}
+	//without any time covered (e.g. an empty time range) every position counts the same
+	result.mean = (sums.duration > 0) ? sums.integral / sums.duration : sums.sum / result.count;
+	stats       = result;
+	return true;
+}
+
+
 void MappingUtils::addDiscontinuity(Mapping* m,
                                     const Argument& pos, Mapping::argument_value_cref_t value,
                                     simtime_t_cref limitTime, Mapping::argument_value_cref_t limitValue)
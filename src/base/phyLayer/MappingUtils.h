@@ -10,6 +10,7 @@
 
 #include "MiXiMDefs.h"
 #include "MappingBase.h"
+#include "GridMapping.h"
 
 class FilledUpMapping;
 
@@ -101,6 +102,22 @@ public:
 };
 
 
+/**
+ * @brief Default storage type of TimeMappings, one map node per key entry.
+ *
+ * @ingroup mapping
+ */
+typedef std::map<simtime_t, Argument::mapped_type>      TimeMappingMapStorage;
+
+/**
+ * @brief Contiguous storage type of TimeMappings, best suited for mappings
+ * which are filled in increasing time order.
+ *
+ * @sa SortedVectorMap
+ * @ingroup mapping
+ */
+typedef SortedVectorMap<simtime_t, Argument::mapped_type> TimeMappingVectorStorage;
+
 /**
  * @brief Provides an implementation of the MappingIterator-
  * Interface which is able to iterate over TimeMappings.
@@ -108,12 +125,11 @@ public:
  * @author Karl Wessel
  * @ingroup mapping
  */
-template<template <typename> class Interpolator>
+template<template <typename> class Interpolator, class Storage = TimeMappingMapStorage>
 class TimeMappingIterator:public MappingIterator {
 protected:
-	/** @brief The templated InterpolateableMap the underlying Mapping uses std::map as storage type.*/
-	typedef InterpolateableMap< Interpolator< std::map<simtime_t, argument_value_t> > >
-	                                                             interpolator_map_type;
+	/** @brief The templated InterpolateableMap the underlying Mapping uses as storage.*/
+	typedef InterpolateableMap< Interpolator< Storage > >        interpolator_map_type;
 	typedef typename interpolator_map_type::interpolator_type    interpolator_type;
 	typedef typename interpolator_map_type::mapped_type          mapped_type;
 	typedef typename interpolator_map_type::iterator_intpl       iterator;
@@ -166,7 +182,7 @@ public:
 		position.setTime(valueIt.getPosition());
 		updateNextPos();
 	}
-	TimeMappingIterator(const TimeMappingIterator<Interpolator>& o)
+	TimeMappingIterator(const TimeMappingIterator<Interpolator, Storage>& o)
 		: MappingIterator(o)
 		, valueIt(o.valueIt)
 		, position(o.position)
@@ -309,15 +325,21 @@ public:
  * simtime_t to double between which values can be interpolated to represent
  * a Mapping with only time as domain.
  *
+ * The Storage parameter selects the container of the key entries. The
+ * default TimeMappingMapStorage allocates one node per entry, the
+ * TimeMappingVectorStorage keeps all entries in one sorted array and should
+ * be used for mappings which are filled in increasing time order.
+ * Note that with TimeMappingVectorStorage setting a new key entry through the
+ * mapping invalidates every other iterator of that mapping.
+ *
  * @author Karl Wessel
  * @ingroup mapping
  */
-template<template <typename> class Interpolator>
+template<template <typename> class Interpolator, class Storage = TimeMappingMapStorage>
 class TimeMapping:public Mapping {
 protected:
-	/** @brief The templated InterpolateableMap the underlying Mapping uses std::map as storage type.*/
-	typedef InterpolateableMap< Interpolator< std::map<simtime_t, argument_value_t> > >
-	                                                             interpolator_map_type;
+	/** @brief The templated InterpolateableMap the underlying Mapping uses as storage.*/
+	typedef InterpolateableMap< Interpolator< Storage > >        interpolator_map_type;
 	typedef typename interpolator_map_type::interpolator_type    interpolator_type;
 	typedef typename interpolator_map_type::mapped_type          mapped_type;
 	typedef typename interpolator_map_type::mapped_cref_type     mapped_cref_type;
@@ -333,7 +355,7 @@ public:
 	 */
 	TimeMapping():
 		Mapping(), entries() {}
-	TimeMapping(const TimeMapping<Interpolator>& o):
+	TimeMapping(const TimeMapping<Interpolator, Storage>& o):
 		Mapping(o), entries(o.entries) {}
 
 	/**
@@ -346,7 +368,7 @@ public:
 	/**
 	 * @brief returns a deep copy of this mapping instance.
 	 */
-	virtual Mapping* clone() const { return new TimeMapping<Interpolator>(*this); }
+	virtual Mapping* clone() const { return new TimeMapping<Interpolator, Storage>(*this); }
 
 	/**
 	 * @brief Returns the value of this Function at the position specified
@@ -368,6 +390,18 @@ public:
 		entries[pos.getTime()] = value;
 	}
 
+	/**
+	 * @brief Appends the passed value at the passed position to the mapping.
+	 *
+	 * Uses the end of the key entries as insertion hint, so appending in
+	 * increasing time order has amortized constant complexity.
+	 */
+	virtual void appendValue(const Argument& pos, argument_value_cref_t value) {
+		typename interpolator_map_type::iterator it = entries.insert(entries.end(), std::make_pair(pos.getTime(), value));
+
+		it->second = value;
+	}
+
 	/**
 	 * @brief Returns a pointer of a new Iterator which is able to iterate
 	 * over the function and can change the value the iterator points to.
@@ -376,7 +410,7 @@ public:
 	 * pointer if it isn't used anymore.
 	 */
 	virtual MappingIterator* createIterator() {
-		return new TimeMappingIterator<Interpolator>(entries.beginIntpl());
+		return new TimeMappingIterator<Interpolator, Storage>(entries.beginIntpl());
 	}
 
 	/**
@@ -387,7 +421,7 @@ public:
 	 * pointer if it isn't used anymore.
 	 */
 	virtual MappingIterator* createIterator(const Argument& pos) {
-		return new TimeMappingIterator<Interpolator>(entries.findIntpl(pos.getTime()));
+		return new TimeMappingIterator<Interpolator, Storage>(entries.findIntpl(pos.getTime()));
 	}
 };
 
@@ -1797,6 +1831,32 @@ public:
 class MIXIM_API MappingUtils {
 public:
 	typedef std::list<const ConstMapping*> MappingBuffer;
+	/** @brief Type for a number of mappings which are summed up by findQuotientStats().*/
+	typedef std::vector<const ConstMapping*> MappingSummands;
+
+	/**
+	 * @brief Minimum, maximum and mean value of a quotient of mappings, as
+	 * calculated by findQuotientStats().
+	 *
+	 * The mean is weighted by time: the quotient is integrated with the
+	 * trapezoidal rule between consecutive evaluated positions which differ
+	 * only in time, and the integral is divided by the time it covers. If
+	 * no time is covered, it is the arithmetic mean over all evaluated
+	 * positions.
+	 */
+	typedef struct tQuotientStats {
+		Argument::mapped_type min;   ///< the smallest quotient
+		Argument::mapped_type max;   ///< the biggest quotient
+		Argument::mapped_type mean;  ///< the mean quotient
+		std::size_t           count; ///< the number of evaluated positions
+
+		tQuotientStats()
+			: min(cMinNotFound)
+			, max(cMaxNotFound)
+			, mean(Argument::MappedZero)
+			, count(0)
+		{}
+	} QuotientStats;
 
 	/** @brief The default value for findMin() functions if it does not find a minimum element.
 	 *
@@ -1851,6 +1911,16 @@ public:
 
 		using std::operator<<;
 
+		// grids with the same axes can be combined point by point
+		const GridMapping *const g1 = dynamic_cast<const GridMapping*>(&f1);
+		const GridMapping *const g2 = dynamic_cast<const GridMapping*>(&f2);
+		if(g1 && g2 && g1->hasSameFullGrid(*g2)) {
+			GridMapping *const gridResult = (contOutOfRange) ? new GridMapping(g1->getDimensionSet())
+			                                                 : new GridMapping(g1->getDimensionSet(), outOfRangeVal);
+			gridResult->setElementWise(*g1, *g2, op);
+			return gridResult;
+		}
+
 		const ConstMapping *const f2Comp = createCompatibleMapping(f2, f1);
 		const ConstMapping *const f1Comp = createCompatibleMapping(f1, f2);
 
@@ -1980,6 +2050,32 @@ public:
 	 */
 	static Argument::mapped_type findMin(const ConstMapping& m, const Argument& min, const Argument& max, Argument::mapped_type_cref cRetNotFound = cMinNotFound);
 
+	/**
+	 * @brief Calculates minimum, maximum and mean of the quotient of the
+	 * numerator mapping and the sum of the denominator mappings in the range
+	 * defined by the passed min and max parameter, without creating any
+	 * intermediate mapping.
+	 *
+	 * The quotient is evaluated at the same positions findMin() would use on
+	 * the mapping "numerator / (denominator[0] + denominator[1] + ...)":
+	 * the start and the end of the range and every key entry of the numerator
+	 * and the denominator mappings in between. The key entries are walked once
+	 * in a single merged pass. See QuotientStats for how the mean is weighted.
+	 *
+	 * The domain of every denominator mapping has to be a subset of the
+	 * domain of the numerator. Mappings with the same domain as the numerator
+	 * contribute key entries, mappings defined over fewer dimensions (like
+	 * a constant thermal noise) are only sampled at the walked positions.
+	 *
+	 * @param numerator    The mapping to divide (e.g. the receiving power).
+	 * @param denominator  The mappings to sum up as divisor (e.g. noise and interference).
+	 * @param min          The beginning of the range.
+	 * @param max          The end of the range.
+	 * @param stats        Receives the result, is left untouched if there was no position in range.
+	 * @return True if at least one position was evaluated.
+	 */
+	static bool findQuotientStats(const ConstMapping& numerator, const MappingSummands& denominator,
+	                              const Argument& min, const Argument& max, QuotientStats& stats);
 
 	/*
 	static Mapping* multiply(ConstMapping& f1, ConstMapping& f2, const Argument& from, const Argument& to);
@@ -2468,6 +2564,99 @@ public:
 	}
 };
 
+/**
+ * @brief ConstIterator for a ScaledConstMapping.
+ *
+ * Iterates over the key entries of the scaled mapping and multiplies
+ * its values with the scale factor.
+ *
+ * @sa ScaledConstMapping
+ * @ingroup mappingDetails
+ */
+class MIXIM_API ScaledConstMappingIterator: public FilteredConstMappingIterator {
+protected:
+	argument_value_t factor;
+
+public:
+	ScaledConstMappingIterator(ConstMappingIterator* it, argument_value_cref_t factor):
+		FilteredConstMappingIterator(it), factor(factor) {}
+
+	virtual ~ScaledConstMappingIterator() {}
+
+	virtual argument_value_t getValue() const { return origIterator->getValue() * factor; }
+};
+
+/**
+ * @brief Multiplies another ConstMapping with a constant factor.
+ *
+ * In contrast to a ConcatConstMapping with a constant mapping this does not
+ * need to create a concatenated copy of the other mapping to iterate over it.
+ *
+ * Does not take ownership of the scaled mapping unless told so, copies
+ * created by constClone() own their copy of the scaled mapping.
+ *
+ * @ingroup mappingDetails
+ */
+class MIXIM_API ScaledConstMapping: public ConstMapping {
+protected:
+	const ConstMapping* mapping;
+	argument_value_t    factor;
+	/** @brief True if the scaled mapping is deleted together with this mapping. */
+	bool                ownsMapping;
+
+private:
+	/** @brief Copy constructor is not allowed, use constClone(). */
+	ScaledConstMapping(const ScaledConstMapping&);
+	/** @brief Assignment operator is not allowed. */
+	ScaledConstMapping& operator=(const ScaledConstMapping&);
+
+public:
+	ScaledConstMapping(const ConstMapping* mapping, argument_value_cref_t factor, bool ownsMapping = false):
+		ConstMapping(mapping->getDimensionSet()), mapping(mapping), factor(factor), ownsMapping(ownsMapping) {}
+
+	virtual ~ScaledConstMapping() {
+		if(ownsMapping)
+			delete mapping;
+	}
+
+	virtual argument_value_t getValue(const Argument& pos) const {
+		return mapping->getValue(pos) * factor;
+	}
+
+	virtual ConstMappingIterator* createConstIterator() const {
+		return new ScaledConstMappingIterator(mapping->createConstIterator(), factor);
+	}
+
+	virtual ConstMappingIterator* createConstIterator(const Argument& pos) const {
+		return new ScaledConstMappingIterator(mapping->createConstIterator(pos), factor);
+	}
+
+	virtual ConstMapping* constClone() const {
+		return new ScaledConstMapping(mapping->constClone(), factor, true);
+	}
+
+	/**
+	 * @brief Returns the pointer to the scaled mapping.
+	 */
+	const ConstMapping* getRefMapping() const {
+		return mapping;
+	}
+
+	/**
+	 * @brief Returns the factor the scaled mapping is multiplied with.
+	 */
+	argument_value_cref_t getFactor() const {
+		return factor;
+	}
+
+	/**
+	 * @brief Changes the factor the scaled mapping is multiplied with.
+	 */
+	void setFactor(argument_value_cref_t f) {
+		factor = f;
+	}
+};
+
 
 MIXIM_API Mapping* operator*(const ConstMapping& f1, const ConstMapping& f2);
 MIXIM_API Mapping* operator/(const ConstMapping& f1, const ConstMapping& f2);
@@ -29,6 +29,7 @@ void RadioStateAnalogueModel::cleanUpUntil(simtime_t_cref t)
 	// ==> clear complete list except the last element, return
 	if ( t > radioStateAttenuation.back().getTime() )
 	{
+		firstEntryIndex += radioStateAttenuation.size() - 1;
 		radioStateAttenuation.erase(radioStateAttenuation.begin(), --radioStateAttenuation.end());
 		return;
 	}
@@ -47,6 +48,7 @@ void RadioStateAnalogueModel::cleanUpUntil(simtime_t_cref t)
 	// CASE: list contains an element with exactly the given key
 	if ( it != radioStateAttenuation.end() && !(t < *it) )
 	{
+		firstEntryIndex += it - radioStateAttenuation.begin();
 		radioStateAttenuation.erase(radioStateAttenuation.begin(), it);
 		return;
 	}
@@ -56,9 +58,28 @@ void RadioStateAnalogueModel::cleanUpUntil(simtime_t_cref t)
 	--it; // go back one element, possible since this one has not been the first one
 
 	it->setTime(t); // set this elements time to t
+	firstEntryIndex += it - radioStateAttenuation.begin();
 	radioStateAttenuation.erase(radioStateAttenuation.begin(), it); // and erase all previous elements
 }
 
+unsigned long RadioStateAnalogueModel::findEntryIndex(simtime_t_cref t, unsigned long from) const
+{
+	assert( !radioStateAttenuation.empty() && !(t < radioStateAttenuation.front().getTime()) );
+
+	const unsigned long first = std::max(from, firstEntryIndex) - firstEntryIndex;
+
+	// the first entry with timepoint > t, this automatically goes over all
+	// zero time switches
+	time_attenuation_collection_type::const_iterator it =
+	        upper_bound(radioStateAttenuation.begin() + first, radioStateAttenuation.end(), t);
+
+	// go back one entry, this one is significant
+	if ( it != radioStateAttenuation.begin() )
+		--it;
+
+	return firstEntryIndex + (it - radioStateAttenuation.begin());
+}
+
 void RadioStateAnalogueModel::writeRecvEntry(simtime_t_cref time, Argument::mapped_type_cref value)
 {
 	// bugfixed on 08.04.2008
@@ -193,7 +214,7 @@ RSAMConstMappingIterator::RSAMConstMappingIterator( const RadioStateAnalogueMode
                                                     simtime_t_cref                 signalEnd )
 	: ConstMappingIterator()
 	, rsam(rsam)
-	, it()
+	, index(0)
 	, position()
 	, nextPosition()
 	, signalStart(signalStart)
@@ -203,7 +224,10 @@ RSAMConstMappingIterator::RSAMConstMappingIterator( const RadioStateAnalogueMode
 
 	assert( !(signalStart < rsam->radioStateAttenuation.front().getTime()) );
 
-	jumpToBegin();
+	// like jumpToBegin() but without relying on the default position
+	index = rsam->findEntryIndex(signalStart);
+	position.setTime(signalStart);
+	setNextPosition();
 }
 
 void RSAMConstMappingIterator::jumpTo(const Argument& pos)
@@ -219,9 +243,8 @@ void RSAMConstMappingIterator::jumpTo(const Argument& pos)
 		return;
 
 	// this automatically goes over all zero time switches
-	it = upper_bound(rsam->radioStateAttenuation.begin(), rsam->radioStateAttenuation.end(), t);
+	index = rsam->findEntryIndex(t);
 
-	--it;
 	position.setTime(t);
 	setNextPosition();
 }
@@ -235,16 +258,16 @@ void RSAMConstMappingIterator::setNextPosition()
 			nextPosition.setTime(signalStart);
 		} else
 		{
-		    RadioStateAnalogueModel::time_attenuation_collection_type::const_iterator it2 = it;
-			++it2;
+			const RadioStateAnalogueModel::ListEntry& entry = rsam->getEntry(index);
+			const RadioStateAnalogueModel::ListEntry& next  = rsam->getEntry(index + 1);
 
-			assert(it->getTime() <= position.getTime() && position.getTime() < it2->getTime());
+			assert(entry.getTime() <= position.getTime() && position.getTime() < next.getTime());
 
 			//point in time for the "pre step" of the next real key entry
-			simtime_t_cref preTime = MappingUtils::pre(it2->getTime());
+			simtime_t_cref preTime = MappingUtils::pre(next.getTime());
 
 			if(position.getTime() == preTime) {
-				nextPosition.setTime(it2->getTime());
+				nextPosition.setTime(next.getTime());
 			}
 			else {
 				nextPosition.setTime(preTime);
@@ -298,27 +321,17 @@ bool RSAMConstMappingIterator::hasNext() const
 {
 	assert( !(rsam->radioStateAttenuation.empty()) );
 
-	RadioStateAnalogueModel::time_attenuation_collection_type::const_iterator it2 = it;
-	if (it2 != rsam->radioStateAttenuation.end())
-	{
-		++it2;
-	}
-
 	return 	position.getTime() < signalStart
-			|| (it2 != rsam->radioStateAttenuation.end() && it2->getTime() <= signalEnd);
+			|| (index + 1 < rsam->getEndIndex() && rsam->getEntry(index + 1).getTime() <= signalEnd);
 }
 
 void RSAMConstMappingIterator::iterateToOverZeroSwitches(simtime_t_cref t)
 {
-    RadioStateAnalogueModel::time_attenuation_collection_type::const_iterator itEnd = rsam->radioStateAttenuation.end();
-	if( it != itEnd && !(t < it->getTime()) )
+	if( index < rsam->getEndIndex() && !(t < rsam->getEntry(index).getTime()) )
 	{
-		// and go over (ignore) all zero-time-switches, to the next greater entry (time)
-		while( it != itEnd && !(t < it->getTime()) )
-			++it;
-
-		// go back one step, here the iterator 'it' is placed right
-		--it;
+		// go over (ignore) all zero-time-switches, to the last entry not
+		// after t, searching only the entries behind the current one
+		index = rsam->findEntryIndex(t, index);
 	}
 }
 
@@ -334,14 +347,8 @@ RSAMMapping::argument_value_t RSAMMapping::getValue(const Argument& pos) const
 
 	/* receiving list contains at least one entry */
 
-	// set an iterator to the first entry with timepoint > t
-	RadioStateAnalogueModel::time_attenuation_collection_type::const_iterator it;
-	it = upper_bound(rsam->radioStateAttenuation.begin(), rsam->radioStateAttenuation.end(), t);
-
-	// REGULAR CASE: it points to an element that has a predecessor
-	--it; // go back one entry, this one is significant!
-
-	return it->getValue();
+	// binary search for the last entry with timepoint <= t, this one is significant!
+	return rsam->getEntry(rsam->findEntryIndex(t)).getValue();
 }
 
 ConstMappingIterator* RSAMMapping::createConstIterator(const Argument& pos) const
@@ -3,6 +3,7 @@
 
 #include <cassert>
 #include <list>
+#include <deque>
 #include <omnetpp.h>
 
 #include "MiXiMDefs.h"
@@ -114,11 +115,47 @@ protected:
 	bool currentlyTracking;
 
 public:
-	/** @brief The type to hold the attenuation's over time. */
-	typedef std::list<ListEntry> time_attenuation_collection_type;
+	/**
+	 * @brief The type to hold the attenuation's over time.
+	 *
+	 * A deque stores the entries in contiguous blocks, so the frequent
+	 * radio switches of duty cycling MACs don't allocate a node each, and
+	 * allows binary searches for the entry at a certain time.
+	 */
+	typedef std::deque<ListEntry> time_attenuation_collection_type;
 	/** @brief Data structure to track the Radios attenuation over time.*/
 	time_attenuation_collection_type radioStateAttenuation;
 
+protected:
+	/**
+	 * @brief Number of entries ever removed from the front of
+	 * radioStateAttenuation.
+	 *
+	 * Used to address entries by an index which stays valid when new
+	 * entries are added (see RSAMConstMappingIterator).
+	 */
+	unsigned long firstEntryIndex;
+
+	/** @brief Returns the entry with the passed absolute index.*/
+	const ListEntry& getEntry(unsigned long index) const {
+		assert(index >= firstEntryIndex);
+		return radioStateAttenuation[index - firstEntryIndex];
+	}
+
+	/** @brief Returns the absolute index behind the last entry.*/
+	unsigned long getEndIndex() const {
+		return firstEntryIndex + radioStateAttenuation.size();
+	}
+
+	/**
+	 * @brief Returns the absolute index of the last entry with a time less
+	 * or equal to t, i.e. the entry valid at t after all zero time switches.
+	 *
+	 * The index of the first entry is searched from on can be passed as
+	 * "from".
+	 */
+	unsigned long findEntryIndex(simtime_t_cref t, unsigned long from = 0) const;
+
 public:
 
 	/**
@@ -132,6 +169,7 @@ public:
 		: AnalogueModel()
 		, currentlyTracking(currentlyTracking)
 		, radioStateAttenuation()
+		, firstEntryIndex(0)
 	{
 		// put the initial time-stamp to the list
 		radioStateAttenuation.push_back(ListEntry(initTime, initValue));
@@ -442,8 +480,13 @@ protected:
 	/** @brief Pointer to the RSAM module.*/
 	const RadioStateAnalogueModel* rsam;
 
-	/** @brief List iterator pointing to the current position.*/
-	RadioStateAnalogueModel::time_attenuation_collection_type::const_iterator it;
+	/**
+	 * @brief Absolute index of the RSAM entry at the current position.
+	 *
+	 * Other than an iterator the index stays valid if the RSAM stores new
+	 * entries.
+	 */
+	unsigned long index;
 
 	/** @brief The current position of this iterator.*/
 	Argument position;
@@ -482,12 +525,12 @@ public:
 
 	/**
 	 * @brief Helper function that sets member nextPosition. Presumes that
-	 * iterator it and member position are set correctly.
+	 * entry index and member position are set correctly.
 	 *
 	 * This function does not care for zero time switches!
 	 * This must be done before!
 	 *
-	 * Might be helpful if position of iterator it has not been set
+	 * Might be helpful if position of entry index has not been set
 	 * by upper_bound before (it has not just been standing on the "nextPosition").
 	 */
 	virtual void setNextPosition();
@@ -548,12 +591,12 @@ public:
 	 * position.
 	 */
 	virtual argument_value_t getValue() const {
-		return it->getValue();
+		return rsam->getEntry(index).getValue();
 	}
 
 	/**
 	 * @brief Iterates to valid entry for timepoint t over all zero-time switches
-	 * starting from the current position of iterator it
+	 * starting from the current entry index
 	 */
 	virtual void iterateToOverZeroSwitches(simtime_t_cref t);
 
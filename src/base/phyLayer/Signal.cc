@@ -1,43 +1,39 @@
 #include "Signal_.h"
 
 #include <cassert>
+#include <algorithm>
 
 Signal::Signal(simtime_t_cref sendingStart, simtime_t_cref duration):
 	senderModuleID(-1), senderFromGateID(-1), receiverModuleID(-1), receiverToGateID(-1),
 	sendingStart(sendingStart), duration(duration),
 	propagationDelay(0),
-	power(NULL), bitrate(NULL),
-	txBitrate(NULL),
-	attenuations(), rcvPower(NULL)
+	power(), bitrate(),
+	rcvBitrate(NULL),
+	attenuations(), variableAttenuations(), attenuationFactor(1.0), rcvPower(NULL)
 {}
 
 Signal::Signal(const Signal & o):
 	senderModuleID(o.senderModuleID), senderFromGateID(o.senderFromGateID), receiverModuleID(o.receiverModuleID), receiverToGateID(o.receiverToGateID),
 	sendingStart(o.sendingStart), duration(o.duration),
 	propagationDelay(o.propagationDelay),
-	power(NULL), bitrate(NULL),
-	txBitrate(NULL),
-	attenuations(), rcvPower(NULL)
+	power(o.power), bitrate(o.bitrate),
+	rcvBitrate(NULL),
+	attenuations(), variableAttenuations(), attenuationFactor(1.0), rcvPower(NULL)
 {
-	if (o.power) {
-		power = o.power->constClone();
-	}
-
-	if (o.bitrate) {
-		bitrate = o.bitrate->clone();
-	}
-
-	if (o.txBitrate) {
-		txBitrate = o.txBitrate->clone();
+	if (o.rcvBitrate) {
+		rcvBitrate = new DelayedMapping(bitrate.get(), propagationDelay);
 	}
 
 	for(ConstMappingList::const_iterator it = o.attenuations.begin();
 		it != o.attenuations.end(); it++){
-		attenuations.push_back((*it)->constClone());
+		addAttenuation((*it)->constClone());
 	}
 }
 
 Signal& Signal::operator=(const Signal& o) {
+	// has to be done before the propagation delay changes
+	markRcvPowerOutdated();
+
 	sendingStart     = o.sendingStart;
 	duration         = o.duration;
 	propagationDelay = o.propagationDelay;
@@ -46,31 +42,16 @@ Signal& Signal::operator=(const Signal& o) {
 	receiverModuleID = o.receiverModuleID;
 	receiverToGateID = o.receiverToGateID;
 
-	markRcvPowerOutdated();
-
-	if(power){
-		delete power;
-		power = NULL;
+	if(rcvBitrate){
+		delete rcvBitrate;
+		rcvBitrate = NULL;
 	}
 
-	if(bitrate){
-		delete bitrate;
-		bitrate = NULL;
-	}
-
-	if(txBitrate){
-		delete txBitrate;
-		txBitrate = NULL;
-	}
-
-	if(o.power)
-		power = o.power->constClone();
+	power   = o.power;
+	bitrate = o.bitrate;
 
-	if(o.bitrate)
-		bitrate = o.bitrate->clone();
-
-	if(o.txBitrate)
-		txBitrate = o.txBitrate->clone();
+	if(o.rcvBitrate)
+		rcvBitrate = new DelayedMapping(bitrate.get(), propagationDelay);
 
 	for(ConstMappingList::const_iterator it = attenuations.begin();
 		it != attenuations.end(); ++it){
@@ -78,10 +59,12 @@ Signal& Signal::operator=(const Signal& o) {
 	}
 
 	attenuations.clear();
+	variableAttenuations.clear();
+	attenuationFactor = 1.0;
 
 	for(ConstMappingList::const_iterator it = o.attenuations.begin();
 		it != o.attenuations.end(); ++it){
-		attenuations.push_back((*it)->constClone());
+		addAttenuation((*it)->constClone());
 	}
 
 	return *this;
@@ -95,32 +78,21 @@ void Signal::swap(Signal& s) {
 	std::swap(sendingStart,     s.sendingStart);
 	std::swap(duration,         s.duration);
 	std::swap(propagationDelay, s.propagationDelay);
-	std::swap(power,            s.power);
-	std::swap(bitrate,          s.bitrate);
-	std::swap(txBitrate,        s.txBitrate);
-	std::swap(attenuations,     s.attenuations);
-	std::swap(rcvPower,         s.rcvPower);
+	power.swap(s.power);
+	bitrate.swap(s.bitrate);
+	std::swap(rcvBitrate,       s.rcvBitrate);
+	std::swap(attenuations,         s.attenuations);
+	std::swap(variableAttenuations, s.variableAttenuations);
+	std::swap(attenuationFactor,    s.attenuationFactor);
+	std::swap(rcvPower,             s.rcvPower);
 }
 
 Signal::~Signal()
 {
-	if(rcvPower){
-		if(propagationDelay != 0){
-			assert(rcvPower->getRefMapping() != power);
-			delete rcvPower->getRefMapping();
-		}
-
-		delete rcvPower;
-	}
-
-	if(power)
-		delete power;
-
-	if(bitrate)
-		delete bitrate;
+	markRcvPowerOutdated();
 
-	if(txBitrate)
-		delete txBitrate;
+	if(rcvBitrate)
+		delete rcvBitrate;
 
 	for(ConstMappingList::iterator it = attenuations.begin();
 		it != attenuations.end(); it++) {
@@ -155,36 +127,53 @@ simtime_t_cref Signal::getPropagationDelay() const {
 
 void Signal::setPropagationDelay(simtime_t_cref delay) {
 	assert(propagationDelay == 0);
-	assert(!txBitrate);
+	assert(!rcvBitrate);
 
 	markRcvPowerOutdated();
 
 	propagationDelay = delay;
 
-	if(bitrate) {
-		txBitrate = bitrate;
-		bitrate = new DelayedMapping(txBitrate, propagationDelay);
+	if(bitrate.get()) {
+		rcvBitrate = new DelayedMapping(bitrate.get(), propagationDelay);
 	}
 }
 
 void Signal::setTransmissionPower(ConstMapping *power)
 {
-	if(this->power){
+	if(this->power.get()){
 		markRcvPowerOutdated();
-		delete this->power;
 	}
 
-	this->power = power;
+	this->power.reset(power);
 }
 
-void Signal::setBitrate(Mapping *bitrate)
+void Signal::addAttenuation(ConstMapping* att)
 {
-	assert(!txBitrate);
+	//assert the attenuation wasn't already added to the list before
+	assert(std::find(attenuations.begin(), attenuations.end(), att) == attenuations.end());
+
+	attenuations.push_back(att);
+
+	const ConstantSimpleConstMapping *const constAtt = dynamic_cast<const ConstantSimpleConstMapping*>(att);
+	if(constAtt) {
+		attenuationFactor *= constAtt->getValue();
+
+		if(rcvPower)
+			static_cast<ScaledConstMapping*>(rcvPower->getRefMapping())->setFactor(attenuationFactor);
+		return;
+	}
 
-	if(this->bitrate)
-		delete this->bitrate;
+	variableAttenuations.push_back(att);
+
+	if(rcvPower)
+		rcvPower->addMapping(att);
+}
+
+void Signal::setBitrate(Mapping *bitrate)
+{
+	assert(!rcvBitrate);
 
-	this->bitrate = bitrate;
+	this->bitrate.reset(bitrate);
 }
 
 cGate *Signal::getSendingGate() const
@@ -7,6 +7,78 @@
 #include "MiXiMDefs.h"
 #include "Mapping.h"
 
+/**
+ * @brief Reference counted ownership of a Mapping which is shared by the
+ * copies of a Signal.
+ *
+ * The Mapping is deleted together with the last reference to it. Shared
+ * Mappings are never changed, replacing the Mapping of one reference by
+ * reset() does not affect the other references (copy-on-write).
+ *
+ * @ingroup phyLayer
+ */
+template<class M>
+class SharedMappingRef {
+protected:
+	/** @brief The shared Mapping together with its reference count.*/
+	struct Shared {
+		M*            mapping;
+		unsigned long refs;
+	};
+
+	/** @brief The shared Mapping or NULL if this reference is empty.*/
+	Shared* shared;
+
+protected:
+	/** @brief Drops this reference and deletes the Mapping if it was the last one.*/
+	void release() {
+		if(shared && --shared->refs == 0) {
+			delete shared->mapping;
+			delete shared;
+		}
+		shared = NULL;
+	}
+
+public:
+	SharedMappingRef(): shared(NULL) {}
+
+	SharedMappingRef(const SharedMappingRef& o): shared(o.shared) {
+		if(shared)
+			++shared->refs;
+	}
+
+	SharedMappingRef& operator=(const SharedMappingRef& o) {
+		if(o.shared)
+			++o.shared->refs;
+		release();
+		shared = o.shared;
+		return *this;
+	}
+
+	~SharedMappingRef() { release(); }
+
+	/**
+	 * @brief Drops the current Mapping and takes the ownership of the
+	 * passed one (may be NULL).
+	 */
+	void reset(M* mapping = NULL) {
+		release();
+		if(mapping) {
+			shared          = new Shared;
+			shared->mapping = mapping;
+			shared->refs    = 1;
+		}
+	}
+
+	/** @brief Returns the Mapping or NULL if this reference is empty.*/
+	M* get() const { return shared ? shared->mapping : NULL; }
+
+	/** @brief Returns true if other references to the Mapping exist.*/
+	bool isShared() const { return shared && shared->refs > 1; }
+
+	void swap(SharedMappingRef& o) { std::swap(shared, o.shared); }
+};
+
 /**
  * @brief The signal class stores the physical representation of the
  * signal of an AirFrame.
@@ -21,7 +93,8 @@
  * at (NOT relative to the start time of the signal).
  *
  * The Signal is created at the senders MAC layer which has to define
- * the TX-power- and the bitrate Mapping.
+ * the TX-power- and the bitrate Mapping. Both are shared by all copies of
+ * the Signal (one per receiver), only the attenuations are per copy.
  * Sending start time and duration is added at the sender's physical layer.
  * Attenuation Mappings are added to the Signal by the
  * AnalogueModels of the receiver's physical layer.
@@ -57,21 +130,31 @@ protected:
 	/** @brief The propagation delay of the transmission. */
 	simtime_t propagationDelay;
 
-	/** @brief Stores the function which describes the power of the signal*/
-	ConstMapping* power;
+	/** @brief Stores the function which describes the power of the signal,
+	 * shared by all copies of the signal.*/
+	SharedMappingRef<ConstMapping> power;
 
-	/** @brief Stores the function which describes the bitrate of the signal*/
-	Mapping* bitrate;
+	/** @brief Stores the function which describes the (undelayed) bitrate of
+	 * the signal, shared by all copies of the signal.*/
+	SharedMappingRef<Mapping> bitrate;
 
-	/** @brief If propagation delay is not zero this stores the undelayed bitrate*/
-	Mapping* txBitrate;
+	/** @brief If propagation delay is not zero this stores the delayed bitrate*/
+	Mapping* rcvBitrate;
 
 	/** @brief Stores the functions describing the attenuations of the signal*/
 	ConstMappingList attenuations;
 
+	/** @brief The attenuations which are not constant (subset of attenuations).*/
+	ConstMappingList variableAttenuations;
+
+	/** @brief Product of all constant attenuations of the signal.*/
+	Argument::mapped_type attenuationFactor;
+
 	/** @brief Stores the mapping defining the receiving power of the signal.
 	 *
 	 * Will be only calculated on access (thats why it is mutable).
+	 * Its reference mapping is the (delayed) transmission power scaled by
+	 * the attenuationFactor, only the variable attenuations are concatenated.
 	 */
 	mutable MultipliedMapping* rcvPower;
 
@@ -84,10 +167,13 @@ protected:
 	 */
 	void markRcvPowerOutdated() {
 		if(rcvPower){
+			ScaledConstMapping* scaledPower = static_cast<ScaledConstMapping*>(rcvPower->getRefMapping());
+
 			if(propagationDelay != 0) {
-				assert(rcvPower->getRefMapping() != power);
-				delete rcvPower->getRefMapping();
+				assert(scaledPower->getRefMapping() != power.get());
+				delete scaledPower->getRefMapping();
 			}
+			delete scaledPower;
 			delete rcvPower;
 			rcvPower = 0;
 		}
@@ -101,13 +187,15 @@ public:
 
 	/**
 	 * @brief Overwrites the copy constructor to make sure that the
-	 * mappings are cloned correct.
+	 * attenuations are cloned and the transmission power and bitrate
+	 * are shared correct.
 	 */
 	Signal(const Signal& o);
 
 	/**
 	 * @brief Overwrites the copy operator to make sure that the
-	 * mappings are cloned correct.
+	 * attenuations are cloned and the transmission power and bitrate
+	 * are shared correct.
 	 */
 	Signal& operator=(const Signal& o);
 
@@ -171,41 +259,40 @@ public:
 	 * @brief Sets the function representing the transmission power
 	 * of the signal.
 	 *
-	 * The ownership of the passed pointer goes to the signal.
+	 * The ownership of the passed pointer goes to the signal. Copies of
+	 * the signal made before keep the previous transmission power.
 	 */
 	void setTransmissionPower(ConstMapping* power);
 
 	/**
 	 * @brief Sets the function representing the bitrate of the signal.
 	 *
-	 * The ownership of the passed pointer goes to the signal.
+	 * The ownership of the passed pointer goes to the signal. Copies of
+	 * the signal made before keep the previous bitrate.
 	 */
 	void setBitrate(Mapping* bitrate);
 
 	/**
 	 * @brief Adds a function representing an attenuation of the signal.
 	 *
+	 * Constant attenuations (ConstantSimpleConstMapping) are folded into
+	 * a single attenuation factor instead of being concatenated to the
+	 * receiving power mapping.
+	 *
 	 * The ownership of the passed pointer goes to the signal.
 	 */
-	void addAttenuation(ConstMapping* att) {
-		//assert the attenuation wasn't already added to the list before
-		assert(std::find(attenuations.begin(), attenuations.end(), att) == attenuations.end());
-
-		attenuations.push_back(att);
-
-		if(rcvPower)
-			rcvPower->addMapping(att);
-	}
+	void addAttenuation(ConstMapping* att);
 
 	/**
 	 * @brief Returns the function representing the transmission power
 	 * of the signal.
 	 *
 	 * Be aware that the transmission power mapping is not yet affected
-	 * by the propagation delay!
+	 * by the propagation delay! The mapping is shared with the copies
+	 * of this signal, use setTransmissionPower() to change it.
 	 */
 	ConstMapping* getTransmissionPower() {
-		return power;
+		return power.get();
 	}
 
 	/**
@@ -216,7 +303,7 @@ public:
 	 * by the propagation delay!
 	 */
 	const ConstMapping* getTransmissionPower() const {
-		return power;
+		return power.get();
 	}
 
 	/**
@@ -224,7 +311,7 @@ public:
 	 * signal.
 	 */
 	const Mapping* getBitrate() const {
-		return bitrate;
+		return rcvBitrate ? rcvBitrate : bitrate.get();
 	}
 
 	/**
@@ -235,6 +322,23 @@ public:
 		return attenuations;
 	}
 
+	/**
+	 * @brief Returns true if all attenuations of the signal are constant.
+	 *
+	 * The receiving power is then the transmission power multiplied with
+	 * getAttenuationFactor().
+	 */
+	bool hasConstantAttenuation() const {
+		return variableAttenuations.empty();
+	}
+
+	/**
+	 * @brief Returns the product of all constant attenuations of the signal.
+	 */
+	Argument::mapped_type_cref getAttenuationFactor() const {
+		return attenuationFactor;
+	}
+
 	/**
 	 * @brief Calculates and returns the receiving power of this Signal.
 	 * Ownership of the returned mapping belongs to this class.
@@ -245,15 +349,15 @@ public:
 	const MultipliedMapping* getReceivingPower() const {
 		if(!rcvPower)
 		{
-			ConstMapping* tmp = power;
+			ConstMapping* tmp = power.get();
 			if(propagationDelay != 0) {
-				tmp = new ConstDelayedMapping(power, propagationDelay);
-				// tmp will be deleted in ~Signal(), where rcvPower->getRefMapping()
-				// will be used for accessing this pointer
+				tmp = new ConstDelayedMapping(power.get(), propagationDelay);
+				// tmp will be deleted in markRcvPowerOutdated(), where the
+				// reference mapping of rcvPower will be used for accessing this pointer
 			}
-			rcvPower = new MultipliedMapping( tmp
-			                                , attenuations.begin()
-			                                , attenuations.end()
+			rcvPower = new MultipliedMapping( new ScaledConstMapping(tmp, attenuationFactor)
+			                                , variableAttenuations.begin()
+			                                , variableAttenuations.end()
 			                                , false
 			                                , Argument::MappedZero );
 		}
@@ -261,6 +365,25 @@ public:
 		return rcvPower;
 	}
 
+	/**
+	 * @brief Returns the receiving power of this Signal at the passed position.
+	 *
+	 * If all attenuations are constant the value is calculated directly
+	 * from the transmission power without creating the receiving power
+	 * mapping.
+	 */
+	Argument::mapped_type getReceivingPower(const Argument& pos) const {
+		if(!hasConstantAttenuation())
+			return getReceivingPower()->getValue(pos);
+
+		if(propagationDelay == 0)
+			return power.get()->getValue(pos) * attenuationFactor;
+
+		Argument txPos(pos);
+		txPos.setTime(pos.getTime() - propagationDelay);
+		return power.get()->getValue(txPos) * attenuationFactor;
+	}
+
 	/**
 	 * Returns a pointer to the arrival module. It returns NULL if the signal
 	 * has not been sent/received yet, or if the module was deleted
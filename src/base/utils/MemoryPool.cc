@@ -0,0 +1,68 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "MemoryPool.h"
+
+#include <new>
+
+const size_t MemoryPool::GRANULARITY;
+const size_t MemoryPool::MAX_SIZE;
+const size_t MemoryPool::CHUNK_SIZE;
+const size_t MemoryPool::NUM_CLASSES;
+
+MemoryPool::MemoryPool(const char* name)
+	: name(name)
+	, chunks()
+	, chunkPos(NULL)
+	, chunkLeft(0)
+	, requests(0)
+	, hits(0)
+	, live(0)
+	, peakLive(0)
+{
+	for(size_t i = 0; i < NUM_CLASSES; ++i)
+		freeLists[i] = NULL;
+}
+
+MemoryPool::~MemoryPool()
+{
+	for(std::vector<char*>::iterator it = chunks.begin(); it != chunks.end(); ++it)
+		::operator delete(*it);
+}
+
+void* MemoryPool::allocateFromChunk(size_t cls)
+{
+	const size_t size = (cls + 1) * GRANULARITY;
+
+	if(chunkLeft < size) {
+		// put the rest of the current chunk into the free list of its size
+		// class so it does not get lost
+		if(chunkLeft >= GRANULARITY) {
+			const size_t restCls = chunkLeft / GRANULARITY - 1;
+			FreeNode*    node    = reinterpret_cast<FreeNode*>(chunkPos);
+			node->next = freeLists[restCls];
+			freeLists[restCls] = node;
+		}
+
+		chunkPos  = static_cast<char*>(::operator new(CHUNK_SIZE));
+		chunkLeft = CHUNK_SIZE;
+		chunks.push_back(chunkPos);
+	}
+
+	void* p = chunkPos;
+	chunkPos  += size;
+	chunkLeft -= size;
+	return p;
+}
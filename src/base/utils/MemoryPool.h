@@ -0,0 +1,178 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef MEMORYPOOL_H_
+#define MEMORYPOOL_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "MiXiMDefs.h"
+
+/**
+ * @brief Free list allocator for small objects which are created and
+ * deleted at a high rate, like AirFrames and Mappings.
+ *
+ * Memory is taken from large arena chunks and sorted into size classes of
+ * 16 bytes. Released memory is kept in a free list per size class and
+ * handed out again on the next request of the same size class, so memory
+ * is never returned to the system. Requests larger than the biggest size
+ * class are passed through to the global operator new.
+ *
+ * Classes use a pool by overriding their class specific operator new and
+ * delete, see MiximAirFrame and ConstMapping.
+ */
+class MIXIM_API MemoryPool {
+public:
+	/** @brief Granularity of the size classes in bytes.*/
+	static const size_t GRANULARITY    = 16;
+	/** @brief Biggest object size served from the pool in bytes.*/
+	static const size_t MAX_SIZE       = 1024;
+	/** @brief Size of an arena chunk in bytes.*/
+	static const size_t CHUNK_SIZE     = 64 * 1024;
+
+protected:
+	/** @brief Number of size classes.*/
+	static const size_t NUM_CLASSES    = MAX_SIZE / GRANULARITY;
+
+	/** @brief Node of the free lists, stored inside the released memory.*/
+	struct FreeNode {
+		FreeNode* next;
+	};
+
+	/** @brief Name of the pool used for statistics.*/
+	const char*         name;
+
+	/** @brief Free lists of released memory per size class.*/
+	FreeNode*           freeLists[NUM_CLASSES];
+
+	/** @brief All arena chunks allocated so far.*/
+	std::vector<char*>  chunks;
+
+	/** @brief Next unused byte in the current arena chunk.*/
+	char*               chunkPos;
+
+	/** @brief Number of unused bytes in the current arena chunk.*/
+	size_t              chunkLeft;
+
+	/** @brief Number of allocation requests since the last reset.*/
+	unsigned long       requests;
+
+	/** @brief Number of requests served from a free list since the last reset.*/
+	unsigned long       hits;
+
+	/** @brief Number of currently allocated objects.*/
+	unsigned long       live;
+
+	/** @brief Maximum number of allocated objects since the last reset.*/
+	unsigned long       peakLive;
+
+private:
+	/** @brief Copy constructor is not allowed.*/
+	MemoryPool(const MemoryPool&);
+	/** @brief Assignment operator is not allowed.*/
+	MemoryPool& operator=(const MemoryPool&);
+
+protected:
+	/** @brief Returns the size class index for the passed size.*/
+	static size_t sizeClass(size_t size) {
+		return (size + GRANULARITY - 1) / GRANULARITY - 1;
+	}
+
+	/** @brief Takes memory for the passed size class from the arena.*/
+	void* allocateFromChunk(size_t cls);
+
+public:
+	/** @brief Creates an empty pool with the passed name.*/
+	MemoryPool(const char* name);
+
+	/** @brief Frees all arena chunks.*/
+	~MemoryPool();
+
+	/** @brief Returns memory for an object of the passed size.*/
+	void* allocate(size_t size) {
+		++requests;
+		if(++live > peakLive)
+			peakLive = live;
+
+		if(size == 0 || size > MAX_SIZE)
+			return ::operator new(size);
+
+		const size_t cls  = sizeClass(size);
+		FreeNode*    node = freeLists[cls];
+		if(node) {
+			++hits;
+			freeLists[cls] = node->next;
+			return node;
+		}
+		return allocateFromChunk(cls);
+	}
+
+	/**
+	 * @brief Releases the memory of an object of the passed size which has
+	 * been allocated by this pool.
+	 */
+	void release(void* p, size_t size) {
+		if(!p)
+			return;
+
+		--live;
+		if(size == 0 || size > MAX_SIZE) {
+			::operator delete(p);
+			return;
+		}
+
+		FreeNode* node = static_cast<FreeNode*>(p);
+		const size_t cls = sizeClass(size);
+		node->next = freeLists[cls];
+		freeLists[cls] = node;
+	}
+
+	/** @brief Returns the name of this pool.*/
+	const char* getName() const { return name; }
+
+	/** @brief Returns the number of allocation requests since the last reset.*/
+	unsigned long getRequests() const { return requests; }
+
+	/** @brief Returns the number of requests served from released memory.*/
+	unsigned long getHits() const { return hits; }
+
+	/** @brief Returns the fraction of requests served from released memory.*/
+	double getHitRate() const {
+		return requests == 0 ? 0.0 : static_cast<double>(hits) / requests;
+	}
+
+	/** @brief Returns the number of currently allocated objects.*/
+	unsigned long getLive() const { return live; }
+
+	/** @brief Returns the peak number of allocated objects since the last reset.*/
+	unsigned long getPeakLive() const { return peakLive; }
+
+	/** @brief Returns the number of bytes allocated for arena chunks.*/
+	size_t getReservedBytes() const { return chunks.size() * CHUNK_SIZE; }
+
+	/**
+	 * @brief Resets the statistics, for example at the start of a new run.
+	 *
+	 * The peak is reset to the number of objects still alive.
+	 */
+	void resetStatistics() {
+		requests = 0;
+		hits     = 0;
+		peakLive = live;
+	}
+};
+
+#endif /* MEMORYPOOL_H_ */
@@ -16,21 +16,27 @@
 //
 
 
-#include <fstream>
-#include <sstream>
-
 #include "BonnMotionFileCache.h"
 
 
 const BonnMotionFile::Line *BonnMotionFile::getLine(int nodeId) const
 {
-    LineList::const_iterator it = lines.begin();
-    for (int i=0; i<nodeId && it!=lines.end(); i++) it++;
-    return (it==lines.end()) ? NULL : &(*it);
+    return (nodeId < 0 || nodeId >= (int)lines.size()) ? NULL : &lines[nodeId];
 }
 
 
 BonnMotionFileCache *BonnMotionFileCache::inst;
+int BonnMotionFileCache::users;
+
+BonnMotionFileCache::BonnMotionFileCache()
+{
+    WaypointTraceCache::acquireInstance();
+}
+
+BonnMotionFileCache::~BonnMotionFileCache()
+{
+    WaypointTraceCache::releaseInstance();
+}
 
 BonnMotionFileCache *BonnMotionFileCache::getInstance()
 {
@@ -39,16 +45,22 @@ BonnMotionFileCache *BonnMotionFileCache::getInstance()
     return inst;
 }
 
-void BonnMotionFileCache::deleteInstance()
+BonnMotionFileCache *BonnMotionFileCache::acquireInstance()
 {
-    if (inst)
+    users++;
+    return getInstance();
+}
+
+void BonnMotionFileCache::releaseInstance()
+{
+    if (users > 0 && --users == 0 && inst)
     {
         delete inst;
         inst = NULL;
     }
 }
 
-const BonnMotionFile *BonnMotionFileCache::getFile(const char *filename)
+const BonnMotionFile *BonnMotionFileCache::getFile(const char *filename, const char *binaryFile)
 {
     // if found, return it from cache
     BMFileMap::iterator it = cache.find(std::string(filename));
@@ -57,26 +69,16 @@ const BonnMotionFile *BonnMotionFileCache::getFile(const char *filename)
 
     // load and store in cache
     BonnMotionFile& bmFile = cache[filename];
-    parseFile(filename, bmFile);
+    parseFile(filename, bmFile, binaryFile);
     return &bmFile;
 }
 
-void BonnMotionFileCache::parseFile(const char *filename, BonnMotionFile& bmFile)
+void BonnMotionFileCache::parseFile(const char *filename, BonnMotionFile& bmFile, const char *binaryFile)
 {
-    std::ifstream in(filename, std::ios::in);
-    if (in.fail())
-        throw cRuntimeError("Cannot open file '%s'", filename);
+    const WaypointTraceFile *trace = WaypointTraceCache::getInstance()->getFile(filename, WaypointTraceFile::BONNMOTION, binaryFile);
 
-    std::string line;
-    while (std::getline(in, line))
-    {
-        bmFile.lines.push_back(BonnMotionFile::Line());
-        BonnMotionFile::Line& vec = bmFile.lines.back();
-
-        std::stringstream linestream(line);
-        double d;
-        while (linestream >> d)
-            vec.push_back(d);
-    }
-    in.close();
+    // the lines only point into the trace, nothing is copied
+    bmFile.lines.resize(trace->getNumNodes());
+    for (size_t i = 0; i < bmFile.lines.size(); i++)
+        bmFile.lines[i] = trace->getNode(i);
 }
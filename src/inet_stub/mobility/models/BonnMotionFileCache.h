@@ -19,25 +19,27 @@
 #ifndef BONN_MOTION_FILE_CACHE_H
 #define BONN_MOTION_FILE_CACHE_H
 
-#include <list>
 #include <vector>
 
 #include "INETDefs.h"
 
+#include "WaypointTraceFile.h"
+
 
 class BonnMotionFileCache;
 
 /**
- * Represents a BonnMotion file's contents.
+ * Represents a BonnMotion file's contents. The lines point into the
+ * WaypointTraceFile holding the file.
  * @see BonnMotionFileCache, BonnMotionMobility
  */
 class INET_API BonnMotionFile
 {
   public:
-    typedef std::vector<double> Line;
+    typedef WaypointTraceFile::Values Line;
   protected:
     friend class BonnMotionFileCache;
-    typedef std::list<Line> LineList;
+    typedef std::vector<Line> LineList;
     LineList lines;
   public:
     const Line *getLine(int nodeId) const;
@@ -49,6 +51,10 @@ class INET_API BonnMotionFile
  * BonnMotionMobility.  Needed because otherwise every node would
  * have to open and read the file independently.
  *
+ * Like WaypointTraceCache, the instance is reference counted by its
+ * users, and it holds a reference to the WaypointTraceCache its lines
+ * point into.
+ *
  * @ingroup mobility
  * @author Andras Varga
  */
@@ -58,25 +64,35 @@ class INET_API BonnMotionFileCache
     typedef std::map<std::string,BonnMotionFile> BMFileMap;
     BMFileMap cache;
     static BonnMotionFileCache *inst;
-    void parseFile(const char *filename, BonnMotionFile& bmFile);
-    BonnMotionFileCache() {}
-    virtual ~BonnMotionFileCache() {}
+    static int users;
+    void parseFile(const char *filename, BonnMotionFile& bmFile, const char *binaryFile);
+    BonnMotionFileCache();
+    virtual ~BonnMotionFileCache();
 
   public:
     /**
-     * Returns the singleton instance.
+     * Returns the singleton instance. Only valid while the caller holds a
+     * reference, see acquireInstance().
      */
     static BonnMotionFileCache *getInstance();
 
     /**
-     * Deletes the singleton instance.
+     * Returns the singleton instance and counts the caller as one of its
+     * users. Every call has to be paired with a releaseInstance().
+     */
+    static BonnMotionFileCache *acquireInstance();
+
+    /**
+     * Releases a reference obtained by acquireInstance(). Deletes the
+     * singleton instance when the last user releases it.
      */
-    static void deleteInstance();
+    static void releaseInstance();
 
     /**
-     * Returns the given document.
+     * Returns the given document. If binaryFile is not empty, it is read
+     * from there instead, see WaypointTraceCache::getFile().
      */
-    virtual const BonnMotionFile *getFile(const char *filename);
+    virtual const BonnMotionFile *getFile(const char *filename, const char *binaryFile = "");
 };
 
 #endif
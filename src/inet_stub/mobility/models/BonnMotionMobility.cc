@@ -29,11 +29,12 @@ BonnMotionMobility::BonnMotionMobility()
     is3D = false;
     lines = NULL;
     currentLine = -1;
+    BonnMotionFileCache::acquireInstance();
 }
 
 BonnMotionMobility::~BonnMotionMobility()
 {
-    BonnMotionFileCache::deleteInstance();
+    BonnMotionFileCache::releaseInstance();
 }
 
 void BonnMotionMobility::initialize(int stage)
@@ -47,7 +48,8 @@ void BonnMotionMobility::initialize(int stage)
         if (nodeId == -1)
             nodeId = getParentModule()->getIndex();
         const char *fname = par("traceFile");
-        const BonnMotionFile *bmFile = BonnMotionFileCache::getInstance()->getFile(fname);
+        const char *bname = par("binaryTraceFile");
+        const BonnMotionFile *bmFile = BonnMotionFileCache::getInstance()->getFile(fname, bname);
         lines = bmFile->getLine(nodeId);
         if (!lines)
             throw cRuntimeError("Invalid nodeId %d -- no such line in file '%s'", nodeId, fname);
@@ -18,17 +18,9 @@
 //
 
 
-#include <fstream>
-#include <sstream>
-#include <string>
-
 #include "Ns2MotionMobility.h"
 #include "FWMath.h"
 
-#ifndef atoi
-#include <cstdlib>
-#endif
-
 
 Define_Module(Ns2MotionMobility);
 
@@ -36,94 +28,15 @@ Define_Module(Ns2MotionMobility);
 Ns2MotionMobility::Ns2MotionMobility()
 {
     vecpos = 0;
-    ns2File = NULL;
     nodeId = 0;
     scrollX = 0;
     scrollY = 0;
+    WaypointTraceCache::acquireInstance();
 }
 
 Ns2MotionMobility::~Ns2MotionMobility()
 {
-    if (ns2File)
-        delete ns2File;
-}
-
-void Ns2MotionMobility::parseFile(const char *filename)
-{
-
-    std::ifstream in(filename, std::ios::in);
-
-    if (in.fail())
-        throw cRuntimeError("Cannot open file '%s'", filename);
-    ns2File->initial[0] = ns2File->initial[1] = ns2File->initial[2] = -1;
-    std::string line;
-    std::string subline;
-
-    while (std::getline(in, line))
-    {
-        // '#' line
-        int num_node;
-        std::string::size_type found = line.find('#');
-        if (found == 0)
-            continue;
-        if (found != std::string::npos)
-            subline = line;
-        else
-            subline = line.substr(0, found);
-        found = subline.find("$node_");
-        if (found == std::string::npos)
-            continue;
-        // Node Id
-        std::string::size_type pos1 = subline.find('(');
-        std::string::size_type pos2 = subline.find(')');
-        if (pos2-pos1>1)
-            num_node = std::atoi(subline.substr(pos1+1, pos2-1).c_str());
-        if (num_node!=nodeId)
-            continue;
-        // Initial position
-        found = subline.find("set ");
-        if (found!=std::string::npos)
-        {
-            // Initial position
-            found = subline.find("X_");
-            if (found!=std::string::npos)
-            {
-                ns2File->initial[0] = std::atof(subline.substr(found+3, std::string::npos).c_str());
-            }
-            found = subline.find("Y_");
-            if (found!=std::string::npos)
-            {
-                ns2File->initial[1] = std::atof(subline.substr(found+3, std::string::npos).c_str());
-            }
-
-            found = subline.find("Z_");
-            if (found!=std::string::npos)
-            {
-                ns2File->initial[2] = std::atof(subline.substr(found+3, std::string::npos).c_str());
-            }
-        }
-        found = subline.find("setdest");
-        if (found!=std::string::npos)
-        {
-            ns2File->lines.push_back(Ns2MotionFile::Line());
-            Ns2MotionFile::Line& vec = ns2File->lines.back();
-            // initial time
-            found = subline.find("at");
-            vec.push_back(std::atof(subline.substr(found+3).c_str()));
-
-            std::string parameters = subline.substr(subline.find("setdest ")+8, std::string::npos);
-
-            std::stringstream linestream(parameters);
-            double d;
-            while (linestream >> d)
-                vec.push_back(d);
-        }
-    }
-    in.close();
-    // exist data?
-    if (ns2File->initial[0]==-1 || ns2File->initial[1]==-1 || ns2File->initial[2]==-1)
-        throw cRuntimeError("node '%d' Error ns2 motion file '%s'", nodeId, filename);
-
+    WaypointTraceCache::releaseInstance();
 }
 
 void Ns2MotionMobility::initialize(int stage)
@@ -138,8 +51,12 @@ void Ns2MotionMobility::initialize(int stage)
         if (nodeId == -1)
             nodeId = getParentModule()->getIndex();
         const char *fname = par("traceFile");
-        ns2File = new Ns2MotionFile;
-        parseFile(fname);
+        const char *bname = par("binaryTraceFile");
+        const WaypointTraceFile *trace = WaypointTraceCache::getInstance()->getFile(fname, WaypointTraceFile::NS2, bname);
+        waypoints = trace->getNode(nodeId);
+        // exist data?
+        if (waypoints.size() < 3 || waypoints[0]==-1 || waypoints[1]==-1 || waypoints[2]==-1)
+            throw cRuntimeError("node '%d' Error ns2 motion file '%s'", nodeId, fname);
         vecpos = 0;
         WATCH(nodeId);
     }
@@ -147,33 +64,19 @@ void Ns2MotionMobility::initialize(int stage)
 
 void Ns2MotionMobility::initializePosition()
 {
-    lastPosition.x = ns2File->initial[0]+scrollX;
-    lastPosition.y = ns2File->initial[1]+scrollY;
+    lastPosition.x = waypoints[0]+scrollX;
+    lastPosition.y = waypoints[1]+scrollY;
 }
 
 void Ns2MotionMobility::setTargetPosition()
 {
-
-    if (ns2File->lines.size()==0)
-    {
-        stationary = true;
-        return;
-    }
-
-    if (vecpos >= ns2File->lines.size())
+    if (vecpos >= getNumLines())
     {
         stationary = true;
         return;
     }
 
-
-    if (ns2File->lines.begin()+vecpos == ns2File->lines.end())
-    {
-        stationary = true;
-        return;
-    }
-
-    const Ns2MotionFile::Line& vec = ns2File->lines[vecpos];
+    const double *vec = getLine(vecpos);
     double time = vec[0];
     simtime_t now = simTime();
     // TODO: this code is dubious at best
@@ -184,7 +87,12 @@ void Ns2MotionMobility::setTargetPosition()
     }
     else if (vec[3] == 0) // the node is stopped
     {
-        const Ns2MotionFile::Line& vec = ns2File->lines[vecpos+1];
+        if (vecpos + 1 >= getNumLines())
+        {
+            stationary = true;
+            return;
+        }
+        const double *vec = getLine(vecpos+1);
         double time = vec[0];
         nextChange = time;
         targetPosition = lastPosition;
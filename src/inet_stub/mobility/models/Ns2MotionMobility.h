@@ -24,43 +24,34 @@
 #include "INETDefs.h"
 
 #include "LineSegmentsMobilityBase.h"
+#include "WaypointTraceFile.h"
 
 
 /**
  * @brief Uses the ns2 motion native file format. See NED file for more info.
  *
+ * The file is shared by all nodes, see WaypointTraceCache.
+ *
  * @ingroup mobility
  * @author Alfonso Ariza
  */
-
-class Ns2MotionMobility;
-
-/**
- * Represents a ns2 motion file's contents.
- */
-class INET_API Ns2MotionFile
-{
-  public:
-    typedef std::vector<double> Line;
-    double initial[3];
-  protected:
-    friend class Ns2MotionMobility;
-    typedef std::vector<Line> LineList;
-    LineList lines;
-};
-
 class INET_API Ns2MotionMobility : public LineSegmentsMobilityBase
 {
   protected:
     // state
     unsigned int vecpos;
-    Ns2MotionFile *ns2File;
+    /** Initial position followed by the setdest commands, see WaypointTraceFile */
+    WaypointTraceFile::Values waypoints;
     int nodeId;
     double scrollX;
     double scrollY;
 
   protected:
-    void parseFile(const char *filename);
+    /** Returns the number of setdest commands of the node. */
+    unsigned int getNumLines() const { return (waypoints.size() - 3) / 4; }
+
+    /** Returns the t x y speed tuple of a setdest command. */
+    const double *getLine(unsigned int i) const { return &waypoints[3 + 4 * i]; }
 
     /** @brief Initializes mobility model parameters.*/
     virtual void initialize(int stage);
@@ -0,0 +1,371 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "WaypointTraceFile.h"
+
+
+namespace {
+
+const char MAGIC[8] = { 'W', 'A', 'Y', 'P', 'T', 'R', 'C', '1' };
+const uint32 BYTE_ORDER_MARK = 0x01020304;
+
+struct Header
+{
+    char magic[8];
+    uint32 byteOrder;
+    uint32 format;
+    uint64 numNodes;
+};
+
+/** Appends the numbers at the start of str to vec, returns how many were found */
+size_t parseNumbers(const char *str, std::vector<double>& vec)
+{
+    size_t n = 0;
+    char *end;
+    for (double d = strtod(str, &end); end != str; d = strtod(str, &end), n++)
+    {
+        vec.push_back(d);
+        str = end;
+    }
+    return n;
+}
+
+}
+
+
+WaypointTraceFile::WaypointTraceFile()
+{
+    format = BONNMOTION;
+    numNodes = 0;
+    offsets = NULL;
+    values = NULL;
+    mapping = NULL;
+    mappingSize = 0;
+    useOwnStorage();
+}
+
+WaypointTraceFile::~WaypointTraceFile()
+{
+    close();
+}
+
+void WaypointTraceFile::close()
+{
+#ifndef _WIN32
+    if (mapping)
+        munmap(mapping, mappingSize);
+#endif
+    mapping = NULL;
+    mappingSize = 0;
+    std::vector<uint64>().swap(buffer);
+}
+
+void WaypointTraceFile::useOwnStorage()
+{
+    if (ownOffsets.empty())
+        ownOffsets.push_back(0);
+    numNodes = ownOffsets.size() - 1;
+    offsets = &ownOffsets[0];
+    values = ownValues.empty() ? NULL : &ownValues[0];
+}
+
+bool WaypointTraceFile::isBinary(const char *filename)
+{
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    return in.read(magic, sizeof(magic)) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void WaypointTraceFile::load(const char *filename, Format textFormat)
+{
+    close();
+    ownOffsets.assign(1, 0);
+    ownValues.clear();
+
+    if (!isBinary(filename))
+    {
+        format = textFormat;
+        if (textFormat == NS2)
+            parseNs2(filename);
+        else
+            parseBonnMotion(filename);
+        useOwnStorage();
+        return;
+    }
+
+#ifndef _WIN32
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void *data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            mapping = data;
+            mappingSize = st.st_size;
+        }
+    }
+    if (fd >= 0)
+        ::close(fd);
+    if (mapping)
+    {
+        setBinary(mapping, mappingSize, filename);
+        return;
+    }
+#endif
+
+    // mapping is not available, read the file into an aligned buffer instead
+    std::ifstream in(filename, std::ios::in | std::ios::binary);
+    in.seekg(0, std::ios::end);
+    size_t size = in.tellg();
+    in.seekg(0, std::ios::beg);
+    buffer.resize((size + sizeof(uint64) - 1) / sizeof(uint64));
+    if (size == 0 || !in.read(reinterpret_cast<char *>(&buffer[0]), size))
+        throw cRuntimeError("Cannot read file '%s'", filename);
+    setBinary(&buffer[0], size, filename);
+}
+
+void WaypointTraceFile::setBinary(const void *data, size_t size, const char *filename)
+{
+    const Header *header = static_cast<const Header *>(data);
+    if (size < sizeof(Header) || memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0)
+        throw cRuntimeError("'%s' is not a binary waypoint trace", filename);
+    if (header->byteOrder != BYTE_ORDER_MARK)
+        throw cRuntimeError("Binary waypoint trace '%s' was written on a machine with a different byte order", filename);
+    if (header->format != BONNMOTION && header->format != NS2)
+        throw cRuntimeError("Binary waypoint trace '%s' has an unknown format", filename);
+
+    const size_t maxNodes = (size - sizeof(Header)) / sizeof(uint64);
+    if (header->numNodes >= maxNodes)
+        throw cRuntimeError("Binary waypoint trace '%s' is truncated", filename);
+
+    format = static_cast<Format>(header->format);
+    numNodes = header->numNodes;
+    offsets = reinterpret_cast<const uint64 *>(header + 1);
+    values = reinterpret_cast<const double *>(offsets + numNodes + 1);
+
+    // only the index is checked, the waypoints are not touched until a node uses them
+    const size_t numValues = (size - sizeof(Header)) / sizeof(uint64) - (numNodes + 1);
+    if (offsets[0] != 0 || offsets[numNodes] != numValues)
+        throw cRuntimeError("Binary waypoint trace '%s' is truncated", filename);
+    for (size_t i = 0; i < numNodes; i++)
+        if (offsets[i] > offsets[i + 1])
+            throw cRuntimeError("Binary waypoint trace '%s' has an invalid index", filename);
+}
+
+void WaypointTraceFile::write(const char *filename) const
+{
+    // write to a private file first, so that runs sharing the trace never see
+    // a partially written file
+    std::ostringstream tmpName;
+    tmpName << filename << ".tmp" << getpid();
+
+    Header header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.format = format;
+    header.numNodes = numNodes;
+
+    std::ofstream out(tmpName.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(offsets), (numNodes + 1) * sizeof(uint64));
+    if (offsets[numNodes] > 0)
+        out.write(reinterpret_cast<const char *>(values), offsets[numNodes] * sizeof(double));
+    out.close();
+    if (out.fail())
+    {
+        remove(tmpName.str().c_str());
+        throw cRuntimeError("Cannot write file '%s'", tmpName.str().c_str());
+    }
+    if (rename(tmpName.str().c_str(), filename) != 0)
+    {
+        // another run may have created it in the meantime
+        remove(tmpName.str().c_str());
+        if (!isBinary(filename))
+            throw cRuntimeError("Cannot write file '%s'", filename);
+    }
+}
+
+void WaypointTraceFile::parseBonnMotion(const char *filename)
+{
+    std::ifstream in(filename, std::ios::in);
+    if (in.fail())
+        throw cRuntimeError("Cannot open file '%s'", filename);
+
+    // every line holds the waypoints of one node
+    std::string line;
+    while (std::getline(in, line))
+    {
+        parseNumbers(line.c_str(), ownValues);
+        ownOffsets.push_back(ownValues.size());
+    }
+    in.close();
+}
+
+void WaypointTraceFile::parseNs2(const char *filename)
+{
+    std::ifstream in(filename, std::ios::in);
+    if (in.fail())
+        throw cRuntimeError("Cannot open file '%s'", filename);
+
+    // the commands of the nodes may be interleaved, collect them per node first
+    std::vector<std::vector<double> > nodes;
+    std::string line;
+    std::string subline;
+    std::vector<double> params;
+
+    while (std::getline(in, line))
+    {
+        // '#' line
+        std::string::size_type found = line.find('#');
+        if (found == 0)
+            continue;
+        if (found == std::string::npos)
+            subline = line;
+        else
+            subline = line.substr(0, found);
+        found = subline.find("$node_");
+        if (found == std::string::npos)
+            continue;
+        // Node Id
+        std::string::size_type pos1 = subline.find('(');
+        std::string::size_type pos2 = subline.find(')');
+        if (pos1 == std::string::npos || pos2 == std::string::npos || pos2 - pos1 <= 1)
+            continue;
+        int num_node = std::atoi(subline.substr(pos1+1, pos2-1).c_str());
+        if (num_node < 0)
+            continue;
+        if ((size_t)num_node >= nodes.size())
+            nodes.resize(num_node + 1);
+        std::vector<double>& vec = nodes[num_node];
+        if (vec.empty())
+            vec.resize(3, -1);
+        // Initial position
+        found = subline.find("set ");
+        if (found!=std::string::npos)
+        {
+            found = subline.find("X_");
+            if (found!=std::string::npos)
+                vec[0] = std::atof(subline.substr(found+3, std::string::npos).c_str());
+            found = subline.find("Y_");
+            if (found!=std::string::npos)
+                vec[1] = std::atof(subline.substr(found+3, std::string::npos).c_str());
+            found = subline.find("Z_");
+            if (found!=std::string::npos)
+                vec[2] = std::atof(subline.substr(found+3, std::string::npos).c_str());
+        }
+        found = subline.find("setdest");
+        if (found!=std::string::npos)
+        {
+            // initial time, then destination x, y and speed
+            found = subline.find("at");
+            double time = std::atof(subline.substr(found+3).c_str());
+            params.clear();
+            found = subline.find("setdest ");
+            if (found == std::string::npos || parseNumbers(subline.c_str() + found + 8, params) < 3)
+                throw cRuntimeError("Invalid setdest command for node %d in ns2 motion file '%s'", num_node, filename);
+            vec.push_back(time);
+            vec.insert(vec.end(), params.begin(), params.begin() + 3);
+        }
+    }
+    in.close();
+
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        ownValues.insert(ownValues.end(), nodes[i].begin(), nodes[i].end());
+        ownOffsets.push_back(ownValues.size());
+    }
+}
+
+
+WaypointTraceCache *WaypointTraceCache::inst;
+int WaypointTraceCache::users;
+
+WaypointTraceCache *WaypointTraceCache::getInstance()
+{
+    if (!inst)
+        inst = new WaypointTraceCache;
+    return inst;
+}
+
+WaypointTraceCache *WaypointTraceCache::acquireInstance()
+{
+    users++;
+    return getInstance();
+}
+
+void WaypointTraceCache::releaseInstance()
+{
+    if (users > 0 && --users == 0 && inst)
+    {
+        delete inst;
+        inst = NULL;
+    }
+}
+
+WaypointTraceCache::~WaypointTraceCache()
+{
+    for (TraceMap::iterator it = cache.begin(); it != cache.end(); ++it)
+        delete it->second;
+}
+
+const WaypointTraceFile *WaypointTraceCache::getFile(const char *traceFile, WaypointTraceFile::Format format, const char *binaryFile)
+{
+    // if found, return it from cache
+    std::string key = *binaryFile ? binaryFile : traceFile;
+    TraceMap::iterator it = cache.find(key);
+    if (it==cache.end())
+    {
+        // load and store in cache
+        WaypointTraceFile *trace = new WaypointTraceFile;
+        try
+        {
+            if (*binaryFile && WaypointTraceFile::isBinary(binaryFile))
+                trace->load(binaryFile, format);
+            else
+            {
+                trace->load(traceFile, format);
+                if (*binaryFile)
+                    trace->write(binaryFile);
+            }
+        }
+        catch (...)
+        {
+            delete trace;
+            throw;
+        }
+        it = cache.insert(std::make_pair(key, trace)).first;
+    }
+    if (it->second->getFormat() != format)
+        throw cRuntimeError("Waypoint trace '%s' has the wrong format", key.c_str());
+    return it->second;
+}
@@ -0,0 +1,180 @@
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//
+
+
+#ifndef WAYPOINT_TRACE_FILE_H
+#define WAYPOINT_TRACE_FILE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "INETDefs.h"
+
+
+/**
+ * Waypoints of all nodes of a mobility trace, stored as one flat array of
+ * doubles per node.
+ *
+ * The trace can be read from the BonnMotion and ns2 text formats, or from a
+ * compact binary format which is mapped into memory: nodes then only access
+ * their own part of the file, and the waypoints are used where they are
+ * without being parsed or copied. write() converts a text trace into the
+ * binary format.
+ *
+ * Node records:
+ *  - BONNMOTION: the numbers of the node's line, i.e. t x y [z] tuples.
+ *  - NS2: the initial x, y and z position (-1 if not set), followed by a
+ *    t x y speed tuple for every setdest command.
+ *
+ * Binary layout, in the byte order of the writing machine:
+ * @verbatim
+ *   char   magic[8]                 "WAYPTRC1"
+ *   uint32 byteOrder                0x01020304
+ *   uint32 format                   BONNMOTION or NS2
+ *   uint64 numNodes
+ *   uint64 offsets[numNodes + 1]    first value of every node, in doubles
+ *   double values[offsets[numNodes]]
+ * @endverbatim
+ *
+ * @see WaypointTraceCache, BonnMotionMobility, Ns2MotionMobility
+ * @ingroup mobility
+ */
+class INET_API WaypointTraceFile
+{
+  public:
+    enum Format {
+        BONNMOTION = 1,
+        NS2 = 2
+    };
+
+    /** The waypoint values of one node, pointing into the trace. */
+    class Values
+    {
+      protected:
+        const double *values;
+        size_t count;
+      public:
+        Values() : values(NULL), count(0) {}
+        Values(const double *values, size_t count) : values(values), count(count) {}
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        const double& operator[](size_t i) const { return values[i]; }
+    };
+
+  protected:
+    Format format;
+    size_t numNodes;
+    const uint64 *offsets;
+    const double *values;
+
+    /** Mapped binary file, if any */
+    void *mapping;
+    size_t mappingSize;
+
+    /** Storage of a parsed text trace, or of a binary file which could not be mapped */
+    std::vector<uint64> ownOffsets;
+    std::vector<double> ownValues;
+    std::vector<uint64> buffer;
+
+  private:
+    WaypointTraceFile(const WaypointTraceFile&);
+    WaypointTraceFile& operator=(const WaypointTraceFile&);
+
+  protected:
+    void close();
+    void useOwnStorage();
+    void parseBonnMotion(const char *filename);
+    void parseNs2(const char *filename);
+    void setBinary(const void *data, size_t size, const char *filename);
+
+  public:
+    WaypointTraceFile();
+    virtual ~WaypointTraceFile();
+
+    /** Returns true if the file exists and starts like a binary waypoint trace. */
+    static bool isBinary(const char *filename);
+
+    /**
+     * Loads a trace file. Binary files are mapped into memory, other files
+     * are parsed as text in the given format.
+     */
+    void load(const char *filename, Format textFormat);
+
+    /** Writes the trace in the binary format. */
+    void write(const char *filename) const;
+
+    Format getFormat() const { return format; }
+    size_t getNumNodes() const { return numNodes; }
+
+    /** Returns the waypoints of a node, empty for unknown nodes. */
+    Values getNode(int nodeId) const {
+        if (nodeId < 0 || (size_t)nodeId >= numNodes)
+            return Values();
+        return Values(values + offsets[nodeId], offsets[nodeId + 1] - offsets[nodeId]);
+    }
+};
+
+
+/**
+ * Singleton object to load and store waypoint traces, so that all nodes
+ * share one copy of a trace file.
+ *
+ * The users of the traces hold a reference to the instance, see
+ * acquireInstance(). The traces stay loaded until the last user has
+ * released it, so nodes which are deleted during the simulation do not
+ * take the traces of the remaining nodes with them.
+ *
+ * @ingroup mobility
+ */
+class INET_API WaypointTraceCache
+{
+  protected:
+    typedef std::map<std::string,WaypointTraceFile*> TraceMap;
+    TraceMap cache;
+    static WaypointTraceCache *inst;
+    static int users;
+    WaypointTraceCache() {}
+    virtual ~WaypointTraceCache();
+
+  public:
+    /**
+     * Returns the singleton instance. Only valid while the caller holds a
+     * reference, see acquireInstance().
+     */
+    static WaypointTraceCache *getInstance();
+
+    /**
+     * Returns the singleton instance and counts the caller as one of its
+     * users. Every call has to be paired with a releaseInstance().
+     */
+    static WaypointTraceCache *acquireInstance();
+
+    /**
+     * Releases a reference obtained by acquireInstance(). Deletes the
+     * singleton instance together with all traces when the last user
+     * releases it.
+     */
+    static void releaseInstance();
+
+    /**
+     * Returns the given trace. If binaryFile is not empty, the trace is
+     * read from there; if it does not exist yet, it is created from
+     * traceFile first.
+     */
+    virtual const WaypointTraceFile *getFile(const char *traceFile, WaypointTraceFile::Format format, const char *binaryFile = "");
+};
+
+#endif
@@ -93,9 +93,7 @@ bool BreakpointPathlossModel::initFromMap(const ParameterMap& params) {
     return AnalogueModel::initFromMap(params) && bInitSuccess;
 }
 
-void BreakpointPathlossModel::filterSignal(airframe_ptr_t frame, const Coord& sendersPos, const Coord& receiverPos) {
-	Signal& signal = frame->getSignal();
-
+double BreakpointPathlossModel::calcAttenuation(const Coord& receiverPos, const Coord& sendersPos) {
 	/** Calculate the distance factor */
 	double distance = useTorus ? receiverPos.sqrTorusDist(sendersPos, playgroundSize)
 								  : receiverPos.sqrdist(sendersPos);
@@ -104,7 +102,7 @@ void BreakpointPathlossModel::filterSignal(airframe_ptr_t frame, const Coord& se
 
 	if(distance <= 1.0) {
 		//attenuation is negligible
-		return;
+		return -1.0;
 	}
 
 	double attenuation = 1;
@@ -123,14 +121,35 @@ void BreakpointPathlossModel::filterSignal(airframe_ptr_t frame, const Coord& se
 	attenuation = 1/attenuation;
 	debugEV << "attenuation is: " << attenuation << endl;
 
+	return attenuation;
+}
+
+void BreakpointPathlossModel::filterSignal(airframe_ptr_t frame, const Coord& sendersPos, const Coord& receiverPos) {
+	Signal& signal = frame->getSignal();
+
+	// reuse the attenuation of the last AirFrame of this sender if neither
+	// host moved since then
+	const LinkGainCache::Key cacheKey    = LinkGainCache::getKey(frame);
+	double                   attenuation = 0;
+
+	if(!attenuationCache.find(cacheKey, attenuation)) {
+		attenuation = calcAttenuation(receiverPos, sendersPos);
+		attenuationCache.insert(cacheKey, attenuation);
+	}
+
+	if(attenuation < 0) {
+		//attenuation is negligible
+		return;
+	}
+
 	if(debug) {
 	  pathlosses.record(10*log10(attenuation)); // in dB
 	}
 
 	//const DimensionSet& domain = DimensionSet::timeDomain;
 	Argument arg;	// default constructor initializes with a single dimension, time, and value 0 (offset from signal start)
-	TimeMapping<Linear>* attMapping = new TimeMapping<Linear> ();	// mapping performs a linear interpolation from our single point -> constant
-	attMapping->setValue(arg, attenuation);
+	// constant attenuation, the signal folds it into its attenuation factor
+	ConstantSimpleConstMapping* attMapping = new ConstantSimpleConstMapping(DimensionSet::timeDomain, arg, attenuation);
 
 	/* at last add the created attenuation mapping to the signal */
 	signal.addAttenuation(attMapping);
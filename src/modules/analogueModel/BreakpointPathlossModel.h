@@ -5,6 +5,7 @@
 
 #include "MiXiMDefs.h"
 #include "AnalogueModel.h"
+#include "LinkGainCache.h"
 
 /**
  * @brief Basic implementation of a BreakpointPathlossModel.
@@ -47,6 +48,19 @@ protected:
     /** logs computed pathlosses. */
     cOutVector pathlosses;
 
+    /** @brief Attenuations of the links to the senders seen so far. */
+    LinkGainCache attenuationCache;
+
+protected:
+	/**
+	 * @brief Calculates the attenuation for the distance between sender and
+	 * receiver.
+	 *
+	 * @return the attenuation or a negative value if the attenuation is
+	 * negligible.
+	 */
+	double calcAttenuation(const Coord& receiverPos, const Coord& sendersPos);
+
 public:
 	/**
 	 * @brief Initializes the analogue model. playgroundSize
@@ -76,6 +90,7 @@ public:
 		, playgroundSize(playgroundSize)
 		, debug(debug)
 		, pathlosses()
+		, attenuationCache()
 	{
 		pathlosses.setName("pathlosses");
 	}
@@ -41,14 +41,13 @@ class MIXIM_API IntensityModel : public AnalogueModel {
 
 	void filterSignal(airframe_ptr_t frame, const Coord& sendersPos, const Coord& receiverPos) {
             Signal& s = frame->getSignal();
-            TimeMapping<Linear>* attMapping = new TimeMapping<Linear>();
 
             // Determine distance between sender and receiver
             assert(s.getReceptionStart() == simTime());
             double distance = sendersPos.distance(receiverPos);
 
             Argument arg;
-            attMapping->setValue(arg, 4 * M_PI * pow(distance, 2));
+            ConstantSimpleConstMapping* attMapping = new ConstantSimpleConstMapping(DimensionSet::timeDomain, arg, 4 * M_PI * pow(distance, 2));
             s.addAttenuation(attMapping);
         }
 };
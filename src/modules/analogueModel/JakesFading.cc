@@ -15,52 +15,72 @@
 
 #include "JakesFading.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "BaseWorldUtility.h"
 #include "MiXiMAirFrame.h"
 #include "connectionManager/ConnectionManagerAccess.h"
 
 DimensionSet JakesFadingMapping::dimensions(Dimension::time);
 
+JakesFadingMapping::JakesFadingMapping(JakesFading* model, double relSpeed,
+                                       const Argument& start,
+                                       const Argument& interval,
+                                       const Argument& end)
+	: SimpleConstMapping(dimensions, start, end, interval)
+	, model(model)
+	, relSpeed(relSpeed)
+	, pathFrequencies(model->getFadingPaths())
+	, keyTimes()
+	, keyValues()
+{
+	if(!pathFrequencies.empty())
+		model->getPathFrequencies(relSpeed, &pathFrequencies[0]);
+}
+
+void JakesFadingMapping::calculateKeyValues() const {
+	keyTimes.reserve(keyEntries.size());
+	for (KeyEntrySet::const_iterator it = keyEntries.begin(); it != keyEntries.end(); ++it) {
+		keyTimes.push_back(SIMTIME_DBL(it->getTime()));
+	}
+	keyValues.resize(keyTimes.size());
+	getValues(&keyTimes[0], keyTimes.size(), &keyValues[0]);
+}
+
 double JakesFadingMapping::getValue(const Argument& pos) const {
-	double    f    = model->carrierFrequency;
-	double    v    = relSpeed;
-	simtime_t t    = pos.getTime();
-	double    re_h = 0;
-	double    im_h = 0;
+	const double t = SIMTIME_DBL(pos.getTime());
 
-	// Compute Doppler shift.
-	double doppler_shift = v * f / BaseWorldUtility::speedOfLight;
-
-	for (int i = 0; i < model->fadingPaths; i++) {
-		// Some math for complex numbers:
-		//
-		// Cartesian form: z = a + ib
-		// Polar form:     z = p * e^i(phi)
-		//
-		// a = p * cos(phi)
-		// b = p * sin(phi)
-		// z1 * z2 = p1 * p2 * e^i(phi1 + phi2)
+	if (keyValues.empty() && !keyEntries.empty()) {
+		calculateKeyValues();
+	}
 
-		// Phase shift due to Doppler => t-selectivity.
-		double phi_d = model->angleOfArrival[i] * doppler_shift;
-		// Phase shift due to delay spread => f-selectivity.
-		double phi_i = SIMTIME_DBL(model->delay[i]) * f;
-		// Calculate resulting phase due to t-selective and f-selective fading.
-		double phi   = 2.00 * M_PI * (phi_d * SIMTIME_DBL(t) - phi_i);
-
-		// One ring model/Clarke's model plus f-selectivity according to Cavers:
-		// Due to isotropic antenna gain pattern on all paths only a^2 can be received on all paths.
-		// Since we are interested in attenuation a:=1, attenuation per path is then:
-		double attenuation = (1.00 / sqrt(static_cast<double>(model->fadingPaths)));
-
-		// Convert to cartesian form and aggregate {Re, Im} over all fading paths.
-		re_h = re_h + attenuation * cos(phi);
-		im_h = im_h - attenuation * sin(phi);
+	// Key entries are (except the last one) equidistant, so the entry for the
+	// passed position can be found without a search.
+	if (keyTimes.size() > 1 && t >= keyTimes.front()) {
+		const double step  = keyTimes[1] - keyTimes[0];
+		size_t       index = static_cast<size_t>((t - keyTimes.front()) / step + 0.5);
+
+		if (index >= keyTimes.size())
+			index = keyTimes.size() - 1;
+		if (keyTimes[index] == t)
+			return keyValues[index];
+	}
+	else if (keyTimes.size() == 1 && keyTimes.front() == t) {
+		return keyValues.front();
 	}
 
-	// Output: |H_f|^2 = absolute channel impulse response due to fading.
-	// Note that this may be >1 due to constructive interference.
-	return re_h * re_h + im_h * im_h;
+	double value = 0;
+	getValues(&t, 1, &value);
+	return value;
+}
+
+void JakesFadingMapping::getValues(const double* times, size_t count, double* out) const {
+	if (pathFrequencies.empty()) {
+		std::fill(out, out + count, 0.0);
+		return;
+	}
+	model->getAttenuations(&pathFrequencies[0], times, count, out);
 }
 
 
@@ -69,6 +89,7 @@ JakesFading::JakesFading()
 	, fadingPaths(0)
 	, angleOfArrival(NULL)
 	, delay(NULL)
+	, pathPhase(NULL)
 	, carrierFrequency(0)
 	, interval()
 {
@@ -113,10 +134,15 @@ bool JakesFading::initFromMap(const ParameterMap& params) {
     if (bInitSuccess) {
 	angleOfArrival = new double[fadingPaths];
 	delay = new simtime_t[fadingPaths];
+	pathPhase = new double[fadingPaths];
 
 	for (int i = 0; i < fadingPaths; ++i) {
 		angleOfArrival[i] = cos(uniform(0, M_PI));
 		delay[i] = exponential(delayRMS);
+		// Phase shift due to delay spread => f-selectivity. Only the fraction
+		// of a full cycle matters which keeps the phase small and precise.
+		const double cycles = SIMTIME_DBL(delay[i]) * carrierFrequency;
+		pathPhase[i] = 2.00 * M_PI * (cycles - floor(cycles));
 	}
     }
     return AnalogueModel::initFromMap(params) && bInitSuccess;
@@ -127,6 +153,8 @@ JakesFading::~JakesFading() {
 	delete[] delay;
     if (angleOfArrival != NULL)
 	delete[] angleOfArrival;
+    if (pathPhase != NULL)
+	delete[] pathPhase;
 }
 
 void JakesFading::filterSignal(airframe_ptr_t frame, const Coord& /*sendersPos*/, const Coord& /*receiverPos*/)
@@ -141,3 +169,64 @@ void JakesFading::filterSignal(airframe_ptr_t frame, const Coord& /*sendersPos*/
 	                                             interval,
 	                                             Argument(signal.getReceptionEnd())));
 }
+
+void JakesFading::getPathFrequencies(double relSpeed, double* frequencies) const
+{
+	// Compute Doppler shift.
+	const double doppler_shift = relSpeed * carrierFrequency / BaseWorldUtility::speedOfLight;
+
+	for (int i = 0; i < fadingPaths; ++i) {
+		// Phase shift due to Doppler => t-selectivity.
+		frequencies[i] = 2.00 * M_PI * angleOfArrival[i] * doppler_shift;
+	}
+}
+
+void JakesFading::getAttenuations(const double* pathFrequencies,
+                                  const double* times, size_t count,
+                                  double* out) const
+{
+	// Some math for complex numbers:
+	//
+	// Cartesian form: z = a + ib
+	// Polar form:     z = p * e^i(phi)
+	//
+	// a = p * cos(phi)
+	// b = p * sin(phi)
+	// z1 * z2 = p1 * p2 * e^i(phi1 + phi2)
+	//
+	// One ring model/Clarke's model plus f-selectivity according to Cavers:
+	// Due to isotropic antenna gain pattern on all paths only a^2 can be received on all paths.
+	// Since we are interested in attenuation a:=1, attenuation per path is 1/sqrt(fadingPaths),
+	// which is applied to the squared sum as 1/fadingPaths.
+	const double attenuation = 1.00 / static_cast<double>(fadingPaths);
+	const size_t blockSize   = 64;
+	double       re_h[blockSize];
+	double       im_h[blockSize];
+
+	for (size_t first = 0; first < count; first += blockSize) {
+		const size_t  n = std::min(blockSize, count - first);
+		const double* t = times + first;
+
+		std::fill(re_h, re_h + n, 0.0);
+		std::fill(im_h, im_h + n, 0.0);
+
+		for (int i = 0; i < fadingPaths; ++i) {
+			const double w = pathFrequencies[i];
+			const double p = pathPhase[i];
+
+			// Aggregate {Re, Im} of the resulting phase due to t-selective and
+			// f-selective fading over all fading paths.
+			for (size_t j = 0; j < n; ++j) {
+				const double phi = w * t[j] - p;
+				re_h[j] += cos(phi);
+				im_h[j] -= sin(phi);
+			}
+		}
+
+		// Output: |H_f|^2 = absolute channel impulse response due to fading.
+		// Note that this may be >1 due to constructive interference.
+		for (size_t j = 0; j < n; ++j) {
+			out[first + j] = (re_h[j] * re_h[j] + im_h[j] * im_h[j]) * attenuation;
+		}
+	}
+}
@@ -16,6 +16,8 @@
 #ifndef JAKESFADING_H_
 #define JAKESFADING_H_
 
+#include <vector>
+
 #include "MiXiMDefs.h"
 #include "AnalogueModel.h"
 #include "Mapping.h"
@@ -43,6 +45,24 @@ protected:
 	/** @brief The relative speed between the two hosts for this attenuation.*/
 	double relSpeed;
 
+	/**
+	 * @brief Angular Doppler frequency of every fading path for the relative
+	 * speed of this link.
+	 */
+	std::vector<double> pathFrequencies;
+
+	/** @brief Times of the key entries, filled on first access. */
+	mutable std::vector<double> keyTimes;
+
+	/** @brief Attenuation at the key entries, filled on first access. */
+	mutable std::vector<double> keyValues;
+
+protected:
+	/**
+	 * @brief Calculates the attenuation at all key entries at once.
+	 */
+	void calculateKeyValues() const;
+
 public:
 	/**
 	 * @brief Takes the model, the relative speed between two hosts and
@@ -51,22 +71,30 @@ public:
 	JakesFadingMapping(JakesFading* model, double relSpeed,
 					   const Argument& start,
 					   const Argument& interval,
-					   const Argument& end)
-		: SimpleConstMapping(dimensions, start, end, interval)
-		, model(model)
-		, relSpeed(relSpeed)
-	{}
+					   const Argument& end);
 
 	JakesFadingMapping(const JakesFadingMapping& o)
 		: SimpleConstMapping(o)
 		, model(o.model)
 		, relSpeed(o.relSpeed)
+		, pathFrequencies(o.pathFrequencies)
+		, keyTimes(o.keyTimes)
+		, keyValues(o.keyValues)
 	{}
 
 	virtual ~JakesFadingMapping() {}
 
 	virtual double getValue(const Argument& pos) const;
 
+	/**
+	 * @brief Calculates the attenuation at several points in time at once.
+	 *
+	 * @param times Array of "count" points in time (in seconds).
+	 * @param count Number of points in time to evaluate.
+	 * @param out Buffer the "count" attenuation values are written to.
+	 */
+	void getValues(const double* times, size_t count, double* out) const;
+
 	/**
 	 * @brief creates a clone of this mapping.
 	 *
@@ -129,6 +157,12 @@ protected:
 	/** @brief Delay on a fading path. */
 	simtime_t* delay;
 
+	/**
+	 * @brief Phase shift of every fading path due to its delay
+	 * (2 * pi * delay * carrierFrequency), wrapped to [0, 2 * pi).
+	 */
+	double* pathPhase;
+
 	/** @brief Carrier frequency to be used. */
 	double carrierFrequency;
 
@@ -154,6 +188,34 @@ public:
 	virtual ~JakesFading();
 
 	virtual void filterSignal(airframe_ptr_t, const Coord&, const Coord&);
+
+	/**
+	 * @brief Calculates the angular Doppler frequency of every fading path
+	 * for the passed relative speed between sender and receiver.
+	 *
+	 * @param relSpeed The relative speed between the two hosts.
+	 * @param frequencies Buffer for "fadingPaths" values.
+	 */
+	void getPathFrequencies(double relSpeed, double* frequencies) const;
+
+	/**
+	 * @brief Calculates the attenuation of a link at several points in time.
+	 *
+	 * The time points are processed in blocks with one loop per fading path
+	 * so the compiler is able to vectorize the inner loop.
+	 *
+	 * @param pathFrequencies The Doppler frequencies of the link as returned
+	 * by getPathFrequencies().
+	 * @param times Array of "count" points in time (in seconds).
+	 * @param count Number of points in time to evaluate.
+	 * @param out Buffer the "count" attenuation values are written to.
+	 */
+	void getAttenuations(const double* pathFrequencies,
+						 const double* times, size_t count,
+						 double* out) const;
+
+	/** @brief Returns the number of fading paths used. */
+	int getFadingPaths() const { return fadingPaths; }
 };
 
 #endif /* JAKESFADING_H_ */
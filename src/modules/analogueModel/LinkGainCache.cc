@@ -0,0 +1,34 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include "LinkGainCache.h"
+
+#include "MiXiMAirFrame.h"
+#include "connectionManager/ConnectionManagerAccess.h"
+
+LinkGainCache::Key LinkGainCache::getKey(const MiximAirFrame* frame)
+{
+	Key key;
+
+	const ConnectionManagerAccess* sender   = dynamic_cast<const ConnectionManagerAccess*>(frame->getSenderModule());
+	const ConnectionManagerAccess* receiver = dynamic_cast<const ConnectionManagerAccess*>(frame->getArrivalModule());
+
+	if(sender && receiver) {
+		key.senderNic     = sender->getParentModule()->getId();
+		key.senderEpoch   = sender->getPositionEpoch();
+		key.receiverEpoch = receiver->getPositionEpoch();
+	}
+	return key;
+}
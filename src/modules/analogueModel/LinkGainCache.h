@@ -0,0 +1,128 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#ifndef LINKGAINCACHE_H_
+#define LINKGAINCACHE_H_
+
+#include <map>
+
+#include "MiXiMDefs.h"
+
+class MiximAirFrame;
+
+/**
+ * @brief Caches a distance dependent value of an analogue model per link.
+ *
+ * Every analogue model instance belongs to exactly one receiving physical
+ * layer, so a link is identified by the id of the sending NIC. An entry is
+ * valid as long as neither the sender nor the receiver reported a position
+ * change since it has been stored (see
+ * ConnectionManagerAccess::getPositionEpoch()).
+ *
+ * For stationary hosts this replaces the distance and pathloss calculation
+ * of every received AirFrame by a table lookup. The table only holds the
+ * senders actually heard, independent of the size of the module ids.
+ *
+ * @ingroup analogueModels
+ */
+class MIXIM_API LinkGainCache {
+public:
+	/** @brief Type of the position change counters.*/
+	typedef unsigned long epoch_t;
+
+	/** @brief Identifies the link and positions an AirFrame was sent on.*/
+	struct Key {
+		/** @brief Module id of the sending NIC, -1 if unknown.*/
+		int     senderNic;
+		/** @brief Position epoch of the sender.*/
+		epoch_t senderEpoch;
+		/** @brief Position epoch of the receiver.*/
+		epoch_t receiverEpoch;
+
+		Key() : senderNic(-1), senderEpoch(0), receiverEpoch(0) {}
+	};
+
+protected:
+	/** @brief A cached value together with the epochs it is valid for.*/
+	struct Entry {
+		bool    valid;
+		epoch_t senderEpoch;
+		epoch_t receiverEpoch;
+		double  value;
+
+		Entry() : valid(false), senderEpoch(0), receiverEpoch(0), value(0) {}
+	};
+
+	/** @brief Cached values mapped by the module id of the sending NIC.*/
+	typedef std::map<int, Entry> EntryMap;
+
+	/** @brief Cached values of the senders heard so far.*/
+	EntryMap entries;
+
+public:
+	LinkGainCache() : entries() {}
+
+	/**
+	 * @brief Returns the key of the link the passed AirFrame is received
+	 * on.
+	 *
+	 * The key of AirFrames whose sender or receiver is not a
+	 * ConnectionManagerAccess module is never found in the cache.
+	 */
+	static Key getKey(const MiximAirFrame* frame);
+
+	/**
+	 * @brief Looks up the value for the passed key.
+	 *
+	 * @return true if a valid value has been found and written to "value".
+	 */
+	bool find(const Key& key, double& value) const {
+		if(key.senderNic < 0)
+			return false;
+
+		const EntryMap::const_iterator it = entries.find(key.senderNic);
+		if(it == entries.end())
+			return false;
+
+		const Entry& entry = it->second;
+		if(!entry.valid
+		   || entry.senderEpoch != key.senderEpoch
+		   || entry.receiverEpoch != key.receiverEpoch)
+			return false;
+
+		value = entry.value;
+		return true;
+	}
+
+	/**
+	 * @brief Stores the value for the passed key, replacing any value stored
+	 * for older positions of the same link.
+	 */
+	void insert(const Key& key, double value) {
+		if(key.senderNic < 0)
+			return;
+
+		Entry& entry        = entries[key.senderNic];
+		entry.valid         = true;
+		entry.senderEpoch   = key.senderEpoch;
+		entry.receiverEpoch = key.receiverEpoch;
+		entry.value         = value;
+	}
+
+	/** @brief Invalidates all cached values.*/
+	void clear() { entries.clear(); }
+};
+
+#endif /* LINKGAINCACHE_H_ */
@@ -30,9 +30,8 @@ void PERModel::filterSignal(airframe_ptr_t frame, const Coord& /*sendersPos*/, c
 		attenuationFactor = 0;  // absorb all energy so that the receveir cannot receive anything
 	}
 
-	TimeMapping<Linear>* attMapping = new TimeMapping<Linear> ();
 	Argument arg;
-	attMapping->setValue(arg, attenuationFactor);
+	ConstantSimpleConstMapping* attMapping = new ConstantSimpleConstMapping(DimensionSet::timeDomain, arg, attenuationFactor);
 	signal.addAttenuation(attMapping);
 }
 
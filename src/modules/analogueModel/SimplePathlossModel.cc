@@ -90,44 +90,69 @@ bool SimplePathlossModel::initFromMap(const ParameterMap& params) {
     return AnalogueModel::initFromMap(params) && bInitSuccess;
 }
 
-void SimplePathlossModel::filterSignal(airframe_ptr_t frame, const Coord& sendersPos, const Coord& receiverPos)
+double SimplePathlossModel::calcDistFactor(const Coord& receiverPos, const Coord& sendersPos)
 {
-	Signal& signal = frame->getSignal();
-
-	/** Calculate the distance factor */
 	double sqrDistance = useTorus ? receiverPos.sqrTorusDist(sendersPos, playgroundSize)
 								  : receiverPos.sqrdist(sendersPos);
 
 	splmEV << "sqrdistance is: " << sqrDistance << endl;
 
 	if(sqrDistance <= 1.0) {
+		//attenuation is negligible
+		return -1.0;
+	}
+
+	return pow(sqrDistance, -pathLossAlphaHalf) / (16.0 * M_PI * M_PI);
+}
+
+void SimplePathlossModel::filterSignal(airframe_ptr_t frame, const Coord& sendersPos, const Coord& receiverPos)
+{
+	Signal& signal = frame->getSignal();
+
+	/** Calculate the distance factor, unless neither host moved since the
+	 * last AirFrame of this sender */
+	const LinkGainCache::Key cacheKey   = LinkGainCache::getKey(frame);
+	double                   distFactor = 0;
+
+	if(!distFactorCache.find(cacheKey, distFactor)) {
+		distFactor = calcDistFactor(receiverPos, sendersPos);
+		distFactorCache.insert(cacheKey, distFactor);
+	}
+
+	if(distFactor < 0) {
 		//attenuation is negligible
 		return;
 	}
 
-	// wavelength in meters (this is only used for debug purposes here
-	// the actual effect of the wavelength on the attenuation is
-	// calculated in SimplePathlossConstMappings "getValue()" method).
+	// wavelength in meters (for signals defined over frequency this is only
+	// used for debug purposes here, the actual effect of the wavelength on the
+	// attenuation is calculated in SimplePathlossConstMappings "getValue()" method).
 	double wavelength = (BaseWorldUtility::speedOfLight/carrierFrequency);
 	splmEV << "wavelength is: " << wavelength << endl;
 
 	// the part of the attenuation only depending on the distance
-	double distFactor = pow(sqrDistance, -pathLossAlphaHalf) / (16.0 * M_PI * M_PI);
 	splmEV << "distance factor is: " << distFactor << endl;
 
 	//is our signal to attenuate defined over frequency?
 	bool hasFrequency = signal.getTransmissionPower()->getDimensionSet().hasDimension(Dimension::frequency);
 	splmEV << "Signal contains frequency dimension: " << (hasFrequency ? "yes" : "no") << endl;
 
-	const DimensionSet& domain = hasFrequency ? DimensionSet::timeFreqDomain : DimensionSet::timeDomain;
+	ConstMapping* attMapping = NULL;
 
-	//create the Attenuation mapping which takes the distance factor as parameter
-	//to calculate the attenuation from this and the frequency used for the transmission
-	//see the classes "getValue()" for more
-	SimplePathlossConstMapping* attMapping = new SimplePathlossConstMapping(
-													domain,
+	if(hasFrequency) {
+		//create the Attenuation mapping which takes the distance factor as parameter
+		//to calculate the attenuation from this and the frequency used for the transmission
+		//see the classes "getValue()" for more
+		attMapping = new SimplePathlossConstMapping(DimensionSet::timeFreqDomain,
 													this,
 													distFactor);
+	}
+	else {
+		//without frequency dimension the attenuation is constant, the signal
+		//folds it into its attenuation factor
+		attMapping = new ConstantSimpleConstMapping(DimensionSet::timeDomain,
+													wavelength * wavelength * distFactor);
+	}
 
 	/* at last add the created attenuation mapping to the signal */
 	signal.addAttenuation(attMapping);
@@ -7,6 +7,7 @@
 #include "AnalogueModel.h"
 #include "Mapping.h"
 #include "BaseWorldUtility.h"
+#include "LinkGainCache.h"
 
 class SimplePathlossModel;
 
@@ -110,6 +111,19 @@ protected:
 	/** @brief Whether debug messages should be displayed. */
 	bool debug;
 
+	/** @brief Distance factors of the links to the senders seen so far. */
+	LinkGainCache distFactorCache;
+
+protected:
+	/**
+	 * @brief Calculates the part of the attenuation which only depends
+	 * on the distance between sender and receiver.
+	 *
+	 * @return the distance factor or a negative value if the attenuation
+	 * is negligible.
+	 */
+	double calcDistFactor(const Coord& receiverPos, const Coord& sendersPos);
+
 public:
 	/**
 	 * @brief Initializes the analogue model. playgroundSize
@@ -132,6 +146,7 @@ public:
 	    , useTorus(false)
 	    , playgroundSize()
 	    , debug(false)
+	    , distFactorCache()
 	{ }
 
 	/** @brief Initialize the analog model from XML map data.
@@ -21,6 +21,8 @@ void CSMAMacLayer::initialize(int stage)
     if (stage == 0) {
 
         queueLength = hasPar("queueLength") 	? par("queueLength").longValue()	 : 10;
+        // a full queue has always been detected one packet late
+        macQueue.setCapacity(queueLength + 1);
         //busyRSSI = hasPar("busyRSSI") 			? par("busyRSSI").doubleValue() 	 : -90;
         slotDuration = hasPar("slotDuration") 	? par("slotDuration").doubleValue()	 : 0.1;
         difs = hasPar("difs") 					? par("difs").doubleValue()			 : 0.001;
@@ -73,18 +75,18 @@ CSMAMacLayer::~CSMAMacLayer() {
 	cancelAndDelete(backoffTimer);
 	cancelAndDelete(minorMsg);
 
-    for(MacQueue::iterator it = macQueue.begin();
-		it != macQueue.end(); ++it)
+    while(!macQueue.empty())
     {
-        delete (*it);
+        delete macQueue.front();
+        macQueue.pop_front();
     }
-    macQueue.clear();
 }
 
 void CSMAMacLayer::finish() {
 	recordScalar("nbBackoffs", nbBackoffs);
 	recordScalar("backoffDurations", backoffValues);
 	recordScalar("nbTxFrames", nbTxFrames);
+	macQueue.recordStatistics(this);
 
 	BaseMacLayer::finish();
 }
@@ -111,9 +113,8 @@ void CSMAMacLayer::handleUpperMsg(cMessage *msg)
     // message has to be queued if another message is waiting to be send
     // or if we are already trying to send another message
 
-    if (macQueue.size() <= queueLength)
+    if (macQueue.push_back(pkt))
     {
-        macQueue.push_back(pkt);
         debugEV 	<< "packet putt in queue\n  queue size:" << macQueue.size() << " macState:" << macState
 			<< " (RX=" << RX << ") is scheduled:" << backoffTimer->isScheduled() << endl;;
 
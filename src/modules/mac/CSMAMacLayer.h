@@ -5,6 +5,7 @@
 
 #include "MiXiMDefs.h"
 #include "BaseMacLayer.h"
+#include "BoundedMacQueue.h"
 
 /**
  * @class CSMAMacLayer
@@ -77,7 +78,7 @@ class MIXIM_API CSMAMacLayer : public BaseMacLayer
 
   protected:
     /** @brief Type for a queue of cPackets.*/
-    typedef std::list<cPacket*> MacQueue;
+    typedef BoundedMacQueue<cPacket*> MacQueue;
 
     /** @brief MAC states
      *
@@ -129,6 +129,7 @@ void Mac80211::initialize(int stage)
 
         neighborhoodCacheSize = hasPar("neighborhoodCacheSize") ? par("neighborhoodCacheSize").longValue() : 0;
         neighborhoodCacheMaxAge = hasPar("neighborhoodCacheMaxAge") ? par("neighborhoodCacheMaxAge").longValue() : 10000;
+        neighbors.setCapacity(neighborhoodCacheSize);
 
         debugEV << " MAC Address: " << myMacAddr
            << " rtsCtsThreshold: " << rtsCtsThreshold
@@ -386,6 +387,7 @@ void Mac80211::handleMsgNotForMe(cMessage *af, simtime_t_cref duration)
                     fromUpperLayer.front()->setRetry(true);
                 }
                 if((state == WFACK) || (state == WFCTS)) {
+                    txAttemptFinished(false);
                     if(rtsCts(fromUpperLayer.front())) {
                         longRetryCounter++;
                     }
@@ -536,10 +538,10 @@ void Mac80211::handleRTSframe(Mac80211Pkt * af)
  */
 void Mac80211::handleDATAframe(Mac80211Pkt * af)
 {
-    NeighborList::iterator it;
+    NeighborEntry* it;
     if (rtsCts(af)) cancelEvent(timeout);  // cancel time-out event
     it = findNeighbor(af->getSrcAddr());
-    if(it == neighbors.end()) error("Mac80211::handleDATAframe: neighbor not registered");
+    if(it == NULL) error("Mac80211::handleDATAframe: neighbor not registered");
     if(af->getRetry() && (it->fsc == af->getSequenceControl())) {
     	debugEV << "Mac80211::handleDATAframe suppressed duplicate message " << af
            << " fsc: " << it->fsc << "\n";
@@ -565,6 +567,8 @@ void Mac80211::handleACKframe(Mac80211Pkt * /*af*/)
     // cancel time-out event
     cancelEvent(timeout);
 
+    txAttemptFinished(true);
+
     // the transmission is acknowledged : initialize long_retry_counter
     longRetryCounter = 0;
     shortRetryCounter = 0;
@@ -704,6 +708,7 @@ void Mac80211::handleNavTimer()
 
 void Mac80211::dataTransmissionFailed()
 {
+    txAttemptFinished(false);
     bool rtscts = rtsCts(fromUpperLayer.front());
     if(rtscts){
         longRetryCounter++;
@@ -716,6 +721,7 @@ void Mac80211::dataTransmissionFailed()
 
 void Mac80211::rtsTransmissionFailed()
 {
+    txAttemptFinished(false);
     longRetryCounter++;
     remainingBackoff = backoff();
 }
@@ -1216,11 +1222,11 @@ void Mac80211::suspendContention()  {
 
 double Mac80211::retrieveBitrate(const LAddress::L2Type& destAddress) {
     double bitrate = defaultBitrate;
-    NeighborList::iterator it;
+    const NeighborEntry* it;
     if(autoBitrate && !LAddress::isL2Broadcast(destAddress) &&
        (longRetryCounter == 0) && (shortRetryCounter == 0)) {
         it = findNeighbor(destAddress);
-        if((it != neighbors.end()) && (it->age > (simTime() - neighborhoodCacheMaxAge))) {
+        if((it != NULL) && (it->age > (simTime() - neighborhoodCacheMaxAge))) {
             bitrate = it->bitrate;
         }
     }
@@ -1229,41 +1235,55 @@ double Mac80211::retrieveBitrate(const LAddress::L2Type& destAddress) {
 
 void Mac80211::addNeighbor(Mac80211Pkt *af) {
     const LAddress::L2Type&   srcAddress = af->getSrcAddr();
-    NeighborList::iterator    it         = findNeighbor(srcAddress);
     const DeciderResult80211* result     = static_cast<const DeciderResult80211*>(PhyToMacControlInfo::getDeciderResult(af));
-    double snr = result->getSnr();
+    bool                      isNew      = false;
+    // a new neighbor replaces the least recently updated one if the cache is full
+    NeighborEntry*            it         = neighbors.update(srcAddress, &isNew);
+
+    if(it == NULL) {
+        debugEV << "neighborhood cache disabled, ignoring neighbor: " << srcAddress << endl;
+        return;
+    }
+    if(isNew) {
+        it->address = srcAddress;
+    }
+    it->age = simTime();
+    updateBitrate(*it, *result);
+
+    debugEV << "updated information for neighbor: " << srcAddress
+       << " snr: " << result->getSnr() << " bitrate: " << it->bitrate << endl;
+}
+
+void Mac80211::updateBitrate(NeighborEntry& neighbor, const DeciderResult80211& result) {
+    double snr = result.getSnr();
 
     double bitrate = BITRATES_80211[0];
-    NeighborEntry entry;
 
     if(snr > snrThresholds[0]) bitrate = BITRATES_80211[1];
     if(snr > snrThresholds[1]) bitrate = BITRATES_80211[2];
     if(snr > snrThresholds[2]) bitrate = BITRATES_80211[3];
 
-    if(it != neighbors.end()) {
-        it->age = simTime();
-        it->bitrate = bitrate;
+    neighbor.bitrate = bitrate;
+}
+
+void Mac80211::reportTxResult(NeighborEntry& neighbor, bool acknowledged) {
+    if(acknowledged) {
+        ++neighbor.txSuccesses;
+        neighbor.txFailures = 0;
     }
     else {
-        if(neighbors.size() < neighborhoodCacheSize) {
-            entry.address = srcAddress;
-            entry.age = simTime();
-            entry.bitrate = bitrate;
-            entry.fsc = 0;
-            neighbors.push_back(entry);
-        }
-        else {
-            it = findOldestNeighbor();
-            if(it != neighbors.end()) {
-                it->age = simTime();
-                it->bitrate = bitrate;
-                it->address = srcAddress;
-                it->fsc = 0;
-            }
-        }
+        ++neighbor.txFailures;
+        neighbor.txSuccesses = 0;
+    }
+}
+
+void Mac80211::txAttemptFinished(bool acknowledged) {
+    if(fromUpperLayer.empty())
+        return;
+    NeighborEntry* neighbor = findNeighbor(fromUpperLayer.front()->getDestAddr());
+    if(neighbor != NULL) {
+        reportTxResult(*neighbor, acknowledged);
     }
-    debugEV << "updated information for neighbor: " << srcAddress
-       << " snr: " << snr << " bitrate: " << bitrate << endl;
 }
 
 Mac80211::~Mac80211() {
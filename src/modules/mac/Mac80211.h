@@ -26,8 +26,10 @@
 #include "BaseMacLayer.h"
 #include "Consts80211.h"
 #include "Mac80211Pkt_m.h"
+#include "NeighborTable.h"
 
 class ChannelSenseRequest;
+class DeciderResult80211;
 
 /**
  * @brief An implementation of the 802.11b MAC.
@@ -88,12 +90,16 @@ protected:
         int              fsc;
         simtime_t        age;
         double           bitrate;
+        /** @brief Consecutive acknowledged unicast transmissions.*/
+        unsigned         txSuccesses;
+        /** @brief Consecutive failed unicast transmissions.*/
+        unsigned         txFailures;
 
-        NeighborEntry() : address(), fsc(0), age(), bitrate(0) {}
+        NeighborEntry() : address(), fsc(0), age(), bitrate(0), txSuccesses(0), txFailures(0) {}
     };
 
-    /** @brief Type for a list of NeighborEntries.*/
-    typedef std::list<NeighborEntry> NeighborList;
+    /** @brief Type for the hash indexed table of NeighborEntries.*/
+    typedef NeighborTable<NeighborEntry> NeighborList;
 
   public:
     Mac80211();
@@ -203,31 +209,40 @@ protected:
     /** @brief figure out at which bitrate to send to this particular destination */
     double retrieveBitrate(const LAddress::L2Type& destAddress);
 
-    /** @brief add a new entry to the neighbor list */
+    /** @brief add a new entry to the neighbor list, replaces the oldest entry if it is full */
     void addNeighbor(Mac80211Pkt *af);
 
-    /** @brief find a neighbor based on his address */
-    NeighborList::iterator findNeighbor(const LAddress::L2Type& address)  {
-        NeighborList::iterator it;
-        for(it = neighbors.begin(); it != neighbors.end(); ++it) {
-            if(it->address == address) break;
-        }
-        return it;
+    /** @brief find a neighbor based on his address, NULL if he is unknown */
+    NeighborEntry* findNeighbor(const LAddress::L2Type& address) {
+        return neighbors.find(address);
     }
 
-    /** @brief find the oldest neighbor -- usually in order to overwrite this entry */
-    NeighborList::iterator findOldestNeighbor() {
-        NeighborList::iterator it = neighbors.begin();
-        NeighborList::iterator oldIt = neighbors.begin();
-        simtime_t age = it->age;
-        for(; it != neighbors.end(); ++it) {
-            if(it->age < age) {
-                age = it->age;
-                oldIt = it;
-            }
-        }
-        return oldIt;
-    }
+    /**
+     * @name Rate adaptation
+     * @brief Override these to implement other rate adaptation schemes
+     * (e.g. ARF), the bitrate stored in a NeighborEntry is used by
+     * retrieveBitrate() for the next transmission to that neighbor.
+     */
+    /*@{*/
+    /**
+     * @brief Called for every frame received from a neighbor.
+     *
+     * The default chooses the highest bitrate whose SNR threshold is
+     * exceeded by the SNR of the received frame.
+     */
+    virtual void updateBitrate(NeighborEntry& neighbor, const DeciderResult80211& result);
+
+    /**
+     * @brief Called when a unicast DATA or RTS frame to a neighbor has been
+     * acknowledged or has failed.
+     *
+     * The default only counts consecutive successes and failures.
+     */
+    virtual void reportTxResult(NeighborEntry& neighbor, bool acknowledged);
+    /*@}*/
+
+    /** @brief Passes the outcome of the transmission of the first queued packet to reportTxResult() */
+    void txAttemptFinished(bool acknowledged);
 
 
     /**
@@ -331,7 +346,7 @@ protected:
     /** @brief Consider information in cache outdate if it is older than this */
     simtime_t neighborhoodCacheMaxAge;
 
-    /** @brief A list of this hosts neighbors.*/
+    /** @brief This hosts neighbors, at most neighborhoodCacheSize.*/
     NeighborList neighbors;
 
     /** take care of switchover times */
@@ -62,6 +62,8 @@ void TADMacLayer::initialize(int stage) {
         numberSender = hasPar("numberSender") ? par("numberSender") : 1;
         startAt = hasPar("startAt") ? par("startAt") : 0.001;
         logFileName = par("logFileName").stringValue();
+        singleLogFile = hasPar("singleLogFile") ? par("singleLogFile") : false;
+        logBufferSize = hasPar("logBufferSize") ? static_cast<size_t>(par("logBufferSize").longValue()) : 65536;
 
 
         queueLength = hasPar("queueLength") ? par("queueLength") : 10;
@@ -143,77 +145,27 @@ void TADMacLayer::initialize(int stage) {
         sentACK->setKind(TADMAC_SENT_ACK);
 
         if (role == NODE_RECEIVER) {
-            log_tsr.open("results/tsr.csv");
+            log_tsr.open("results/tsr.csv", logBufferSize);
 
             int nodeIdx = getNode()->getIndex();
             TSR_length = 8;
-            // allocate memory & initialize for TSR bank
-            TSR_bank = new int*[numberSender+1];
-            for (int i = 1; i <= numberSender; i++) {
-                TSR_bank[i] = new int[TSR_length];
-                for (int j = 0; j < TSR_length; j++) {
-                    TSR_bank[i][j] = 0;
-                }
-            }
+            // one state record per sender, senders[0] stands for no sender
+            senders.assign(numberSender + 1, SenderState(wakeupInterval, TSR_length));
             /**
              * Define route table here. Because we don't use high level so we need to fix the network topologie
              * node[0] is receiver, mac address is 00:00:00:00:00:00
              * node[1->4] is sender, mac address is from 00:00:00:00:00:01 to 00:00:00:00:00:04
              * node[5] is receiver, mac address is 00:00:00:00:00:05
              * node[6->9] is sender, mac address is from 00:00:00:00:00:06 to 00:00:00:00:00:09
+             * so the senders of the receiver node[n] have the addresses n + 1 to n + numberSender
              */
-            routeTable = new LAddress::L2Type[numberSender+1];
-            for (int i = 1; i <= numberSender; i++) {
-                ostringstream converter;
-                converter << "00:00:00:00:00:0" << (i + nodeIdx);
-                routeTable[i].setAddress(converter.str().c_str());
-
-                // Create file to log wakeup interval
-                converter.str("");
-                converter.clear();
-                converter << logFileName << "_" << (i + nodeIdx) << ".csv";
-                logFile.open(converter.str().c_str());
-                logFile << "WU Interval for node:" << i + nodeIdx << endl;
-                logFile.close();
-//                cout << routeTable[i] << endl;
-            }
-            // allocate memory & initialize for nodeWakeupInterval & nextWakeupIntervalTime
-            nodeWakeupInterval = new double[numberSender+1];
-            nodeWakeupIntervalLock = new double[numberSender+1];
-            nodeSumWUInt = new double[numberSender+1];
-            nextWakeupTime = new simtime_t[numberSender+1];
             for (int i = 1; i <= numberSender; i++) {
-                nodeWakeupInterval[i] = wakeupInterval;
-                nodeWakeupIntervalLock[i] = 0.0;
-                nextWakeupTime[i] = 0.0;
-                nodeSumWUInt[i] = 0.0;
-//                nextWakeupTime[i] = (rand() % 1000 + 1) / 1000.0;
-//                nextWakeupTime[i] = (100 * i) / 1000.0;
-                //cout << nextWakeupTime[i] << endl;
-            }
-
-            // allocate memory & initialize for nodeIdle
-            nodeIdle = new double*[numberSender+1];
-            nodeIndex = new int[numberSender+1];
-            nodeNumberWakeup = new int[numberSender+1];
-            nodeFirstTime = new int[numberSender+1];
-            nodePriority = new int[numberSender+1];
-            nodeCollision = new int[numberSender+1];
-            nodeChoosen = new int[numberSender+1];
-            nodeBroken = new int[numberSender+1];
-            for (int i = 1; i <= numberSender; i++) {
-                nodePriority[i] = 0;
-                nodeIndex[i] = 0;
-                nodeNumberWakeup[i] = 0;
-                nodeFirstTime[i] = 1;
-                nodeIdle[i] = new double[2];
-                nodeIdle[i][0] = nodeIdle[i][1] = 0;
-                nodeCollision[i] = 0;
-                nodeChoosen[i] = 0;
-                nodeBroken[i] = 0;
+                senders[i].address = LAddress::L2Type(i + nodeIdx);
             }
+            // Create files to log wakeup interval
+            openNodeLogs();
         } else {
-            logFile.open("results/sender.csv");
+            logFile.open("results/sender.csv", logBufferSize);
         }
         nbCollision = 0;
         numberWakeup = 0;
@@ -237,6 +189,8 @@ TADMacLayer::~TADMacLayer() {
     cancelAndDelete(ccaACKTimeout);
     cancelAndDelete(sentACK);
 
+    closeNodeLogs();
+
     MacQueue::iterator it;
     for (it = macQueue.begin(); it != macQueue.end(); ++it) {
         delete (*it);
@@ -247,6 +201,11 @@ TADMacLayer::~TADMacLayer() {
 void TADMacLayer::finish() {
     BaseMacLayer::finish();
 
+    // write the buffered logs
+    closeNodeLogs();
+    logFile.close();
+    log_tsr.close();
+
     // record stats
     if (stats) {
         recordScalar("nbTxDataPackets", nbTxDataPackets);
@@ -262,17 +221,17 @@ void TADMacLayer::finish() {
             for (int i = 1; i <= numberSender; i++) {
                 ostringstream converter;
                 converter << "nodeCollision_" << i;
-                recordScalar(converter.str().c_str(), nodeCollision[i]);
+                recordScalar(converter.str().c_str(), senders[i].collisions);
                 // Create file to log wakeup interval
                 converter.str("");
                 converter.clear();
                 converter << "nodeChoosen_" << i;
-                recordScalar(converter.str().c_str(), nodeChoosen[i]);
+                recordScalar(converter.str().c_str(), senders[i].choosen);
 
                 converter.str("");
                 converter.clear();
                 converter << "nodeBroken_" << i;
-                recordScalar(converter.str().c_str(), nodeBroken[i]);
+                recordScalar(converter.str().c_str(), senders[i].broken);
             }
         }
     }
@@ -296,7 +255,7 @@ void TADMacLayer::sendWB() {
     macpkt_ptr_t wb = new MacPkt();
     wb->setSrcAddr(myMacAddr);
     //wb->setDestAddr(LAddress::L2BROADCAST);
-    wb->setDestAddr(routeTable[currentNode]);
+    wb->setDestAddr(senders[currentNode].address);
     wb->setKind(TADMAC_WB);
     wb->setBitLength(headerLength);
 
@@ -338,56 +297,56 @@ void TADMacLayer::scheduleNextWakeup() {
     simtime_t nextWakeup = 10000.0;
     currentNode = 0;
     bool collision = false;
-    bool *isCollision = new bool[numberSender+1];
     for (int i = 1; i <= numberSender; i++) {
-        isCollision[i] = false;
+        senders[i].isCollision = false;
         // Check if already passed the wakeup time for a node
-        if (nextWakeupTime[i] < simTime()) {
-            cout << simTime() << "|" << "|" << i << nextWakeupTime[i] << "|" << nodeWakeupInterval[i] << endl;
-            int tmp = ceil((simTime().dbl() - nextWakeupTime[i].dbl()) / nodeWakeupInterval[i]);
-            nextWakeupTime[i] += tmp * nodeWakeupInterval[i];
+        if (senders[i].nextWakeupTime < simTime()) {
+            debugEV << "missed wakeup of sender " << i << " at " << senders[i].nextWakeupTime
+                    << ", wakeup interval " << senders[i].wakeupInterval << endl;
+            int tmp = ceil((simTime().dbl() - senders[i].nextWakeupTime.dbl()) / senders[i].wakeupInterval);
+            senders[i].nextWakeupTime += tmp * senders[i].wakeupInterval;
             for (int j = 0; j < tmp; j++) {
                 updateTSR(i, 0);
             }
-//            cout << simTime() << "|" << nextWakeupTime[i] << "|" << i << "|" << nodeWakeupInterval[i] << endl;
+//            cout << simTime() << "|" << senders[i].nextWakeupTime << "|" << i << "|" << senders[i].wakeupInterval << endl;
         }
         if (usePriority) {
-            if (nextWakeup > nextWakeupTime[i]) {
+            if (nextWakeup > senders[i].nextWakeupTime) {
                 // if 2 wakeup time is too close so we must choose only 1
-                if (nextWakeup < nextWakeupTime[i] + waitCCA + waitDATA + sysClock) {
+                if (nextWakeup < senders[i].nextWakeupTime + waitCCA + waitDATA + sysClock) {
                     // the priority of node i is lower than current node so we can't choose node i
                     // need to increase priority, update nextwakuptime & TSR for node i
-                    if (nodePriority[i] < nodePriority[currentNode]) {
-                        nodePriority[i]++;
-                        nextWakeupTime[i] += nodeWakeupInterval[i];
+                    if (senders[i].priority < senders[currentNode].priority) {
+                        senders[i].priority++;
+                        senders[i].nextWakeupTime += senders[i].wakeupInterval;
                         updateTSR(i, 0);
                     } else { // choose node i so need to update for current node
-                        nodePriority[currentNode]++;
-                        nextWakeupTime[currentNode] += nodeWakeupInterval[currentNode];
+                        senders[currentNode].priority++;
+                        senders[currentNode].nextWakeupTime += senders[currentNode].wakeupInterval;
                         updateTSR(currentNode, 0);
-                        nextWakeup = nextWakeupTime[i];
+                        nextWakeup = senders[i].nextWakeupTime;
                         currentNode = i;
                     }
                     collision = true;
-                    isCollision[i] = true;
-                    isCollision[currentNode] = true;
+                    senders[i].isCollision = true;
+                    senders[currentNode].isCollision = true;
                 } else { // current node may can be wakeup later -> don't need to increase priority & update TSR
-                    nextWakeup = nextWakeupTime[i];
+                    nextWakeup = senders[i].nextWakeupTime;
                     currentNode = i;
                 }
-            } else if ((nextWakeupTime[i] < nextWakeup + waitCCA + waitDATA + sysClock) && (nodePriority[i] > nodePriority[currentNode])) {
-                nodePriority[currentNode]++;
-                nextWakeupTime[currentNode] += nodeWakeupInterval[currentNode];
+            } else if ((senders[i].nextWakeupTime < nextWakeup + waitCCA + waitDATA + sysClock) && (senders[i].priority > senders[currentNode].priority)) {
+                senders[currentNode].priority++;
+                senders[currentNode].nextWakeupTime += senders[currentNode].wakeupInterval;
                 updateTSR(currentNode, 0);
-                nextWakeup = nextWakeupTime[i];
+                nextWakeup = senders[i].nextWakeupTime;
                 currentNode = i;
                 collision = true;
-                isCollision[i] = true;
-                isCollision[currentNode] = true;
+                senders[i].isCollision = true;
+                senders[currentNode].isCollision = true;
             }
         } else {
-            if (nextWakeup > nextWakeupTime[i]) {
-                nextWakeup = nextWakeupTime[i];
+            if (nextWakeup > senders[i].nextWakeupTime) {
+                nextWakeup = senders[i].nextWakeupTime;
                 currentNode = i;
             }
         }
@@ -395,13 +354,13 @@ void TADMacLayer::scheduleNextWakeup() {
     // reset priority of current node
     if (collision) {
         nbCollision++;
-        nodePriority[currentNode] = 0;
-        nodeChoosen[currentNode]++;
+        senders[currentNode].priority = 0;
+        senders[currentNode].choosen++;
         for (int i = 1; i <= numberSender; i++) {
-            if (isCollision[i]) {
-                nodeCollision[i]++;
+            if (senders[i].isCollision) {
+                senders[i].collisions++;
                 if (i != currentNode) {
-                    nodeBroken[i]++;
+                    senders[i].broken++;
                 }
             }
         }
@@ -409,15 +368,66 @@ void TADMacLayer::scheduleNextWakeup() {
     scheduleAt(nextWakeup, wakeup);
 }
 
-void TADMacLayer::writeLog() {
+void TADMacLayer::LogFile::open(const std::string& name, size_t bufferSize) {
+    close();
+    buffer.resize(bufferSize > 0 ? bufferSize : 1);
+    // the buffer has to be set before the file is opened
+    rdbuf()->pubsetbuf(&buffer[0], buffer.size());
+    ofstream::open(name.c_str());
+}
+
+void TADMacLayer::openNodeLogs() {
     int nodeIdx = getNode()->getIndex();
     ostringstream converter;
-    converter << logFileName << "_" << (currentNode + nodeIdx) << ".csv";
-    logFile.open(converter.str().c_str(), fstream::app);
-    logFile << nodeNumberWakeup[currentNode] << ","
-            << round(start.dbl() * 1000) << ","
-            << round(nodeWakeupInterval[currentNode] * 1000) << endl;
-    logFile.close();
+
+    closeNodeLogs();
+    if (singleLogFile) {
+        // one row per wake-up, the first column is the sender
+        converter << logFileName << "_" << nodeIdx << "_all.csv";
+        nodeLogs.push_back(new LogFile());
+        nodeLogs[0]->open(converter.str(), logBufferSize);
+        *nodeLogs[0] << "node,wakeup,start,WU interval" << '\n';
+        return;
+    }
+
+    // slot 0 is only opened by writeLog() when no sender has been chosen
+    nodeLogs.resize(numberSender + 1, NULL);
+    for (int i = 1; i <= numberSender; i++) {
+        converter.str("");
+        converter.clear();
+        converter << logFileName << "_" << (i + nodeIdx) << ".csv";
+        nodeLogs[i] = new LogFile();
+        nodeLogs[i]->open(converter.str(), logBufferSize);
+        *nodeLogs[i] << "WU Interval for node:" << i + nodeIdx << '\n';
+    }
+}
+
+void TADMacLayer::closeNodeLogs() {
+    for (size_t i = 0; i < nodeLogs.size(); i++) {
+        delete nodeLogs[i];
+    }
+    nodeLogs.clear();
+}
+
+void TADMacLayer::writeLog() {
+    if (nodeLogs.empty()) {
+        return;
+    }
+    const int slot = singleLogFile ? 0 : currentNode;
+    if (nodeLogs[slot] == NULL) {
+        // no sender has been chosen, the row goes to the file of this node
+        ostringstream converter;
+        converter << logFileName << "_" << getNode()->getIndex() << ".csv";
+        nodeLogs[slot] = new LogFile();
+        nodeLogs[slot]->open(converter.str(), logBufferSize);
+    }
+    LogFile& log = *nodeLogs[slot];
+    if (singleLogFile) {
+        log << (currentNode + getNode()->getIndex()) << ",";
+    }
+    log << senders[currentNode].numberWakeup << ","
+        << round(start.dbl() * 1000) << ","
+        << round(senders[currentNode].wakeupInterval * 1000) << '\n';
 }
 
 /**
@@ -480,7 +490,7 @@ void TADMacLayer::handleSelfMsgSender(cMessage *msg) {
                 timeWaitWB = simTime() - start;
                 // increase number wake up missed
                 wbMiss++;
-                logFile << round(timeWaitWB.dbl() * 1000) << "," << wbMiss << endl;
+                logFile << round(timeWaitWB.dbl() * 1000) << "," << wbMiss << '\n';
                 return;
             }
             // duration the WAIT_WB, received the WB message -> change to CCA state & schedule the timeout event
@@ -510,7 +520,7 @@ void TADMacLayer::handleSelfMsgSender(cMessage *msg) {
                 mac = NULL;
 //                delete msg;
 //                msg = NULL;
-                logFile << round(timeWaitWB.dbl() * 1000) << "," << wbMiss << endl;
+                logFile << round(timeWaitWB.dbl() * 1000) << "," << wbMiss << '\n';
                 return;
             }
             // during this periode, this node receive data packet or ack from other node, do nothing, wait right WB
@@ -668,7 +678,7 @@ void TADMacLayer::handleSelfMsgReceiver(cMessage *msg) {
                 numberWakeup++;
 //                log_wakeupInterval << numberWakeup << "," << round(start.dbl() * 1000) << "," << round(wakeupInterval * 1000) << endl;
 
-                nodeNumberWakeup[currentNode]++;
+                senders[currentNode].numberWakeup++;
                 writeLog();
                 return;
             }
@@ -817,10 +827,7 @@ void TADMacLayer::handleSelfMsgReceiver(cMessage *msg) {
 }
 
 void TADMacLayer::updateTSR(int nodeId, int value) {
-    for (int i = 0; i < TSR_length - 1; i++) {
-        TSR_bank[nodeId][i] = TSR_bank[nodeId][i + 1];
-    }
-    TSR_bank[nodeId][TSR_length - 1] = value;
+    senders[nodeId].tsr.push(value);
 }
 
 /**
@@ -833,93 +840,93 @@ void TADMacLayer::calculateNextInterval(cMessage *msg) {
     n02 = n12 = nc02 = nc12 = 0;
     double x1, x2;
     x1 = x2 = 0;
-    log_tsr << "------------  " << start << "  ------------ node: " << currentNode << endl;
-    log_tsr << "WUInt: " << nodeWakeupInterval[currentNode] << endl;
-    // Move the array TSR to left to store the new value in TSR[TSR_lenth - 1]
+    log_tsr << "------------  " << start << "  ------------ node: " << currentNode << '\n';
+    log_tsr << "WUInt: " << senders[currentNode].wakeupInterval << '\n';
+    // Store the new value as the latest one of the TSR
     updateTSR(currentNode, (msg == NULL) ? 0 : 1);
     for (int i = 0; i < TSR_length; i++) {
-        log_tsr << TSR_bank[currentNode][i];
+        log_tsr << senders[currentNode].tsr[i];
     }
-    log_tsr << endl;
+    log_tsr << '\n';
     // Calculate X1;
     for (int i = 0; i < TSR_length / 2; i++) {
-        if (TSR_bank[currentNode][i] == 1) {
+        if (senders[currentNode].tsr[i] == 1) {
             n11++;
-            if (i > 0 && TSR_bank[currentNode][i - 1] == 1) {
+            if (i > 0 && senders[currentNode].tsr[i - 1] == 1) {
                 nc11++;
             }
         } else {
             n01++;
-            if (i > 0 && TSR_bank[currentNode][i - 1] == 0) {
+            if (i > 0 && senders[currentNode].tsr[i - 1] == 0) {
                 nc01++;
             }
         }
     }
     x1 = n01 * nc01 * 2 / TSR_length - n11 * nc11 * 2 / TSR_length;
-    log_tsr << "n01: " << n01 << " | nc01: " << nc01 << " | n11: " << n11 << " | nc11: " << nc11 << " | x1: " << x1 << endl;
+    log_tsr << "n01: " << n01 << " | nc01: " << nc01 << " | n11: " << n11 << " | nc11: " << nc11 << " | x1: " << x1 << '\n';
     // Calculate X2
     for (int i = TSR_length / 2; i < TSR_length; i++) {
-        if (TSR_bank[currentNode][i] == 1) {
+        if (senders[currentNode].tsr[i] == 1) {
             n12++;
-            if (TSR_bank[currentNode][i - 1] == 1) {
+            if (senders[currentNode].tsr[i - 1] == 1) {
                 nc12++;
             }
         } else {
             n02++;
-            if (TSR_bank[currentNode][i - 1] == 0) {
+            if (senders[currentNode].tsr[i - 1] == 0) {
                 nc02++;
             }
         }
     }
     x2 = n02 * nc02 * 2 / TSR_length - n12 * nc12 * 2 / TSR_length;
-    log_tsr << "n02: " << n02 << " | nc02: " << nc02 << " | n12: " << n12 << " | nc12: " << nc12 << " | x2: " << x2 << endl;
+    log_tsr << "n02: " << n02 << " | nc02: " << nc02 << " | n12: " << n12 << " | nc12: " << nc12 << " | x2: " << x2 << '\n';
 
     // calculate the traffic weighting
     double mu = alpha * x1 + (1 - alpha) * x2;
-    log_tsr << "mu: " << mu << endl;
+    log_tsr << "mu: " << mu << '\n';
     /**
      * Use new adaptive function
      */
     if (useWBMiss) {
-        nodeSumWUInt[currentNode] += nodeWakeupInterval[currentNode];
+        senders[currentNode].sumWUInt += senders[currentNode].wakeupInterval;
         if (msg != NULL) {
             macpkttad_ptr_t mac  = static_cast<macpkttad_ptr_t>(msg);
             double idle = double(mac->getIdle()) / 1000.0;
             int wbMiss = mac->getWbMiss();
             mac = NULL;
-            nodeIdle[currentNode][1] = idle;
-            log_tsr << "idle: " << idle << endl;
-            if (nodeIdle[currentNode][0] != 0 && nodeIdle[currentNode][1] != 0) {
+            senders[currentNode].idle[1] = idle;
+            log_tsr << "idle: " << idle << '\n';
+            if (senders[currentNode].idle[0] != 0 && senders[currentNode].idle[1] != 0) {
                 // Calculate the TxInt of current node
-                double TxInt = (nodeSumWUInt[currentNode] + nodeIdle[currentNode][0] - nodeIdle[currentNode][1]) / (wbMiss + 1);
-                log_tsr << "TxInt: " << TxInt << endl;
+                double TxInt = (senders[currentNode].sumWUInt + senders[currentNode].idle[0] - senders[currentNode].idle[1]) / (wbMiss + 1);
+                log_tsr << "TxInt: " << TxInt << '\n';
                 // We lock the TxInt / 2 for WUInt after
-                nodeWakeupIntervalLock[currentNode] = TxInt / 2;
+                senders[currentNode].wakeupIntervalLock = TxInt / 2;
                 // Next WUInt
-                nodeWakeupInterval[currentNode] = nodeWakeupIntervalLock[currentNode] - idle + sysClock;
-                log_tsr << "next WUInt: " << nodeWakeupInterval[currentNode] << endl;
+                senders[currentNode].wakeupInterval = senders[currentNode].wakeupIntervalLock - idle + sysClock;
+                log_tsr << "next WUInt: " << senders[currentNode].wakeupInterval << '\n';
             } else {
-                nodeWakeupInterval[currentNode] += mu * sysClockFactor * sysClock;
-                nodeWakeupInterval[currentNode] = round(nodeWakeupInterval[currentNode] * 1000.0) / 1000.0;
-                if (nodeWakeupInterval[currentNode] < 0.02) {
-                    nodeWakeupInterval[currentNode] = 0.02;
+                senders[currentNode].wakeupInterval += mu * sysClockFactor * sysClock;
+                senders[currentNode].wakeupInterval = round(senders[currentNode].wakeupInterval * 1000.0) / 1000.0;
+                if (senders[currentNode].wakeupInterval < 0.02) {
+                    senders[currentNode].wakeupInterval = 0.02;
                 }
             }
             // re-calculate the total WUInt between 2 times receipt data packet
-            nodeSumWUInt[currentNode] = 0;
-            nodeIdle[currentNode][0] = idle;
-            nodeIdle[currentNode][1] = 0;
+            senders[currentNode].sumWUInt = 0;
+            senders[currentNode].idle[0] = idle;
+            senders[currentNode].idle[1] = 0;
         } else {
             // If we already calculated the WUInt convergent -> use this, don't need to calculate
-            if (nodeWakeupIntervalLock[currentNode] > 0) {
-                nodeWakeupInterval[currentNode] = nodeWakeupIntervalLock[currentNode];
+            if (senders[currentNode].wakeupIntervalLock > 0) {
+                senders[currentNode].wakeupInterval = senders[currentNode].wakeupIntervalLock;
                 //
-                nodeWakeupIntervalLock[currentNode] = 0;
+                senders[currentNode].wakeupIntervalLock = 0;
             } else {
-                nodeWakeupInterval[currentNode] += mu * sysClockFactor * sysClock;
-                nodeWakeupInterval[currentNode] = round(nodeWakeupInterval[currentNode] * 1000.0) / 1000.0;
-                if (nodeWakeupInterval[currentNode] < 0.02) {
-                    nodeWakeupInterval[currentNode] = 0.02;
+                senders[currentNode].wakeupInterval += mu * sysClockFactor * sysClock;
+                senders[currentNode].wakeupInterval = round(senders[currentNode].wakeupInterval * 1000.0) / 1000.0;
+                if (senders[currentNode].wakeupInterval < 0.02) {
+                    senders[currentNode].wakeupInterval = 0.02;
                 }
             }
         }
@@ -934,57 +941,57 @@ void TADMacLayer::calculateNextInterval(cMessage *msg) {
                     idle = double(mac->getIdle()) / 1000.0;
                     wbMiss = mac->getWbMiss();
                     mac = NULL;
-                    nodeIdle[currentNode][nodeIndex[currentNode]] = idle;
-                    nodeIndex[currentNode]++;
+                    senders[currentNode].idle[senders[currentNode].idleIndex] = idle;
+                    senders[currentNode].idleIndex++;
                 }
-                if (nodeIdle[currentNode][0] != 0 && nodeIdle[currentNode][1] != 0) {
-                    double WUInt_diff = (nodeIdle[currentNode][0] - nodeIdle[currentNode][1]) / 2;
+                if (senders[currentNode].idle[0] != 0 && senders[currentNode].idle[1] != 0) {
+                    double WUInt_diff = (senders[currentNode].idle[0] - senders[currentNode].idle[1]) / 2;
                     if (WUInt_diff * 100 != 0) {
-                        nodeWakeupIntervalLock[currentNode] = nodeWakeupInterval[currentNode] + WUInt_diff;
-    //                    cout << simTime() << "|" << nodeWakeupInterval[currentNode] << "|" << currentNode << "|" << WUInt_diff<< "|" << wbMiss<<endl;
-                        nodeWakeupInterval[currentNode] = (nodeWakeupIntervalLock[currentNode] - idle + sysClock * 2);
-                        if (nodeWakeupInterval[currentNode] < 0) {
-                            nodeWakeupInterval[currentNode] += nodeWakeupIntervalLock[currentNode];
+                        senders[currentNode].wakeupIntervalLock = senders[currentNode].wakeupInterval + WUInt_diff;
+    //                    cout << simTime() << "|" << senders[currentNode].wakeupInterval << "|" << currentNode << "|" << WUInt_diff<< "|" << wbMiss<<endl;
+                        senders[currentNode].wakeupInterval = (senders[currentNode].wakeupIntervalLock - idle + sysClock * 2);
+                        if (senders[currentNode].wakeupInterval < 0) {
+                            senders[currentNode].wakeupInterval += senders[currentNode].wakeupIntervalLock;
                             updateTSR(currentNode, 0);
                         }
-                        nodeFirstTime[currentNode]++;
+                        senders[currentNode].firstTime++;
                     }
-                    nodeIdle[currentNode][0] = nodeIdle[currentNode][1] = 0;
-                    nodeIndex[currentNode] = 0;
+                    senders[currentNode].idle[0] = senders[currentNode].idle[1] = 0;
+                    senders[currentNode].idleIndex = 0;
                 }
             } else {
-                if (nodeIndex[currentNode] == 1) {
-                    nodeIndex[currentNode]--;
+                if (senders[currentNode].idleIndex == 1) {
+                    senders[currentNode].idleIndex--;
                 }
-                if (nodeWakeupIntervalLock[currentNode] * 100 == 0) {
-                    nodeWakeupInterval[currentNode] += mu * sysClockFactor * sysClock;
-                    nodeWakeupInterval[currentNode] = round(nodeWakeupInterval[currentNode] * 1000.0) / 1000.0;
-                    if (nodeWakeupInterval[currentNode] < 0.02) {
-                        nodeWakeupInterval[currentNode] = 0.02;
+                if (senders[currentNode].wakeupIntervalLock * 100 == 0) {
+                    senders[currentNode].wakeupInterval += mu * sysClockFactor * sysClock;
+                    senders[currentNode].wakeupInterval = round(senders[currentNode].wakeupInterval * 1000.0) / 1000.0;
+                    if (senders[currentNode].wakeupInterval < 0.02) {
+                        senders[currentNode].wakeupInterval = 0.02;
                     }
                 } else {
-                    nodeWakeupInterval[currentNode] = nodeWakeupIntervalLock[currentNode];
+                    senders[currentNode].wakeupInterval = senders[currentNode].wakeupIntervalLock;
                 }
             }
 
-            if (nodeFirstTime[currentNode] == 2) {
-                nodeFirstTime[currentNode]++;
+            if (senders[currentNode].firstTime == 2) {
+                senders[currentNode].firstTime++;
             } else {
-                if (nodeFirstTime[currentNode] == 3) {
-                    nodeWakeupInterval[currentNode] = nodeWakeupIntervalLock[currentNode];
-                    nodeWakeupIntervalLock[currentNode] = 0;
-                    nodeFirstTime[currentNode] = 1;
+                if (senders[currentNode].firstTime == 3) {
+                    senders[currentNode].wakeupInterval = senders[currentNode].wakeupIntervalLock;
+                    senders[currentNode].wakeupIntervalLock = 0;
+                    senders[currentNode].firstTime = 1;
                 }
             }
         } else {
-            nodeWakeupInterval[currentNode] += mu * sysClockFactor * sysClock;
-            nodeWakeupInterval[currentNode] = round(nodeWakeupInterval[currentNode] * 1000.0) / 1000.0;
-            if (nodeWakeupInterval[currentNode] < 0.02) {
-                nodeWakeupInterval[currentNode] = 0.02;
+            senders[currentNode].wakeupInterval += mu * sysClockFactor * sysClock;
+            senders[currentNode].wakeupInterval = round(senders[currentNode].wakeupInterval * 1000.0) / 1000.0;
+            if (senders[currentNode].wakeupInterval < 0.02) {
+                senders[currentNode].wakeupInterval = 0.02;
             }
         }
     }
-    nextWakeupTime[currentNode] += nodeWakeupInterval[currentNode];
+    senders[currentNode].nextWakeupTime += senders[currentNode].wakeupInterval;
 }
 
 /**
@@ -26,6 +26,7 @@
 #include <vector>
 #include <list>
 #include <fstream>
+#include <cassert>
 
 #include "MiXiMDefs.h"
 #include "BaseMacLayer.h"
@@ -67,7 +68,8 @@ public:
                     txAttempts(0), droppedPacket(), nicId(-1), queueLength(0), animation(false),
                     bitrate(0), txPower(0),
                     useMacAcks(0), maxTxAttempts(0), stats(false), first_time(1), wakeupIntervalLook(0),
-                    logFileName("log.csv"), useCorrection(true), numberWakeup(0), sysClockFactor(75), numberSender(1),
+                    logFileName("log.csv"), singleLogFile(false), logBufferSize(65536),
+                    useCorrection(true), numberWakeup(0), sysClockFactor(75), numberSender(1),
                     startAt(0.001)
     {}
 
@@ -126,7 +128,7 @@ protected:
     };
     ROLES role;
 
-    int TSR[16];
+    /** @brief Length of the traffic status registers */
     int TSR_length;
     /** @brief store the moment wakeup, will be used to calculate the rest time */
     simtime_t start;
@@ -274,29 +276,100 @@ protected:
     double wakeupIntervalLook;
 
     const char *logFileName;
+    /** @brief Write the wake-up intervals of all senders into one file */
+    bool singleLogFile;
+    /** @brief Size of the memory buffer of every log file */
+    size_t logBufferSize;
     bool useCorrection;
     bool usePriority;
     bool useWBMiss;
     int numberWakeup;
     int sysClockFactor;
 
+    /**
+     * @brief Traffic status register: the history of the last wake-ups
+     * for a sender, 1 if data has been received, 0 otherwise.
+     *
+     * The values are kept in a fixed size ring buffer, so storing a new
+     * value does not move the older ones.
+     */
+    class TrafficStatusRegister {
+    public:
+        enum { MAX_LENGTH = 16 };
+
+    protected:
+        int values[MAX_LENGTH];
+        int length;
+        /** @brief Position of the oldest value */
+        int head;
+
+    public:
+        TrafficStatusRegister(int length = MAX_LENGTH) { reset(length); }
+
+        /** @brief Sets the length and all values to 0 */
+        void reset(int newLength) {
+            assert(newLength > 0 && newLength <= MAX_LENGTH);
+            length = newLength;
+            head = 0;
+            for (int i = 0; i < MAX_LENGTH; i++) {
+                values[i] = 0;
+            }
+        }
+
+        int size() const { return length; }
+
+        /** @brief Drops the oldest value and stores value as the latest one */
+        void push(int value) {
+            values[head] = value;
+            if (++head == length) {
+                head = 0;
+            }
+        }
+
+        /** @brief Returns the i-th value, 0 is the oldest, size() - 1 the latest one */
+        int operator[](int i) const {
+            i += head;
+            return values[(i < length) ? i : i - length];
+        }
+    };
+
+    /** @brief State the receiver keeps for every sender */
+    struct SenderState {
+        simtime_t nextWakeupTime;
+        double wakeupInterval;
+        double wakeupIntervalLock;
+        // used in new adaptive function
+        double sumWUInt;
+        double idle[2];
+        int idleIndex;
+        int firstTime;
+        int numberWakeup;
+        int priority;
+        /** @brief Scratch flag of scheduleNextWakeup() */
+        bool isCollision;
+        int collisions;
+        int choosen;
+        int broken;
+        TrafficStatusRegister tsr;
+        /** @brief MAC address of the sender */
+        LAddress::L2Type address;
+
+        SenderState(double initialInterval = 0, int tsrLength = TrafficStatusRegister::MAX_LENGTH) :
+                nextWakeupTime(), wakeupInterval(initialInterval), wakeupIntervalLock(0), sumWUInt(0),
+                idleIndex(0), firstTime(1), numberWakeup(0), priority(0), isCollision(false),
+                collisions(0), choosen(0), broken(0), tsr(tsrLength), address()
+        {
+            idle[0] = idle[1] = 0;
+        }
+    };
+
     /**
      * Define variable for multi sender
      */
     int numberSender;
     int currentNode;
-    double *nodeWakeupInterval;
-    double *nodeWakeupIntervalLock;
-    // used in new adaptive function
-    double *nodeSumWUInt;
-    int *nodeFirstTime;
-    simtime_t *nextWakeupTime;
-    double **nodeIdle;
-    int *nodeIndex;
-    int **TSR_bank;
-    int *nodeNumberWakeup;
-    int *nodePriority;
-    LAddress::L2Type *routeTable;
+    /** @brief State of the senders 1 to numberSender, senders[0] is no sender */
+    std::vector<SenderState> senders;
     LAddress::L2Type receiverAddress;
 
     static const int maxCCAattempts = 2;
@@ -305,14 +378,38 @@ protected:
     int wbMiss;
 
     int nbCollision;
-    int *nodeCollision;
-    int *nodeChoosen;
-    int *nodeBroken;
 
-    ofstream logFile;
-    ofstream log_tsr;
+    /**
+     * @brief Log file which stays open until finish() and writes its
+     * records in blocks of the size of its buffer.
+     */
+    class LogFile : public ofstream {
+    private:
+        LogFile(const LogFile&);
+        LogFile& operator=(const LogFile&);
+
+    protected:
+        std::vector<char> buffer;
+
+    public:
+        LogFile() : ofstream(), buffer() {}
+        /** @brief The buffer has to outlive the file. */
+        ~LogFile() { close(); }
+
+        /** @brief Opens the file for writing with a buffer of the passed size. */
+        void open(const std::string& name, size_t bufferSize);
+    };
+
+    LogFile logFile;
+    LogFile log_tsr;
+    /** @brief Wake-up interval logs of the senders, only the first one if singleLogFile is set */
+    std::vector<LogFile*> nodeLogs;
 
     void scheduleNextWakeup();
+    /** @brief Opens the wake-up interval logs of the senders */
+    void openNodeLogs();
+    /** @brief Flushes and closes the wake-up interval logs */
+    void closeNodeLogs();
     void writeLog();
     void updateTSR(int nodeId, int value);
 };
@@ -51,6 +51,8 @@ void csma::initialize(int stage) {
 
 		useMACAcks = par("useMACAcks").boolValue();
 		queueLength = par("queueLength");
+		// a full queue has always been detected one packet late
+		macQueue.setCapacity(queueLength + 1);
 		sifs = par("sifs");
 		transmissionAttemptInterruptedByRx = false;
 		nbTxFrames = 0;
@@ -158,6 +160,7 @@ void csma::finish() {
 		}
 		recordScalar("nbBackoffs", nbBackoffs);
 		recordScalar("backoffDurations", backoffValues);
+		macQueue.recordStatistics(this);
 	}
 	BaseMacLayer::finish();
 }
@@ -169,9 +172,9 @@ csma::~csma() {
 	cancelAndDelete(rxAckTimer);
 	if (ackMessage)
 		delete ackMessage;
-	MacQueue::iterator it;
-	for (it = macQueue.begin(); it != macQueue.end(); ++it) {
-		delete (*it);
+	while (!macQueue.empty()) {
+		delete macQueue.front();
+		macQueue.pop_front();
 	}
 }
 
@@ -215,8 +218,7 @@ void csma::handleUpperMsg(cMessage *msg) {
 void csma::updateStatusIdle(t_mac_event event, cMessage *msg) {
 	switch (event) {
 	case EV_SEND_REQUEST:
-		if (macQueue.size() <= queueLength) {
-			macQueue.push_back(static_cast<macpkt_ptr_t> (msg));
+		if (macQueue.push_back(static_cast<macpkt_ptr_t> (msg))) {
 			debugEV<<"(1) FSM State IDLE_1, EV_SEND_REQUEST and [TxBuff avail]: startTimerBackOff -> BACKOFF." << endl;
 			updateMacState(BACKOFF_2);
 			NB = 0;
@@ -568,8 +570,7 @@ void csma::updateStatusTransmitAck(t_mac_event event, cMessage *msg) {
 
 void csma::updateStatusNotIdle(cMessage *msg) {
 	debugEV<< "(20) FSM State NOT IDLE, EV_SEND_REQUEST. Is a TxBuffer available ?" << endl;
-	if (macQueue.size() <= queueLength) {
-		macQueue.push_back(static_cast<macpkt_ptr_t>(msg));
+	if (macQueue.push_back(static_cast<macpkt_ptr_t>(msg))) {
 		debugEV << "(21) FSM State NOT IDLE, EV_SEND_REQUEST"
 		<<" and [TxBuff avail]: enqueue packet and don't move." << endl;
 	} else {
@@ -34,6 +34,7 @@
 
 #include "MiXiMDefs.h"
 #include "BaseMacLayer.h"
+#include "BoundedMacQueue.h"
 #include "DroppedPacket.h"
 
 class MacPkt;
@@ -120,7 +121,7 @@ class MIXIM_API csma : public BaseMacLayer
     virtual void handleLowerControl(cMessage *msg);
 
   protected:
-    typedef std::list<macpkt_ptr_t> MacQueue;
+    typedef BoundedMacQueue<macpkt_ptr_t> MacQueue;
 
     /** @name Different tracked statistics.*/
     /*@{*/
@@ -25,9 +25,21 @@ void AdaptiveProbabilisticBroadcast::initialize(int stage)
         bvec.setName("Beta Vector");
 
 	    timeInNeighboursTable = par("timeInNeighboursTable");
+
+	    // spread the neighbor expiries over the first level of the wheel
+	    if (timeInNeighboursTable > SIMTIME_ZERO)
+	        neighTimers.setResolution(timeInNeighboursTable / 64);
+	    neighborTimer = new cMessage("neighborTimer", NEIGHBOR_TIMER);
 	}
 }
 
+void AdaptiveProbabilisticBroadcast::finish()
+{
+	cancelAndDelete(neighborTimer);
+	neighborTimer = NULL;
+	ProbabilisticBroadcast::finish();
+}
+
 void AdaptiveProbabilisticBroadcast::handleLowerMsg(cMessage* msg)
 {
 	ProbabilisticBroadcastPkt* m = check_and_cast<ProbabilisticBroadcastPkt*>(msg);
@@ -46,48 +58,45 @@ void AdaptiveProbabilisticBroadcast::updateNeighMap(ProbabilisticBroadcastPkt* m
 	//search for it in the "already-neighbors" map
 	NeighborMap::iterator it = neighMap.find(nodeAddress);
 
+	// the entry is removed after initT seconds
+	const simtime_t expiry = simTime() + timeInNeighboursTable;
+
 	//if the node is a "new" neighbor
 	if (it == neighMap.end()) {
 		EV << "updateNeighMap(): The message came from a new neighbor! " << endl;
 
-		// insert key value pair <node address, event> in neighborhood map.
-		cMessage *removeEvent = new cMessage("removeEvent", NEIGHBOR_TIMER);
-
-		// schedule the event to remove the entry after initT seconds
-		scheduleAt(simTime()+timeInNeighboursTable, removeEvent);
-
-		NeighborMap::value_type pairToInsert = make_pair(nodeAddress, removeEvent);
-		pair<NeighborMap::iterator, bool> ret = neighMap.insert(pairToInsert);
-
-		// set the context pointer to point to the integer that resembles to the address of
-		// the node to be removed when the corresponding event occurs
-		(ret.first)->second->setContextPointer((void*)(&(ret.first)->first));
-
+		// insert key value pair <node address, timer> in neighborhood map.
+		neighMap.insert(make_pair(nodeAddress, neighTimers.schedule(expiry, nodeAddress)));
 	}
 	//if the node is NOT a "new" neighbor update its timer
 	else {
 		EV << "updateNeighMap(): The message came from an already known neighbor! " << endl;
-        //cancel the event that was scheduled to remove the entry for this neighbor
-        cancelEvent(it->second);
-        // Define a new event in order to remove the entry after initT seconds
-        // Set the context pointer to point to the integer that resembles to the address of
-        // the node to be removed when the corresponding event occurs
-		it->second->setContextPointer((void*)(&it->first));
-
-		scheduleAt(simTime()+timeInNeighboursTable, it->second);
+		neighTimers.reschedule(it->second, expiry);
 	}
+	scheduleNeighborTimer();
 	updateBeta();
 }
 
+void AdaptiveProbabilisticBroadcast::scheduleNeighborTimer()
+{
+	// all neighbors have the same lifetime, so a new expiry is never earlier
+	// than a scheduled timer. If the timer fires before the next expiry
+	// because the neighbor has been updated, it is just scheduled again.
+	if (neighborTimer->isScheduled() || neighTimers.empty())
+		return;
+	scheduleAt(neighTimers.nextExpiry(), neighborTimer);
+}
+
 void AdaptiveProbabilisticBroadcast::handleSelfMsg(cMessage* msg)
 {
-	if (msg->getKind() == NEIGHBOR_TIMER) {
-		const NeighborMap::key_type& node = *static_cast<NeighborMap::key_type*>( msg->getContextPointer() );
-		EV << "handleSelfMsg(): Remove node "<< node <<" from NeighMap!" << endl;
-		NeighborMap::iterator it = neighMap.find(node);
-		cancelAndDelete(neighMap.find(it->first)->second);
-		neighMap.erase(it);
-		updateBeta();
+	if (msg == neighborTimer) {
+		NeighborMap::key_type node;
+		while (neighTimers.popExpired(simTime(), node)) {
+			EV << "handleSelfMsg(): Remove node "<< node <<" from NeighMap!" << endl;
+			neighMap.erase(node);
+			updateBeta();
+		}
+		scheduleNeighborTimer();
 	}
 	else {
 		ProbabilisticBroadcast::handleSelfMsg(msg);
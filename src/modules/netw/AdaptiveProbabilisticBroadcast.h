@@ -13,6 +13,7 @@
 #include "MiXiMDefs.h"
 #include "ProbabilisticBroadcast.h"
 #include "SimpleAddress.h"
+#include "TimerWheel.h"
 
 /**
  * @brief This class extends ProbabilisticBroadcast by adding
@@ -30,13 +31,18 @@ public:
         , timeInNeighboursTable()
         , bvec()
         , neighMap()
+        , neighTimers()
+        , neighborTimer(NULL)
     {}
 
     /** @brief Initialization of the module and some variables*/
     virtual void initialize(int);
 
+    virtual void finish();
+
 protected:
-    typedef std::map<LAddress::L3Type, cMessage*> NeighborMap;
+    typedef TimerWheel<LAddress::L3Type>                        NeighborTimers;
+    typedef std::map<LAddress::L3Type, NeighborTimers::handle_t> NeighborMap;
 
     /** @brief Handle messages from lower layer */
     virtual void handleLowerMsg(cMessage* msg);
@@ -46,12 +52,19 @@ protected:
 
     void updateNeighMap(ProbabilisticBroadcastPkt* m);
 
+    /** @brief Schedules the neighborTimer to the next expiry of a neighbor if it is idle.*/
+    void scheduleNeighborTimer();
+
     void updateBeta();
 
     //read from omnetpp.ini
     simtime_t   timeInNeighboursTable; ///< @brief Default ttl for NeighborTable entries in seconds
     cOutVector  bvec;
     NeighborMap neighMap;
+    /** @brief Expiry of every neighbor in neighMap.*/
+    NeighborTimers neighTimers;
+    /** @brief Removes the expired neighbors, the only timer for all neighbors.*/
+    cMessage*   neighborTimer;
 };
 
 #endif /* ADAPTIVEPROBABILISTICBROADCAST_H_ */
@@ -59,6 +59,9 @@ void Flood::initialize(int stage) {
 			hasPar("bcDelTime") ? bcDelTime = par("bcDelTime").doubleValue() : bcDelTime = 3.0;
 			EV <<"bcMaxEntries = "<<bcMaxEntries
 			<<" bcDelTime = "<<bcDelTime<<endl;
+
+			bcMsgs.setMaxEntries(bcMaxEntries);
+			bcMsgs.setLifetime(bcDelTime);
 		}
 	}
 }
@@ -89,8 +92,8 @@ void Flood::finish() {
  * message will not be rebroadcasted, if a copy will be flooded back
  * from the neigbouring nodes.
  *
- * If the maximum number of entries is reached the first (oldest) entry
- * is deleted.
+ * If the maximum number of entries is reached the entry which would
+ * expire next is deleted.
  **/
 void Flood::handleUpperMsg(cMessage* m) {
 
@@ -102,24 +105,7 @@ void Flood::handleUpperMsg(cMessage* m) {
 	msg->setTtl(defaultTtl);
 
 	if (plainFlooding) {
-		if (bcMsgs.size() >= bcMaxEntries) {
-			cBroadcastList::iterator it;
-
-			//serach the broadcast list of outdated entries and delete them
-			for (it = bcMsgs.begin(); it != bcMsgs.end(); ++it) {
-				if (it->delTime < simTime()) {
-					bcMsgs.erase(it);
-					it--;
-					break;
-				}
-			}
-			//delete oldest entry if max size is reached
-			if (bcMsgs.size() >= bcMaxEntries) {
-				EV<<"bcMsgs is full, delete oldest entry"<<endl;
-				bcMsgs.pop_front();
-			}
-		}
-		bcMsgs.push_back(Bcast(msg->getSeqNum(), msg->getSrcAddr(), simTime() +bcDelTime));
+		bcMsgs.insert(BcastId(msg->getSrcAddr(), msg->getSeqNum()));
     }
 				//there is no routing so all messages are broadacst for the mac layer
 
@@ -202,43 +188,20 @@ void Flood::handleLowerMsg(cMessage* m) {
 }
 
 /**
- * The bcMsgs list is searched for the arrived message. If the message
- * is in the list, it was already broadcasted and the function returns
+ * The bcMsgs table is searched for the arrived message. If the message
+ * is in the table, it was already broadcasted and the function returns
  * false.
  *
  * Concurrently all outdated (older than bcDelTime) are deleted. If
- * the list is full and a new message has to be entered, the oldest
- * entry is deleted.
+ * the table is full and a new message has to be entered, the entry
+ * which would expire next is deleted.
  **/
 bool Flood::notBroadcasted(netwpkt_ptr_t msg) {
 	if (!plainFlooding)
 		return true;
 
-	cBroadcastList::iterator it;
-
-	//serach the broadcast list of outdated entries and delete them
-	for (it = bcMsgs.begin(); it != bcMsgs.end(); it++) {
-		if (it->delTime < simTime()) {
-			bcMsgs.erase(it);
-			it--;
-		}
-		//message was already broadcasted
-		if ((it->srcAddr == msg->getSrcAddr()) && (it->seqNum
-				== msg->getSeqNum())) {
-			// update entry
-			it->delTime = simTime() + bcDelTime;
-			return false;
-		}
-	}
-
-	//delete oldest entry if max size is reached
-	if (bcMsgs.size() >= bcMaxEntries) {
-		EV<<"bcMsgs is full, delete oldest entry\n";
-		bcMsgs.pop_front();
-	}
-
-	bcMsgs.push_back(Bcast(msg->getSeqNum(), msg->getSrcAddr(), simTime() +bcDelTime));
-    return true;
+	// a known message gets its entry updated
+	return bcMsgs.insert(BcastId(msg->getSrcAddr(), msg->getSeqNum()));
 }
 
 Flood::netwpkt_ptr_t Flood::encapsMsg(cPacket *appPkt) {
@@ -23,20 +23,21 @@
 #ifndef _FLOOD_H_
 #define _FLOOD_H_
 
-#include <list>
+#include <utility>
 
 #include "MiXiMDefs.h"
 #include "BaseNetwLayer.h"
 #include "SimpleAddress.h"
+#include "DuplicateCache.h"
 
 /**
  * @brief A simple flooding protocol
  *
  * This implementation uses plain flooding, i.e. it "remembers"
- * (stores) already broadcasted messages in a list and does not
+ * (stores) already broadcasted messages in a hash table and does not
  * rebroadcast them again, if it gets another copy of that message.
  *
- * The maximum number of entires for that list can be defined in the
+ * The maximum number of entries for that table can be defined in the
  * .ini file (@ref bcMaxEntries) as well as the time after which an entry
  * is deleted (@ref bcDelTime).
  *
@@ -60,25 +61,17 @@ protected:
     /** @brief Defines whether to use plain flooding or not*/
     bool plainFlooding;
 
-    class Bcast {
-    public:
-        unsigned long    seqNum;
-        LAddress::L3Type srcAddr;
-        simtime_t        delTime;
-    public:
-        Bcast(unsigned long n=0, const LAddress::L3Type& s = LAddress::L3NULL,  simtime_t_cref d=SIMTIME_ZERO) :
-            seqNum(n), srcAddr(s), delTime(d) {
-        }
-    };
+    /** @brief Identifies a broadcast by its source address and sequence number*/
+    typedef std::pair<LAddress::L3Type, unsigned long> BcastId;
 
-    typedef std::list<Bcast> cBroadcastList;
+    typedef DuplicateCache<BcastId> cBroadcastList;
 
-    /** @brief List of already broadcasted messages*/
+    /** @brief Ids of already broadcasted messages*/
     cBroadcastList bcMsgs;
 
     /**
      * @brief Max number of entries in the list of already broadcasted
-     * messages
+     * messages, 0 for unbounded
      **/
     unsigned int bcMaxEntries;
 
@@ -224,18 +224,12 @@ void ProbabilisticBroadcast::finish()
 
 bool ProbabilisticBroadcast::messageKnown(unsigned int msgId)
 {
-	MsgIdSet::iterator pos;
-
-	pos = knownMsgIds.find(msgId);
-	return pos != knownMsgIds.end();
+	return knownMsgIds.contains(msgId);
 }
 
 bool ProbabilisticBroadcast::debugMessageKnown(unsigned int msgId)
 {
-	MsgIdSet::iterator pos;
-
-	pos = debugMsgIdSet.find(msgId);
-	return pos != debugMsgIdSet.end();
+	return debugMsgIdSet.contains(msgId);
 }
 
 void ProbabilisticBroadcast::insertMessage(simtime_t_cref bcastDelay, tMsgDesc* msgDesc)
@@ -8,10 +8,10 @@
 #ifndef PROBABILISTICBROADCAST_H_
 #define PROBABILISTICBROADCAST_H_
 
-#include <set>
 #include <map>
 
 #include "MiXiMDefs.h"
+#include "DuplicateCache.h"
 #include "ProbabilisticBroadcastPkt_m.h"
 #include "BaseNetwLayer.h"
 
@@ -82,7 +82,7 @@ protected:
 		                                        // time by its creator.
 	} tMsgDesc;
 
-	typedef std::set<unsigned int> MsgIdSet;
+	typedef DuplicateCache<unsigned int> MsgIdSet;
 	typedef std::multimap<simtime_t, tMsgDesc*> TimeMsgMap;
 
 	/** @brief Handle messages from upper layer */
@@ -197,7 +197,7 @@ protected:
     // perform broadcast attempt for the first message in the list each time it expires
     cMessage* broadcastTimer;
 
-    // we use two containers: a set which stores the ID's of the messages which are kept
+    // we use two containers: a hash set which stores the ID's of the messages which are kept
     // in memory and a multimap which stores a pair <Key, Value> where Key is the next
     // broadcasting attempt time of the message and Value is a pointer to the message
     // (see typedef's above).
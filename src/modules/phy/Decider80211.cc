@@ -58,7 +58,7 @@ double Decider80211::getFrameReceivingPower(airframe_ptr_t frame) const
 	argStart.setTime(MappingUtils::post(signal.getReceptionStart()));
 	argStart.setArgValue(Dimension::frequency, centerFrequency);
 
-	return signal.getReceivingPower()->getValue(argStart);
+	return signal.getReceivingPower(argStart);
 }
 
 BaseDecider::channel_sense_rssi_t Decider80211::calcChannelSenseRSSI(simtime_t_cref start, simtime_t_cref end) const {
@@ -78,9 +78,6 @@ DeciderResult* Decider80211::createResult(const airframe_ptr_t frame) const
 	// i.e. the Decider has received it correctly
 
 	// first collect all necessary information
-	Mapping* snrMap = calculateSnrMapping(frame);
-	assert(snrMap);
-
 	const Signal& s     = frame->getSignal();
 	simtime_t     start = s.getReceptionStart();
 	simtime_t     end   = s.getReceptionEnd();
@@ -91,7 +88,11 @@ DeciderResult* Decider80211::createResult(const airframe_ptr_t frame) const
 	Argument argMin(getLowerBandFrequency(start));
 	Argument argMax(getUpperBandFrequency(end));
 
-	Mapping::argument_value_t snirMin = MappingUtils::findMin(*snrMap, argMin, argMax, Argument::MappedZero /* the value if no minimum will be found */);
+	MappingUtils::QuotientStats snrStats;
+	Mapping::argument_value_t   snirMin = Argument::MappedZero; /* the value if no minimum will be found */
+	if(calculateSnrStatistics(frame, argMin, argMax, snrStats)) {
+		snirMin = snrStats.min;
+	}
 
 	deciderEV << " snrMin: " << snirMin << endl;
 
@@ -114,9 +115,6 @@ DeciderResult* Decider80211::createResult(const airframe_ptr_t frame) const
 		result = new DeciderResult80211(false, payloadBitrate, snirMin);
 	}
 
-	delete snrMap;
-	snrMap = 0;
-
 	return result;
 }
 
@@ -8,6 +8,7 @@
 #include "Decider802154Narrow.h"
 
 #include <cmath>
+#include <limits>
 
 #ifdef MIXIM_INET
 #include <INETDefs.h>
@@ -25,6 +26,17 @@
 #include "MiXiMAirFrame.h"
 #include "Mapping.h"
 
+Decider802154Narrow::BERTables Decider802154Narrow::berTables;
+
+bool Decider802154Narrow::BERTableKey::operator<(const BERTableKey& o) const {
+	if(modulation != o.modulation) return modulation < o.modulation;
+	if(berFloor   != o.berFloor)   return berFloor   < o.berFloor;
+	if(minSnr     != o.minSnr)     return minSnr     < o.minSnr;
+	if(maxSnr     != o.maxSnr)     return maxSnr     < o.maxSnr;
+	if(resolution != o.resolution) return resolution < o.resolution;
+	return maxError < o.maxError;
+}
+
 bool Decider802154Narrow::initFromMap(const ParameterMap& params) {
     bool                         bInitSuccess = true;
     ParameterMap::const_iterator it           = params.find("sfdLength");
@@ -45,7 +57,17 @@ bool Decider802154Narrow::initFromMap(const ParameterMap& params) {
     }
     it = params.find("modulation");
     if(it != params.end()) {
-        modulation = ParameterMap::mapped_type(it->second).stringValue();
+        const std::string sModulation = ParameterMap::mapped_type(it->second).stringValue();
+        if(sModulation == "msk") {
+            modulation = MSK;
+        } else if(sModulation == "oqpsk16") {
+            modulation = OQPSK16;
+        } else if(sModulation == "gfsk") {
+            modulation = GFSK;
+        } else {
+            bInitSuccess = false;
+            opp_warning("The selected modulation \"%s\" is not supported by Decider802154Narrow!", sModulation.c_str());
+        }
     }
     else {
         bInitSuccess = false;
@@ -55,9 +77,87 @@ bool Decider802154Narrow::initFromMap(const ParameterMap& params) {
     if(it != params.end()) {
         recordStats = ParameterMap::mapped_type(it->second).boolValue();
     }
+
+    double minSnr     = -10.0;
+    double maxSnr     = 20.0;
+    double resolution = 0;
+    double maxError   = 1e-3;
+    it = params.find("berTableMinSnr");
+    if(it != params.end()) {
+        minSnr = ParameterMap::mapped_type(it->second).doubleValue();
+    }
+    it = params.find("berTableMaxSnr");
+    if(it != params.end()) {
+        maxSnr = ParameterMap::mapped_type(it->second).doubleValue();
+    }
+    it = params.find("berTableResolution");
+    if(it != params.end()) {
+        resolution = ParameterMap::mapped_type(it->second).doubleValue();
+    }
+    it = params.find("berTableMaxError");
+    if(it != params.end()) {
+        maxError = ParameterMap::mapped_type(it->second).doubleValue();
+    }
+    if(modulation != UNKNOWN_MODULATION) {
+        berTable = getBERTable(modulation, BER_LOWER_BOUND, minSnr, maxSnr, resolution, maxError);
+    }
     return BaseDecider::initFromMap(params) && bInitSuccess;
 }
 
+const Decider802154Narrow::BERTable* Decider802154Narrow::getBERTable(Modulation modulation, double berFloor,
+                                                                      double minSnr, double maxSnr, double resolution, double maxError) {
+	if(resolution <= 0 || maxSnr <= minSnr) {
+		return NULL;
+	}
+
+	// smaller BERs are treated as zero, the formulas underflow long before
+	// the smallest double anyway
+	const BERTableKey   key   = { modulation, std::max(berFloor, 1e-100), minSnr, maxSnr, resolution, maxError };
+	BERTables::iterator it    = berTables.lower_bound(key);
+	if(it == berTables.end() || key < it->first) {
+		it = berTables.insert(it, std::make_pair(key, BERTable()));
+		buildBERTable(it->second, modulation, key.berFloor, minSnr, maxSnr, resolution, maxError);
+	}
+	return &it->second;
+}
+
+void Decider802154Narrow::buildBERTable(BERTable& table, Modulation modulation, double berFloor,
+                                        double minSnr, double maxSnr, double resolution, double maxError) {
+	double step  = resolution;
+	double worst = 0;
+	for(;;) {
+		const size_t entries = static_cast<size_t>(ceil((maxSnr - minSnr) / step)) + 1;
+
+		// all BERs decrease with the SNR, so the table can end at the first
+		// entry which reaches the BER floor
+		table.logBER.clear();
+		table.floored = false;
+		for(size_t i = 0; i < entries && !table.floored; ++i) {
+			const double ber = calcBERFromSNR(modulation, pow(10.0, (minSnr + i * step) / 10.0));
+			table.logBER.push_back(log(std::max(ber, std::numeric_limits<double>::min())));
+			table.floored = (ber <= berFloor);
+		}
+
+		// the error of the (logarithmic) linear interpolation is largest
+		// in the middle of an interval
+		worst = 0;
+		for(size_t i = 0; i + 1 < table.logBER.size(); ++i) {
+			const double exact  = std::max(calcBERFromSNR(modulation, pow(10.0, (minSnr + (i + 0.5) * step) / 10.0)), berFloor);
+			const double interp = std::max(exp(0.5 * (table.logBER[i] + table.logBER[i + 1])), berFloor);
+			worst = std::max(worst, fabs(interp - exact) / exact);
+		}
+		if(worst <= maxError || step < resolution / 1024) {
+			break;
+		}
+		step /= 2;
+	}
+	if(worst > maxError) {
+		opp_warning("Decider802154Narrow: BER table reaches a relative error of only %g.", worst);
+	}
+	table.minSnr = minSnr;
+	table.step   = step;
+}
+
 bool Decider802154Narrow::syncOnSFD(airframe_ptr_t frame) const {
 	double BER;
 	double sfdErrorProbability;
@@ -72,7 +172,7 @@ double Decider802154Narrow::evalBER(airframe_ptr_t frame) const {
 	Signal&       signal     = frame->getSignal();
 	simtime_t     time       = MappingUtils::post(phy->getSimTime());
     Argument      argStart(time);
-	double        rcvPower   = signal.getReceivingPower()->getValue(argStart);
+	double        rcvPower   = signal.getReceivingPower(argStart);
 
 	if (rcvPower == Argument::MappedZero) {
 	    return 1.0;
@@ -212,11 +312,31 @@ double Decider802154Narrow::n_choose_k(int n, int k) {
 }
 
 double Decider802154Narrow::getBERFromSNR(double snr) const {
-	double ber = BER_LOWER_BOUND;
-	if(modulation == "msk") {
+	if(berTable && snr > 0) {
+		// the SNR is a ratio of powers, not a power in mW
+		const std::vector<double>& logBER = berTable->logBER;
+		const double               pos    = (10.0 * log10(snr) - berTable->minSnr) / berTable->step;
+		const double               last   = logBER.size() - 1;
+		if(pos >= 0 && pos < last) {
+			const size_t i    = static_cast<size_t>(pos);
+			const double frac = pos - i;
+			return std::max(exp(logBER[i] + frac * (logBER[i + 1] - logBER[i])), BER_LOWER_BOUND);
+		}
+		if(pos >= last && berTable->floored) {
+			return BER_LOWER_BOUND;
+		}
+	}
+	return std::max(calcBERFromSNR(modulation, snr), BER_LOWER_BOUND);
+}
+
+double Decider802154Narrow::calcBERFromSNR(Modulation modulation, double snr) {
+	double ber = 0.5;
+	switch(modulation) {
+	case MSK:
 		// valid for IEEE 802.15.4 868 MHz BPSK modulation
 		ber = 0.5 *  ERFC(sqrt(snr));
-	} else if (modulation == "oqpsk16") {
+		break;
+	case OQPSK16: {
 		// valid for IEEE 802.15.4 2.45 GHz OQPSK modulation
 		// Following formula is defined in IEEE 802.15.4 standard, please check the 
 		// 2006 standard, page 268, section E.4.1.8 Bit error rate (BER) 
@@ -245,13 +365,17 @@ double Decider802154Narrow::getBERFromSNR(double snr) const {
 		// for k = 16 (because of missing k=0 value)
 		k   = 16; dSumK += n_choose_k(16, k) * exp(dSNRFct * (1.0 / k - 1.0));
 		ber = (8.0 / 15) * (1.0 / 16) * dSumK;
-	} else if(modulation == "gfsk") {
+		break;
+	}
+	case GFSK:
 		// valid for Bluetooth 4.0 PHY mandatory base rate 1 Mbps
 		// Please note that this is not the correct expression for
 		// the enhanced data rates (EDR), which uses another modulation.
 		ber = 0.5 * ERFC(sqrt(0.5 * snr));
-	} else {
+		break;
+	default:
 		opp_error("The selected modulation is not supported.");
+		break;
 	}
-	return std::max(ber, BER_LOWER_BOUND);
+	return ber;
 }
@@ -8,6 +8,9 @@
 #ifndef DECIDER802154NARROW_H_
 #define DECIDER802154NARROW_H_
 
+#include <map>
+#include <vector>
+
 #include "MiXiMDefs.h"
 #include "BaseDecider.h"
 
@@ -24,7 +27,58 @@ public:
 		RECEPTION_STARTED=LAST_BASE_DECIDER_CONTROL_KIND,
 		LAST_DECIDER802154NARROW_CONTROL_KIND
 	};
+
+	/** @brief Supported modulation types.*/
+	enum Modulation {
+		/** @brief IEEE 802.15.4 868 MHz BPSK ("msk").*/
+		MSK,
+		/** @brief IEEE 802.15.4 2.45 GHz OQPSK ("oqpsk16").*/
+		OQPSK16,
+		/** @brief Bluetooth 4.0 base rate ("gfsk").*/
+		GFSK,
+		/** @brief No or an unsupported modulation was configured.*/
+		UNKNOWN_MODULATION
+	};
+
+	/**
+	 * @brief Natural logarithm of the BER for equidistant SNR values.
+	 *
+	 * Entry i of logBER holds the BER for an SNR of minSnr + i * step dB.
+	 */
+	struct BERTable {
+		std::vector<double> logBER;
+		/** @brief SNR of the first entry in dB.*/
+		double              minSnr;
+		/** @brief Distance between two entries in dB.*/
+		double              step;
+		/**
+		 * @brief True if the last entry reached the BER floor, so all
+		 * higher SNRs have a BER of the floor.
+		 */
+		bool                floored;
+
+		BERTable(): logBER(), minSnr(0), step(0), floored(false) {}
+	};
+
 protected:
+	/** @brief Parameters a BER table is built from.*/
+	struct BERTableKey {
+		Modulation modulation;
+		double     berFloor, minSnr, maxSnr, resolution, maxError;
+
+		bool operator<(const BERTableKey& o) const;
+	};
+
+	typedef std::map<BERTableKey, BERTable> BERTables;
+
+	/**
+	 * @brief BER tables of all deciders, built on first use.
+	 *
+	 * The tables only depend on their parameters, so deciders with the same
+	 * configuration share one table.
+	 */
+	static BERTables berTables;
+
 	/** @brief Start Frame Delimiter length in bits. */
 	int sfdLength;
 
@@ -33,8 +87,11 @@ protected:
 		the performance. */
 	double BER_LOWER_BOUND;
 
-	/** @brief modulation type */
-	std::string modulation;
+	/** @brief modulation type, resolved from its name at initialization */
+	Modulation modulation;
+
+	/** @brief The shared BER table, NULL if no table is used.*/
+	const BERTable* berTable;
 
 	/** log minimum snir values of dropped packets */
 	cOutVector snirDropped;
@@ -74,8 +131,25 @@ protected:
 	 */
 	virtual DeciderResult* createResult(const airframe_ptr_t frame) const;
 
+	/**
+	 * @brief Returns the BER for the passed SNR.
+	 *
+	 * Interpolates the BER table if the SNR lies inside of it, otherwise
+	 * the analytical formula is evaluated.
+	 */
 	double getBERFromSNR(double snr) const;
 
+	/**
+	 * @brief Fills a BER table for SNRs between minSnr and maxSnr dB.
+	 *
+	 * Starts with entries "resolution" dB apart and halves the distance
+	 * until the relative error of the interpolation, checked in the middle
+	 * of every interval, is at most maxError. BERs below berFloor count as
+	 * berFloor.
+	 */
+	static void buildBERTable(BERTable& table, Modulation modulation, double berFloor,
+	                          double minSnr, double maxSnr, double resolution, double maxError);
+
 	bool   syncOnSFD(airframe_ptr_t frame) const;
 
 	double evalBER(airframe_ptr_t frame) const;
@@ -87,6 +161,21 @@ public:
 	/** @brief Helper function to compute BER from SNR using analytical formulas */
 	static double n_choose_k(int n, int k);
 
+	/**
+	 * @brief Evaluates the analytical BER formula of a modulation for the
+	 * passed SNR (not in dB) without applying a lower bound.
+	 */
+	static double calcBERFromSNR(Modulation modulation, double snr);
+
+	/**
+	 * @brief Returns the shared BER table for the passed parameters, built
+	 * on the first call.
+	 *
+	 * @return NULL if resolution is 0 or the SNR range is empty.
+	 */
+	static const BERTable* getBERTable(Modulation modulation, double berFloor,
+	                                   double minSnr, double maxSnr, double resolution, double maxError);
+
 	/** @brief Standard Decider constructor.
 	 */
 	Decider802154Narrow( DeciderToPhyInterface* phy
@@ -96,7 +185,8 @@ public:
 	    : BaseDecider(phy, sensitivity, myIndex, debug)
 	    , sfdLength(0)
 	    , BER_LOWER_BOUND(0)
-	    , modulation("")
+	    , modulation(UNKNOWN_MODULATION)
+	    , berTable(NULL)
 	    , snirDropped()
 	    , snirReceived()
 	    , snrlog()
@@ -113,6 +203,13 @@ public:
 	 *
 	 * This method should be defined for generic decider initialization.
 	 *
+	 * Besides the mandatory parameters the optional parameters
+	 * "berTableResolution" (initial distance of the BER table entries in
+	 * dB, default 0 which disables the table), "berTableMinSnr" and
+	 * "berTableMaxSnr" (range of the table in dB, default -10 and 20) and
+	 * "berTableMaxError" (maximum relative interpolation error, default
+	 * 1e-3) are read.
+	 *
 	 * @param params The parameter map which was filled by XML reader.
 	 *
 	 * @return true if the initialization was successfully.
@@ -1,5 +1,7 @@
 #include "DeciderUWBIRED.h"
 
+#include <algorithm>
+
 #include "PhyLayerUWBIR.h"
 #include "AirFrameUWBIR_m.h"
 #include "DeciderResultUWBIR.h"
@@ -225,7 +227,6 @@ std::pair<bool, double> DeciderUWBIRED::decodePacket(const airframe_ptr_t frame,
 	aSymbol = cfg.data_symbol_duration;
 	burst   = cfg.burst_duration;
 	now     = offset + cfg.pulse_duration / 2;
-	std::pair<double, double> energyZero, energyOne;
 	IEEE802154A::setConfig(cfg);
 
 	// debugging information (start)
@@ -248,23 +249,102 @@ std::pair<bool, double> DeciderUWBIRED::decodePacket(const airframe_ptr_t frame,
 	}
 	// debugging information (end)
 
+	// Collect the pulse peak sample times of window zero and window one
+	// of every data symbol, windowStarts[2*symbol + bit] is the index of
+	// the first sample of a window.
+	vector<simtime_t> sampleTimes;
+	vector<size_t>    windowStarts;
 	int symbol;
-	// Loop to decode each bit value
 	for (symbol = 0; cfg.preambleLength + symbol * aSymbol < FrameSignal.getDuration(); symbol++) {
+		// sample in window zero
+		now = now + IEEE802154A::getHoppingPos(symbol)*cfg.burst_duration;
+		windowStarts.push_back(sampleTimes.size());
+		addWindowSamples(now, burst, cfg, sampleTimes);
+		// sample in window one
+		now = now + shift;
+		windowStarts.push_back(sampleTimes.size());
+		addWindowSamples(now, burst, cfg, sampleTimes);
+
+		now = offset + (symbol + 1) * aSymbol + cfg.pulse_duration / 2;
+	}
+	const int    nbDataSymbols = symbol;
+	const size_t nbSamples     = sampleTimes.size();
+	windowStarts.push_back(nbSamples);
+
+	// Evaluate the received power of every frame at all sample times in one
+	// sweep and draw the random values in the order of a sample by sample
+	// evaluation: one random phase per interferer, then the thermal noise.
+	const size_t          nbFrames = airFrameVector.size();
+	vector< vector<double> > framePowers(nbFrames, vector<double>(nbSamples, 0.0));
+	vector< vector<double> > phases(nbFrames);
+	vector<bool>          isTracked(nbFrames, false);
+	vector<double>        noise(nbSamples);
+	AirFrameVector::const_iterator airFrameIter = airFrameVector.begin();
+	for (size_t f = 0; f < nbFrames; ++f, ++airFrameIter) {
+		const Signal& aSignal = (*airFrameIter)->getSignal();
+		sampleReceivingPower(aSignal, sampleTimes, framePowers[f]);
+		isTracked[f] = (aSignal.getReceivingPower() == signalPower);
+		if (!isTracked[f])
+			phases[f].resize(nbSamples);
+	}
+	for (size_t i = 0; i < nbSamples; ++i) {
+		for (size_t f = 0; f < nbFrames; ++f) {
+			if (!isTracked[f])
+				phases[f][i] = uniform(-1, +1); // take a random point within pulse envelope for interferer
+		}
+		noise[i] = getNoiseValue();
+	}
 
-//		int hoppingPos = IEEE802154A::getHoppingPos(symbol);
+	// Triangular baseband pulses: combine the electric fields of all frames
+	// at each pulse peak, the interferers with a random phase
+	vector<double> signalValues(nbSamples, 0.0); // electric field from tracked signal [V/m²]
+	vector<double> resPowers(nbSamples, 0.0);    // electric field at antenna = combination of all arriving electric fields [V/m²]
+	for (size_t f = 0; f < nbFrames; ++f) {
+		const double *const powers = &framePowers[f][0];
+		if (isTracked[f]) {
+			for (size_t i = 0; i < nbSamples; ++i) {
+				// we capture half of the maximum possible pulse energy to account for self interference
+				signalValues[i] = powers[i]*peakPulsePower*0.5; //TODO: de-normalize (peakPulsePower should be in AirFrame or in Signal, to be set at run-time)
+				resPowers[i]    = resPowers[i] + signalValues[i];
+			}
+		}
+		else {
+			const double *const phase = &phases[f][0];
+			for (size_t i = 0; i < nbSamples; ++i) {
+				resPowers[i] = resPowers[i] + powers[i]*peakPulsePower * phase[i];
+			}
+		}
+	}
+
+	// voltage measured by the energy-detector to the square [V²], including thermal noise,
+	// and signal converted to antenna voltage squared
+	vector<double> vmeasured_square(nbSamples);
+	vector<double> snirs(nbSamples);
+	for (size_t i = 0; i < nbSamples; ++i) {
+		const double vmeasured = sqrt(50*resPowers[i]) + noise[i]; // P=V²/R
+		vmeasured_square[i]    = vmeasured * vmeasured;
+		snirs[i]               = signalValues[i] / 2.0217E-12;
+	}
+
+	// Loop to decode each bit value
+	for (symbol = 0; symbol < nbDataSymbols; symbol++) {
+		// first value is SNIR, second is total captured window energy
+		std::pair<double, double> energyZero = std::make_pair(0.0, 0.0);
+		std::pair<double, double> energyOne  = std::make_pair(0.0, 0.0);
 		int decodedBit;
 
 		if (stats) {
 			nbSymbols = nbSymbols + 1;
 		}
 
-		// sample in window zero
-		now = now + IEEE802154A::getHoppingPos(symbol)*cfg.burst_duration;
-		energyZero = integrateWindow(symbol, now, burst, airFrameVector, signalPower, frame, cfg);
-		// sample in window one
-		now = now + shift;
-		energyOne  = integrateWindow(symbol, now, burst, airFrameVector, signalPower, frame, cfg);
+		for (size_t i = windowStarts[2*symbol]; i < windowStarts[2*symbol + 1]; ++i) {
+			energyZero.second = energyZero.second + vmeasured_square[i];
+			energyZero.first  = energyZero.first  + snirs[i];
+		}
+		for (size_t i = windowStarts[2*symbol + 1]; i < windowStarts[2*symbol + 2]; ++i) {
+			energyOne.second  = energyOne.second + vmeasured_square[i];
+			energyOne.first   = energyOne.first  + snirs[i];
+		}
 
 		if (energyZero.second > energyOne.second) {
 		  decodedBit = 0;
@@ -277,9 +357,6 @@ std::pair<bool, double> DeciderUWBIRED::decodePacket(const airframe_ptr_t frame,
 
 		receivedBits->push_back(static_cast<bool>(decodedBit));
 		//packetSamples = packetSamples + 16; // 16 EbN0 evaluations per bit
-
-		now = offset + (symbol + 1) * aSymbol + cfg.pulse_duration / 2;
-
 	}
 	symbol = symbol + 1;
 
@@ -295,75 +372,60 @@ std::pair<bool, double> DeciderUWBIRED::decodePacket(const airframe_ptr_t frame,
 	return std::make_pair(isCorrect, snrLastPacket);
 }
 
-/*
- * @brief Returns a pair with as first value the SNIR (if the signal is not nul in this window, and 0 otherwise)
- * and as second value a "score" associated to this window. This score is equals to the sum for all
- * 16 pulse peak positions of the voltage measured by the receiver ADC.
- */
-pair<double, double> DeciderUWBIRED::integrateWindow( int                        /*symbol*/
-                                                    , simtime_t_cref             pNow
-                                                    , simtime_t_cref             burst
-                                                    , const AirFrameVector&      airFrameVector
-                                                    , const ConstMapping *const  signalPower
-                                                    , const airframe_ptr_t       /*frame*/
-                                                    , const IEEE802154A::config& cfg) {
-	std::pair<double, double>       energy = std::make_pair(0.0, 0.0); // first: stores SNIR, second: stores total captured window energy
-	vector<ConstMapping*>::iterator mappingIter;
-	Argument                        arg;
-	simtime_t                       windowEnd = pNow + burst;
-
-	// Triangular baseband pulses
-	// we sample at each pulse peak
-	// get the interpolated values of amplitude for each interferer
-	// and add these to the peak with a random phase
-
+void DeciderUWBIRED::addWindowSamples( simtime_t_cref             pNow
+                                     , simtime_t_cref             burst
+                                     , const IEEE802154A::config& cfg
+                                     , vector<simtime_t>&         sampleTimes ) {
 	// we sample one point per pulse
 	// caller has already set our time reference ("now") at the peak of the pulse
+	const simtime_t windowEnd = pNow + burst;
 	for (simtime_t now = pNow; now < windowEnd; now += cfg.pulse_duration) {
-		double signalValue      = 0; // electric field from tracked signal [V/m²]
-		double resPower         = 0; // electric field at antenna = combination of all arriving electric fields [V/m²]
-		double vEfield          = 0; // voltage at antenna caused by electric field Efield [V]
-		double vmeasured        = 0; // voltage measured by energy-detector [V], including thermal noise
-		double vmeasured_square = 0; // to the square [V²]
-		double snir             = 0; // burst SNIR estimate
-		double vThermalNoise    = 0; // thermal noise realization
-		int    currSig          = 0;
-
-		arg.setTime(now);
-		// consider all interferers at this point in time
-		for (AirFrameVector::const_iterator airFrameIter = airFrameVector.begin(); airFrameIter != airFrameVector.end(); ++airFrameIter) {
-			Signal&                   aSignal   = (*airFrameIter)->getSignal();
-			const ConstMapping *const currPower = aSignal.getReceivingPower();
-			double                    measure   = currPower->getValue(arg)*peakPulsePower; //TODO: de-normalize (peakPulsePower should be in AirFrame or in Signal, to be set at run-time)
-//			measure = measure * uniform(0, +1); // random point of Efield at sampling (due to pulse waveform and self interference)
-			if (currPower == signalPower) {
-				signalValue = measure*0.5; // we capture half of the maximum possible pulse energy to account for self  interference
-				resPower    = resPower + signalValue;
-			}
-			else {
-				// take a random point within pulse envelope for interferer
-				resPower = resPower + measure * uniform(-1, +1);
-			}
-			++currSig;
-		}
-
-//		double attenuatedPower = resPower / 10; // 10 dB = 6 dB implementation loss + 5 dB noise factor
-		vEfield          = sqrt(50*resPower); // P=V²/R
-		// add thermal noise realization
-		vThermalNoise    = getNoiseValue();
-		vmeasured        = vEfield + vThermalNoise;
-		vmeasured_square = pow(vmeasured, 2);
-
-		// signal + interference + noise
-		energy.second    = energy.second + vmeasured_square;  // collect this contribution
+		sampleTimes.push_back(now);
+	}
+}
 
-		// Now evaluates signal to noise ratio
-		// signal converted to antenna voltage squared
-		snir             = signalValue / 2.0217E-12;
-		energy.first     = energy.first + snir;
+void DeciderUWBIRED::sampleReceivingPower( const Signal&            aSignal
+                                         , const vector<simtime_t>& sampleTimes
+                                         , vector<double>&          powers ) {
+	if (sampleTimes.empty())
+		return;
+
+	const ConstMapping *const      currPower = aSignal.getReceivingPower();
+	const UWBIRPulseMapping *const pulses    = dynamic_cast<const UWBIRPulseMapping*>(aSignal.getTransmissionPower());
+	Argument                       arg;
+
+	if (pulses == NULL) {
+		// generic mapping, evaluated point by point
+		for (size_t i = 0; i < sampleTimes.size(); ++i) {
+			arg.setTime(sampleTimes[i]);
+			powers[i] = currPower->getValue(arg);
+		}
+		return;
+	}
 
-	} // consider next point in time
-	return energy;
+	// only the samples during the frame can hit one of its pulses, the others stay zero
+	const size_t first = std::lower_bound(sampleTimes.begin(), sampleTimes.end(), aSignal.getReceptionStart()) - sampleTimes.begin();
+	const size_t last  = std::upper_bound(sampleTimes.begin(), sampleTimes.end(), aSignal.getReceptionEnd()) - sampleTimes.begin();
+	if (first >= last)
+		return;
+
+	// evaluate the transmitted pulses directly, the (variable) attenuations
+	// are only needed where the frame has a pulse
+	pulses->getValues(&sampleTimes[first], &sampleTimes[0] + last, aSignal.getPropagationDelay(), &powers[first]);
+	if (aSignal.hasConstantAttenuation()) {
+		const double attenuation = aSignal.getAttenuationFactor();
+		for (size_t i = first; i < last; ++i) {
+			powers[i] = powers[i] * attenuation;
+		}
+	}
+	else {
+		for (size_t i = first; i < last; ++i) {
+			if (powers[i] != 0) {
+				arg.setTime(sampleTimes[i]);
+				powers[i] = currPower->getValue(arg);
+			}
+		}
+	}
 }
 
 ChannelState DeciderUWBIRED::getChannelState() const {
@@ -17,6 +17,7 @@
 #include "Mapping.h"
 #include "BaseDecider.h"
 #include "IEEE802154A.h"
+#include "UWBIRPulseMapping.h"
 #include "UWBIRPacket.h"
 #include "MacToPhyInterface.h"
 
@@ -168,15 +169,28 @@ protected:
 
 	virtual bool attemptSync(const airframe_ptr_t frame);
 
-	// first value is energy from signal, other value is total window energy
-	static
-	std::pair<double, double> integrateWindow( int                        symbol
-	                                         , simtime_t_cref             now
-	                                         , simtime_t_cref             burst
-	                                         , const AirFrameVector&      airFrameVector
-	                                         , const ConstMapping *const  signalPower
-	                                         , const airframe_ptr_t       frame
-	                                         , const IEEE802154A::config& cfg);
+	/**
+	 * @brief Appends the pulse peak sample times of the integration window
+	 * starting at now (the peak of its first pulse) to sampleTimes.
+	 */
+	static void addWindowSamples( simtime_t_cref             now
+	                            , simtime_t_cref             burst
+	                            , const IEEE802154A::config& cfg
+	                            , std::vector<simtime_t>&    sampleTimes );
+
+	/**
+	 * @brief Evaluates the receiving power of the passed signal at all
+	 * (sorted) sample times in one sweep.
+	 *
+	 * Parametric UWBIRPulseMapping transmission powers are evaluated together
+	 * with the sorted sample times, other mappings point by point.
+	 *
+	 * @param powers Receives the power at each sample time, has to be zero
+	 * initialized and as large as sampleTimes.
+	 */
+	static void sampleReceivingPower( const Signal&                 aSignal
+	                                , const std::vector<simtime_t>& sampleTimes
+	                                , std::vector<double>&          powers );
 
 private:
 	/** @brief Copy constructor is not allowed.
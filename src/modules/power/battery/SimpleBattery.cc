@@ -58,6 +58,9 @@ SimpleBattery::SimpleBattery()
 	, registeredDevices(0)
 	, lastUpdateTime()
 	, host(NULL)
+	, analyticAccounting(false)
+	, depletionDue(false)
+	, depletionTime()
 {}
 
 void SimpleBattery::initialize(int stage) {
@@ -87,11 +90,13 @@ void SimpleBattery::initialize(int stage) {
 		}
 
 		resolution = par("resolution");
+		analyticAccounting = hasPar("analyticAccounting") ? par("analyticAccounting").boolValue() : false;
 
 		debugEV<< "capacity = " << capmAh << "mA-h (nominal = " << nominalCapmAh <<
 		") at " << voltage << "V" << std::endl;
 		debugEV << "publishDelta = " << publishDelta * 100 << "%, publishTime = "
 		<< publishTime << "s, resolution = " << resolution << "sec"
+		<< (analyticAccounting ? " (analytic accounting)" : "")
 		<< std::endl;
 
 		capacity = capmAh * 60 * 60 * voltage; // use mW-sec internally
@@ -110,7 +115,10 @@ void SimpleBattery::initialize(int stage) {
 
 		timeout = new cMessage("auto-update", AUTO_UPDATE);
 		timeout->setSchedulingPriority(500);
-		scheduleAt(simTime() + resolution, timeout);
+		// with analytic accounting the timeout is only scheduled for the
+		// next capacity threshold once a device draws current
+		if (!analyticAccounting)
+			scheduleAt(simTime() + resolution, timeout);
 
 		// publish battery depletion on hostStateCat
 		// periodically publish residual capacity on batteryCat
@@ -236,6 +244,10 @@ void SimpleBattery::draw(int deviceID, DrawAmount& amount, int activity)
 	else {
 		error("Unknown power type!");
 	}
+
+	// the total current draw (or the residual capacity) has changed
+	if (analyticAccounting)
+		scheduleNextUpdate();
 }
 
 void SimpleBattery::handleMessage(cMessage *msg) {
@@ -243,17 +255,33 @@ void SimpleBattery::handleMessage(cMessage *msg) {
 
 		switch (msg->getKind()) {
 		case AUTO_UPDATE:
+			if (analyticAccounting) {
+				// a precomputed capacity threshold (publishDelta or
+				// depletion) has been reached
+				depletionDue = simTime() >= depletionTime;
+				deductAndCheck();
+				depletionDue = false;
+				scheduleNextUpdate();
+				break;
+			}
 			// update the residual capacity (ongoing current draw)
 			scheduleAt(simTime() + resolution, timeout);
 			deductAndCheck();
 			break;
 
 		case PUBLISH:
+			// the residual capacity is not kept up to date between
+			// analytic updates, so integrate the ongoing draw first
+			if (analyticAccounting)
+				deductAndCheck();
+
 			// publish the state to the BatteryStats module
 			emit(BatteryStats::catBatteryStateSignal, batteryState);
 			lastPublishCapacity = residualCapacity;
 
 			scheduleAt(simTime() + publishTime, publish);
+			if (analyticAccounting)
+				scheduleNextUpdate();
 			break;
 
 		default:
@@ -306,6 +334,11 @@ void SimpleBattery::deductAndCheck() {
 
 	lastUpdateTime = now;
 
+	// the analytically computed depletion time has been reached, drop
+	// what is left over from rounding the event time
+	if (depletionDue)
+		residualCapacity = 0;
+
 	if (residualCapacity > nominalCapacity)
 		residualCapacity = nominalCapacity;
 	else if (lessOrEqualNull(residualCapacity))
@@ -368,6 +401,64 @@ void SimpleBattery::deductAndCheck() {
 	residualVec.record(residualCapacity);
 }
 
+/** @brief Returns the first simulation time which is at least %delay
+ * seconds after %now.
+ *
+ * Rounding up guarantees that the threshold the delay was computed for has
+ * actually been crossed when the event scheduled at this time fires.
+ */
+static simtime_t timeAfter(simtime_t_cref now, double delay) {
+	simtime_t t = now + delay;
+	if (SIMTIME_DBL(t - now) < delay) {
+		t.setRaw(SIMTIME_RAW(t) + 1);
+	}
+	return t;
+}
+
+void SimpleBattery::scheduleNextUpdate() {
+	Enter_Method_Silent();
+
+	if (timeout->isScheduled()) {
+		cancelEvent(timeout);
+	}
+	if (lessOrEqualNull(residualCapacity)) {
+		return;
+	}
+
+	// total power currently drawn from the battery (mW), the residual
+	// capacity decreases linearly with it until the next draw change
+	double power = 0;
+	for (int i = 0; i < numDevices; i++) {
+		if (devices[i].currentActivity > -1) {
+			power += devices[i].draw;
+		}
+	}
+	power *= voltage;
+	if (power <= 0) {
+		return;
+	}
+
+	const simtime_t now      = simTime();
+	const double    maxDelay = SIMTIME_DBL(MAXTIME - now);
+	double          delay    = residualCapacity / power;
+
+	depletionTime = (delay < maxDelay) ? timeAfter(now, delay) : MAXTIME;
+
+	// residual capacity at which the change since the last publication
+	// reaches publishDelta
+	if (publishDelta < 1) {
+		const double publishCapacity = lastPublishCapacity - publishDelta * capacity;
+		if (publishCapacity > 0 && publishCapacity < residualCapacity) {
+			delay = (residualCapacity - publishCapacity) / power;
+		}
+	}
+
+	// otherwise the battery outlives the simulation
+	if (delay < maxDelay) {
+		scheduleAt(timeAfter(now, delay), timeout);
+	}
+}
+
 	// the three functions below should be supported in all battery
 	// modules.  in SimpleBattery, they're trivial.  a more accurate model
 	// would require substantially more complex functionality here
@@ -105,6 +105,8 @@ protected:
 
 	/** @brief Debit battery at least once every resolution seconds.*/
 	simtime_t resolution;
+	/** @brief Periodic update timer, or the next capacity threshold with
+	 * analytic accounting.*/
 	cMessage *timeout;
 
 	/** @name publishing of capacity to BatteryStats via the BB. */
@@ -149,7 +151,28 @@ protected:
 	simtime_t lastUpdateTime;
 	/** @brief Pointer to host module */
 	cModule* 	host;
+
+	/** @name analytic accounting*/
+	/*@{*/
+	/** @brief Update the capacity only on draw changes and computed
+	 * thresholds instead of every resolution seconds.*/
+	bool analyticAccounting;
+	/** @brief Set while the timeout for the computed depletion time is
+	 * handled.*/
+	bool depletionDue;
+	/** @brief Time at which the battery is depleted at the current draw.*/
+	simtime_t depletionTime;
+	/*@}*/
+
 	virtual void deductAndCheck();
+
+	/**
+	 * @brief Schedules the timeout for the next time the residual capacity
+	 * crosses a publishDelta step or reaches zero at the current total draw.
+	 *
+	 * Only used with analytic accounting, see SimpleBattery.ned.
+	 */
+	virtual void scheduleNextUpdate();
 };
 
 #endif
@@ -25,6 +25,8 @@
 #include "IEEE802154A.h"
 
 #include <cassert>
+#include <map>
+#include <algorithm>
 
 using std::vector;
 
@@ -158,20 +160,19 @@ IEEE802154A::signalAndData IEEE802154A::generateIEEE802154AUWBSignal(
 
 	signalAndData res;
 	int bitValue;
+	// the pulses are not stored one by one but evaluated on demand from
+	// the (shared) synchronization header and the data burst parameters
 	// data start time relative to signal->getReceptionStart();
-	simtime_t dataStart = cfg.preambleLength; // = Tsync + Tsfd
-	TimeMapping<Linear>* mapping = new TimeMapping<Linear> ();
-	Argument* arg = new Argument();
+	UWBIRPulseMapping* mapping = new UWBIRPulseMapping(signalStart, &getSHRPulses(),
+			cfg.preambleLength, // = Tsync + Tsfd
+			cfg.data_symbol_duration, cfg.shift_duration, cfg.burst_duration,
+			cfg.pulse_duration, cfg.nbPulsesPerBurst, IEEE802154A::maxPulse);
 	setBitRate(s);
 
-	generateSyncPreamble(mapping, arg);
-	generateSFD(mapping, arg);
 	//generatePhyHeader(mapping, arg);
 
 	// generate bit values and modulates them according to
 	// the IEEE 802.15.4A specification
-	simtime_t symbolStart = dataStart;
-	simtime_t burstPos;
 	for (unsigned int burst = 0; burst < nbBits; burst++) {
 		if(allZeros) {
 			bitValue = 0;
@@ -179,51 +180,68 @@ IEEE802154A::signalAndData IEEE802154A::generateIEEE802154AUWBSignal(
 		  bitValue = intuniform(0, 1, 0);
 		}
 		bitValues->push_back(static_cast<bool>(bitValue));
-		burstPos = symbolStart + bitValue*cfg.shift_duration + getHoppingPos(burst)*cfg.burst_duration;
-		generateBurst(mapping, arg, burstPos, +1);
-		symbolStart = symbolStart + cfg.data_symbol_duration;
+		mapping->addBurst(static_cast<bool>(bitValue), getHoppingPos(burst));
 	}
 	//assert(uwbirMacPkt->getBitValuesArraySize() == dataLength);
 	//assert(bitValues->size() == nbBits);
 
 	// associate generated pulse energies to the signal
 	s->setTransmissionPower(mapping);
-	delete arg;
 
 	res.first = s;
 	res.second = bitValues;
 	return res;
 }
 
-void IEEE802154A::generateSyncPreamble(Mapping* mapping, Argument* arg) {
+const UWBIRPulseMapping::pulse_times_t& IEEE802154A::getSHRPulses() {
+	// the synchronization header only depends on these configuration values
+	typedef std::vector<double>                                     shr_key_t;
+	typedef std::map<shr_key_t, UWBIRPulseMapping::pulse_times_t>   shr_cache_t;
+	static shr_cache_t shrCache;
+
+	shr_key_t key;
+	key.push_back(cfg.NSync);
+	key.push_back(cfg.CLength);
+	key.push_back(cfg.spreadingdL);
+	key.push_back(cfg.sync_symbol_duration);
+	key.push_back(cfg.pulse_duration);
+
+	shr_cache_t::iterator it = shrCache.find(key);
+	if (it == shrCache.end()) {
+		it = shrCache.insert(std::make_pair(key, UWBIRPulseMapping::pulse_times_t())).first;
+		generateSyncPreamble(it->second);
+		generateSFD(it->second);
+		// the SFD may overlap the sync preamble for some configurations
+		std::sort(it->second.begin(), it->second.end());
+	}
+	return it->second;
+}
+
+void IEEE802154A::generateSyncPreamble(UWBIRPulseMapping::pulse_times_t& pulses) {
 	// NSync repetitions of the Si symbol
 	for (short n = 0; n < cfg.NSync; n = n + 1) {
 		for (short pos = 0; pos < cfg.CLength; pos = pos + 1) {
 			if (C31[Ci - 1][pos] != 0) {
 				if(n==0 && pos==0) {
 					// we slide the first pulse slightly in time to get the first point "inside" the signal
-				  arg->setTime(1E-12 + n * cfg.sync_symbol_duration + pos * cfg.spreadingdL * cfg.pulse_duration);
+				  pulses.push_back(simtime_t(1E-12 + n * cfg.sync_symbol_duration + pos * cfg.spreadingdL * cfg.pulse_duration));
 				} else {
-				  arg->setTime(n * cfg.sync_symbol_duration + pos * cfg.spreadingdL * cfg.pulse_duration);
+				  pulses.push_back(simtime_t(n * cfg.sync_symbol_duration + pos * cfg.spreadingdL * cfg.pulse_duration));
 				}
-				//generatePulse(mapping, arg, C31[Ci - 1][pos],
-				//		IEEE802154A::maxPulse, IEEE802154A::mandatory_pulse);
-				generatePulse(mapping, arg, 1,			// always positive polarity
-						IEEE802154A::maxPulse, cfg.pulse_duration);
+				// always positive polarity (C31[Ci - 1][pos] is ignored)
 			}
 		}
 	}
 }
 
-void IEEE802154A::generateSFD(Mapping* mapping, Argument* arg) {
-	double sfdStart = NSync * Tpsym;
+void IEEE802154A::generateSFD(UWBIRPulseMapping::pulse_times_t& pulses) {
+	double sfdStart = NSync * SIMTIME_DBL(Tpsym);
 	for (short n = 0; n < 8; n = n + 1) {
 		if (IEEE802154A::shortSFD[n] != 0) {
 			for (short pos = 0; pos < cfg.CLength; pos = pos + 1) {
 				if (C31[Ci - 1][pos] != 0) {
-					arg->setTime(sfdStart + n*cfg.sync_symbol_duration + pos*cfg.spreadingdL*cfg.pulse_duration);
-					//generatePulse(mapping, arg, C31[Ci - 1][pos] * shortSFD[n]); // change pulse polarity
-					generatePulse(mapping, arg, 1); // always positive polarity
+					// always positive polarity (C31[Ci - 1][pos] * shortSFD[n] is ignored)
+					pulses.push_back(simtime_t(sfdStart + n*cfg.sync_symbol_duration + pos*cfg.spreadingdL*cfg.pulse_duration));
 				}
 			}
 		}
@@ -234,30 +252,6 @@ void IEEE802154A::generatePhyHeader(Mapping* /*mapping*/, Argument* /*arg*/) {
 	// not implemented
 }
 
-void IEEE802154A::generatePulse(Mapping* mapping, Argument* arg,
-		short polarity, double peak, simtime_t_cref chip) {
-	assert(polarity == -1 || polarity == +1);
-	arg->setTime(arg->getTime() + IEEE802154A::signalStart);  // adjust argument so that we use absolute time values in Mapping
-	mapping->setValue(*arg, 0);
-	arg->setTime(arg->getTime() + chip / 2);
-	// Maximum point at symbol half (triangular pulse)
-	mapping->setValue(*arg, peak * polarity);
-	arg->setTime(arg->getTime() + chip / 2);
-	mapping->setValue(*arg, 0);
-}
-
-void IEEE802154A::generateBurst(Mapping* mapping, Argument* arg,
-		simtime_t_cref burstStart, short /*polarity*/) {
-	assert(burstStart < cfg.preambleLength+(psduLength*8+48+2)*cfg.data_symbol_duration);
-	// 1. Start point = zeros
-	simtime_t offset = burstStart;
-	for (int pulse = 0; pulse < cfg.nbPulsesPerBurst; pulse++) {
-		arg->setTime(offset);
-		generatePulse(mapping, arg, 1);
-		offset = offset + cfg.pulse_duration;
-	}
-}
-
 void IEEE802154A::setBitRate(Signal* s) {
 	Argument arg = Argument();
 	// set a constant value for bitrate
@@ -30,6 +30,7 @@
 
 #include "MiXiMDefs.h"
 #include "Signal_.h"
+#include "UWBIRPulseMapping.h"
 
 /**
  * @brief This class regroups static methods needed to generate
@@ -177,12 +178,13 @@ class MIXIM_API IEEE802154A
         static const int Nhdr = 16;
 
     protected:
-        static void generateSyncPreamble(Mapping* mapping, Argument* arg);
-        static void generateSFD(Mapping* mapping, Argument* arg);
+        /* @brief Returns the sorted pulse start times (relative to the signal start) of the
+         * synchronization header for the current configuration. The list is computed once
+         * per configuration and shared by all generated signals. */
+        static const UWBIRPulseMapping::pulse_times_t& getSHRPulses();
+        static void generateSyncPreamble(UWBIRPulseMapping::pulse_times_t& pulses);
+        static void generateSFD(UWBIRPulseMapping::pulse_times_t& pulses);
         static void generatePhyHeader(Mapping* mapping, Argument* arg);
-        static void generateBurst(Mapping* mapping, Argument* arg, simtime_t_cref burstStart, short polarity);
-        static void generatePulse(Mapping* mapping, Argument* arg, short polarity, double peak = IEEE802154A::maxPulse,
-                simtime_t_cref chip = IEEE802154A::mandatory_pulse);
         static void setBitRate(Signal* s);
         static int s(int n);
 
@@ -21,14 +21,80 @@
  **************************************************************************/
 #include "SimTracer.h"
 
+#include <cstring>
+
 #include "FindModule.h"
 #include "BaseLayer.h"
 
-using std::map;
 using std::string;
 
 Define_Module(SimTracer);
 
+namespace {
+
+const char BINARY_MAGIC[8] = { 'S', 'I', 'M', 'T', 'R', 'C', '1', '\n' };
+
+}
+
+bool SimTracer::TraceFile::open(const char* name, bool binary, size_t bufferSize)
+{
+  close();
+  file = fopen(name, binary ? "wb" : "w");
+  if (!file)
+    return false;
+  buffer.resize(bufferSize > 0 ? bufferSize : 1);
+  used = 0;
+  if (binary)
+    write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+  return true;
+}
+
+void SimTracer::TraceFile::write(const void* data, size_t size)
+{
+  if (!file)
+    return;
+  if (used + size > buffer.size()) {
+    flush();
+    // records larger than the buffer are written directly
+    if (size > buffer.size()) {
+      fwrite(data, 1, size, file);
+      return;
+    }
+  }
+  memcpy(&buffer[used], data, size);
+  used += size;
+}
+
+void SimTracer::TraceFile::flush()
+{
+  if (file && used > 0)
+    fwrite(&buffer[0], 1, used, file);
+  used = 0;
+}
+
+void SimTracer::TraceFile::close()
+{
+  if (file) {
+    flush();
+    fclose(file);
+    file = NULL;
+  }
+  std::vector<char>().swap(buffer);
+}
+
+void SimTracer::openTraceFile(TraceFile& file, const char* type, const char* textExtension)
+{
+  char name[250];
+  sprintf(name, "results/%s-%d.%s", type,
+	cSimulation::getActiveSimulation()->getEnvir()->getConfigEx()->getActiveRunNumber(),
+	binaryTrace ? "bin" : textExtension);
+  const size_t bufferSize = hasPar("bufferSize") ? static_cast<size_t>(par("bufferSize").longValue()) : 65536;
+  if (!file.open(name, binaryTrace, bufferSize)) {
+    EV << "Error opening output stream " << name << " for " << type << " statistics."
+        << endl;
+  }
+}
+
 /*
  * Open some log files and write some static initializations stuff.
  */
@@ -36,17 +102,17 @@ void SimTracer::initialize(int stage)
 {
   cSimpleModule::initialize(stage);
   if (stage == 0) {
-	char treeName[250];
-	/*int n;
-	n =*/ sprintf(treeName, "results/tree-%d.txt",
-	cSimulation::getActiveSimulation()->getEnvir()->getConfigEx()->getActiveRunNumber());
-    treeFile.open(treeName);
-    if (!treeFile) {
-      EV << "Error opening output stream for routing tree statistics."
-          << endl;
-    } else {
-      treeFile << "graph aRoutingTree " << endl << "{" << endl;
+    binaryTrace = hasPar("binaryTrace") ? par("binaryTrace").boolValue() : false;
+    if (!hasPar("logTree") || par("logTree").boolValue()) {
+      openTraceFile(treeFile, "tree", "txt");
+      if (treeFile.isOpen() && !binaryTrace)
+        treeFile.write(string("graph aRoutingTree \n{\n"));
     }
+    if (hasPar("logNam") && par("logNam").boolValue())
+      openTraceFile(namFile, "nam", "nam");
+    if (hasPar("logRadioEnergy") && par("logRadioEnergy").boolValue())
+      openTraceFile(radioEnergyFile, "radioEnergy", "txt");
+
     goodputVec.setName("goodput");
     pSinkVec.setName("sinkPowerConsumption");
     pSensorVec.setName("sensorPowerConsumption");
@@ -69,39 +135,28 @@ void SimTracer::initialize(int stage)
 
 // compute current average sensor power consumption
 double SimTracer::getAvgSensorPowerConsumption() const {
-	double sensorAvgP = 0;
-	int    nbSensors  = 0;
+	if (nbSensors == 0)
+		return 0;
 
-	map < unsigned long, double >::const_iterator iter = powerConsumptions.begin(); // address, powerConsumption
-	for (; iter != powerConsumptions.end(); ++iter) {	// iterate over all nodes power consumptions
-		if(iter->first == 0)
-			continue;
-
-		double eval = iter->second;
-		eval = eval +  SIMTIME_DBL(simTime() - lastUpdates.at(iter->first)) * currPower.at(iter->first);
-		eval = eval * 1000 / SIMTIME_DBL(simTime());
-
-		++nbSensors;
-		sensorAvgP += eval;
-	}
-	if (nbSensors) {
-		sensorAvgP = sensorAvgP / nbSensors;
-	}
-	return sensorAvgP;
+	// sum over all sensors of energy + (now - lastUpdate) * power
+	const simtime_t now  = simTime();
+	double          eval = sensorEnergy + SIMTIME_DBL(now - sensorUpdate) * sensorPower;
+	return eval * 1000 / SIMTIME_DBL(now) / nbSensors;
 }
 
 double SimTracer::getSinkPowerConsumption() const {
-	map < unsigned long, double >::const_iterator iter = powerConsumptions.find(0);
-	if (iter == powerConsumptions.end())
+	PowerAccounts::const_iterator it = powerAccounts.find(0);
+	if (it == powerAccounts.end())
 		return 0.0;
-	double  sinkP = iter->second;
-	sinkP = sinkP + SIMTIME_DBL(simTime() - lastUpdates.at(iter->first)) * currPower.at(iter->first);
+	const PowerAccount& sink = it->second;
+	double  sinkP = sink.energy;
+	sinkP = sinkP + SIMTIME_DBL(simTime() - sink.lastUpdate) * sink.power;
 	sinkP = sinkP * 1000 / SIMTIME_DBL(simTime());
 	return sinkP;
 }
 
 /*
- * Close the nam log file.
+ * Close the log files.
  */
 void SimTracer::finish()
 {
@@ -116,36 +171,66 @@ void SimTracer::finish()
   recordScalar("Application packets sent", nbApplPacketsSent);
   recordScalar("Sink power consumption", getSinkPowerConsumption());
   recordScalar("Sensor average power consumption", getAvgSensorPowerConsumption());
-  if (treeFile) {
-    treeFile << "}" << endl;
-    treeFile.close();
-  }
-
+  if (treeFile.isOpen() && !binaryTrace)
+    treeFile.write(string("}\n"));
+  treeFile.close();
+  namFile.close();
+  radioEnergyFile.close();
 }
 
 /*
  * Record a line into the nam log file.
  */
-void SimTracer::namLog(string /*namString*/)
+void SimTracer::namLog(string namString)
 {
-  //Enter_Method_Silent();
-  //namFile << namString << endl;
+  if (!namFile.isOpen())
+    return;
+  if (binaryTrace) {
+    namFile.writeValue<char>(NAM_RECORD);
+    namFile.writeValue<uint32>(namString.size());
+  } else {
+    namString += '\n';
+  }
+  namFile.write(namString);
 }
 
-void SimTracer::radioEnergyLog(unsigned long mac, int /*state*/,
+void SimTracer::radioEnergyLog(unsigned long mac, int state,
 			       simtime_t_cref duration, double power, double newPower)
 {
   Enter_Method_Silent();
-  /*
-  radioEnergyFile << mac << "\t" << state << "\t" << duration << "\t" << power
-    << endl;
-    */
-  if (powerConsumptions.count(mac) == 0) {
-    powerConsumptions[mac] = 0;
+  const simtime_t now = simTime();
+
+  if (radioEnergyFile.isOpen()) {
+    if (binaryTrace) {
+      radioEnergyFile.writeValue<char>(RADIO_ENERGY_RECORD);
+      radioEnergyFile.writeValue<double>(SIMTIME_DBL(now));
+      radioEnergyFile.writeValue<uint64>(mac);
+      radioEnergyFile.writeValue<int32>(state);
+      radioEnergyFile.writeValue<double>(SIMTIME_DBL(duration));
+      radioEnergyFile.writeValue<double>(power);
+    } else {
+      line.str("");
+      line << mac << "\t" << state << "\t" << duration << "\t" << power << '\n';
+      radioEnergyFile.write(line.str());
+    }
   }
-  powerConsumptions[mac] = powerConsumptions[mac] + power * SIMTIME_DBL(duration);
-  currPower[mac] = newPower;
-  lastUpdates[mac] = simTime();
+
+  PowerAccount& account = powerAccounts[mac];
+  const double  energy  = power * SIMTIME_DBL(duration);
+  if(mac != 0) {
+	  if (!account.used) {
+		  ++nbSensors;
+	  }
+	  // move the sum to now, then replace the open interval of this sensor by its energy
+	  sensorEnergy += SIMTIME_DBL(now - sensorUpdate) * sensorPower;
+	  sensorUpdate  = now;
+	  sensorEnergy += energy - SIMTIME_DBL(now - account.lastUpdate) * account.power;
+	  sensorPower  += newPower - account.power;
+  }
+  account.energy    += energy;
+  account.power      = newPower;
+  account.lastUpdate = now;
+  account.used       = true;
   if(mac != 0) {
 	  pSensorVec.record(getAvgSensorPowerConsumption());
   } else {
@@ -153,9 +238,21 @@ void SimTracer::radioEnergyLog(unsigned long mac, int /*state*/,
   }
 }
 
-void SimTracer::logPosition(int node, double x, double y, double /*z*/)
+void SimTracer::logPosition(int node, double x, double y, double z)
 {
-	treeFile << node << "[pos=\""<< x << ", " << y << "!\"];" << endl;
+	if (!treeFile.isOpen())
+		return;
+	if (binaryTrace) {
+		treeFile.writeValue<char>(POSITION_RECORD);
+		treeFile.writeValue<int64>(node);
+		treeFile.writeValue<double>(x);
+		treeFile.writeValue<double>(y);
+		treeFile.writeValue<double>(z);
+	} else {
+		line.str("");
+		line << node << "[pos=\""<< x << ", " << y << "!\"];" << '\n';
+		treeFile.write(line.str());
+	}
 }
 
 void SimTracer::receiveSignal(cComponent */*source*/, simsignal_t signalID, cObject *obj)
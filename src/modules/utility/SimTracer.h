@@ -23,11 +23,11 @@
 #ifndef SIMTRACER_H
 #define SIMTRACER_H
 
+#include <cstdio>
+#include <map>
 #include <string>
 #include <sstream>
-#include <fstream>
 #include <vector>
-#include <map>
 
 #include "MiXiMDefs.h"
 #include "BaseWorldUtility.h"
@@ -35,6 +35,19 @@
 
 /**
  * @class SimTracer
+ *
+ * The traced events are selected by the module parameters, see
+ * SimTracer.ned. Every trace file is written through a large memory buffer,
+ * either as text or as compact binary records. A binary trace file starts
+ * with the 8 characters "SIMTRC1\n", followed by records of one type byte
+ * and the fields of the record, in the byte order of the writing machine
+ * and without padding:
+ * - LINK_RECORD:         int64 parent, int64 child
+ * - POSITION_RECORD:     int64 node, double x, double y, double z
+ * - RADIO_ENERGY_RECORD: double time, uint64 mac, int32 state,
+ *                        double duration, double power
+ * - NAM_RECORD:          uint32 length, length characters
+ *
  * @ingroup utils
  * @author Jerome Rousselot
  */
@@ -49,22 +62,33 @@ private:
   SimTracer& operator=(const SimTracer&);
 
 public:
+  /** @brief Types of the records in binary trace files. */
+  enum RecordType {
+    LINK_RECORD = 1,
+    POSITION_RECORD,
+    RADIO_ENERGY_RECORD,
+    NAM_RECORD
+  };
+
   SimTracer()
   	  : cSimpleModule()
   	  , cListener()
   	  , namFile(), radioEnergyFile(), treeFile()
+  	  , binaryTrace(false)
+  	  , line()
   	  , packetsColors()
   	  , goodputVec()
 	  , pSinkVec()
 	  , pSensorVec()
-	  , powerConsumptions()
+	  , powerAccounts()
+	  , nbSensors(0)
+	  , sensorEnergy(0)
+	  , sensorPower(0)
+	  , sensorUpdate()
 	  , packet(100)
 	  , nbApplPacketsSent(0)
 	  , nbApplPacketsReceived(0)
 	  , catEnergy(0)
-	  , powerConsumptions2()
-	  , currPower()
-	  , lastUpdates()
 	  , world(NULL)
   {}
 
@@ -77,13 +101,32 @@ public:
     /** @brief Called by any module wanting to log a nam event. */
   void namLog(std::string namString);
 
+  /**
+   * @brief Accounts the energy a host's radio used in its last state.
+   *
+   * mac identifies the host, 0 is the sink.
+   */
   void radioEnergyLog(unsigned long mac, int state, simtime_t_cref duration,
 		      double power, double newPower);
 
-  /** @brief Called by a routing protocol to log a link in a tree topology. */
+  /**
+   * @brief Called by a routing protocol to log a link in a tree topology.
+   *
+   * Binary traces store the addresses as long.
+   */
   template<typename T>
   void logLink(T parent, T child) {
-    treeFile << "   " << parent << " -- " << child << " ;" << endl;
+    if (!treeFile.isOpen())
+      return;
+    if (binaryTrace) {
+      treeFile.writeValue<char>(LINK_RECORD);
+      treeFile.writeValue<int64>(static_cast<long>(parent));
+      treeFile.writeValue<int64>(static_cast<long>(child));
+    } else {
+      line.str("");
+      line << "   " << parent << " -- " << child << " ;" << '\n';
+      treeFile.write(line.str());
+    }
   }
 
   /** @brief Called by the MAC or NET layer to log the node position. */
@@ -97,19 +140,84 @@ public:
   double getSinkPowerConsumption() const;
 
 protected:
-   std::ofstream namFile, radioEnergyFile, treeFile;
+   /**
+    * @brief Trace output file which collects the written data in memory
+    * and writes it in large blocks.
+    */
+   class MIXIM_API TraceFile {
+   private:
+     TraceFile(const TraceFile&);
+     TraceFile& operator=(const TraceFile&);
+
+   protected:
+     FILE*             file;
+     std::vector<char> buffer;
+     size_t            used;
+
+   public:
+     TraceFile(): file(NULL), buffer(), used(0) {}
+     ~TraceFile() { close(); }
+
+     /** @brief Opens the file for writing, returns false on failure. */
+     bool open(const char* name, bool binary, size_t bufferSize);
+
+     bool isOpen() const { return file != NULL; }
+
+     void write(const void* data, size_t size);
+
+     void write(const std::string& text) { write(text.data(), text.size()); }
+
+     template<typename T>
+     void writeValue(T value) { write(&value, sizeof(value)); }
+
+     /** @brief Writes the buffered data to the file. */
+     void flush();
+
+     /** @brief Flushes and closes the file. */
+     void close();
+   };
+
+   /** @brief Power accounting of one host. */
+   struct PowerAccount {
+     /** @brief Energy used until lastUpdate. */
+     double    energy;
+     /** @brief Power used since lastUpdate. */
+     double    power;
+     simtime_t lastUpdate;
+     bool      used;
+
+     PowerAccount(): energy(0), power(0), lastUpdate(), used(false) {}
+   };
+
+   /** @brief Opens a trace file, named after its type and the run number. */
+   void openTraceFile(TraceFile& file, const char* type, const char* textExtension);
+
+   TraceFile namFile, radioEnergyFile, treeFile;
+   /** @brief Write binary records instead of text. */
+   bool binaryTrace;
+   /** @brief Formats the lines of text traces. */
+   std::ostringstream line;
    std::vector < std::string > packetsColors;
    cOutVector goodputVec;
    cOutVector pSinkVec;
    cOutVector pSensorVec;
-   std::map < unsigned long, double >powerConsumptions;
+   typedef std::map<unsigned long, PowerAccount> PowerAccounts;
+
+   /** @brief Power accounting by MAC address, 0 is the sink. */
+   PowerAccounts powerAccounts;
+   /** @name Sums over the power accounts of all sensors (hosts other than 0).*/
+   /*@{*/
+   int nbSensors;
+   /** @brief Sum of energy + (sensorUpdate - lastUpdate) * power. */
+   double sensorEnergy;
+   double sensorPower;
+   /** @brief Time up to which sensorEnergy is accounted. */
+   simtime_t sensorUpdate;
+   /*@}*/
    Packet packet;
    long nbApplPacketsSent;
    long nbApplPacketsReceived;
    int catEnergy;
-   std::map < unsigned long, double >powerConsumptions2;
-   std::map < unsigned long, double >currPower;
-   std::map < unsigned long, simtime_t> lastUpdates;
    BaseWorldUtility* world;
 };
 
@@ -0,0 +1,243 @@
+/* -*- mode:c++ -*- ********************************************************
+ * file:        UWBIRPulseMapping.cc
+ *
+ *              This program is free software; you can redistribute it
+ *              and/or modify it under the terms of the GNU General Public
+ *              License as published by the Free Software Foundation; either
+ *              version 2 of the License, or (at your option) any later
+ *              version.
+ *              For further information see file COPYING
+ *              in the top level directory
+ * description: parametric pulse-level representation of an
+ *              IEEE 802.15.4A UWB-IR frame
+ ***************************************************************************/
+
+#include "UWBIRPulseMapping.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+UWBIRPulseMapping::UWBIRPulseMapping(simtime_t_cref       signalStart,
+                                     const pulse_times_t* shrPulses,
+                                     double dataStart,
+                                     double symbolDuration,
+                                     double shiftDuration,
+                                     double burstDuration,
+                                     double pulseDuration,
+                                     int    pulsesPerBurst,
+                                     double peak):
+	ConstMapping(),
+	signalStart(signalStart),
+	shrPulses(shrPulses),
+	dataStart(dataStart),
+	symbolDuration(symbolDuration),
+	shiftDuration(shiftDuration),
+	burstDuration(burstDuration),
+	pulseDuration(pulseDuration),
+	halfPulse(),
+	pulseEnd(),
+	pulsesPerBurst(pulsesPerBurst),
+	peak(peak),
+	bits(),
+	hops()
+{
+	assert(shrPulses);
+	assert(pulsesPerBurst > 0);
+	halfPulse = this->pulseDuration / 2;
+	// the end key used to be set by adding the rounded half pulse twice
+	pulseEnd  = halfPulse + halfPulse;
+}
+
+void UWBIRPulseMapping::addBurst(bool bitValue, int hoppingPos)
+{
+	assert(hoppingPos >= 0 && hoppingPos < 256);
+	bits.push_back(bitValue);
+	hops.push_back(static_cast<unsigned char>(hoppingPos));
+}
+
+simtime_t UWBIRPulseMapping::getRelativePulseStart(long pulse) const
+{
+	assert(pulse >= 0 && pulse < getNbPulses());
+
+	const long nbShrPulses = static_cast<long>(shrPulses->size());
+	if(pulse < nbShrPulses)
+		return (*shrPulses)[pulse];
+
+	pulse -= nbShrPulses;
+	return getBurstStart(pulse / pulsesPerBurst) + (pulse % pulsesPerBurst) * pulseDuration;
+}
+
+simtime_t UWBIRPulseMapping::getPulseStart(long pulse) const
+{
+	return signalStart + getRelativePulseStart(pulse);
+}
+
+long UWBIRPulseMapping::findRelativePulse(simtime_t_cref rel) const
+{
+	const long nbShrPulses = static_cast<long>(shrPulses->size());
+
+	if(rel < dataStart || bits.empty()) {
+		// binary search in the synchronization header
+		return (std::upper_bound(shrPulses->begin(), shrPulses->end(), rel) - shrPulses->begin()) - 1;
+	}
+
+	// every burst lies inside its own data symbol, the divisions are
+	// corrected by one step if they were rounded to the wrong side
+	const simtime_t dataPos = rel - dataStart;
+	long            burst   = static_cast<long>(floor(dataPos / symbolDuration));
+	if(dataPos < burst * symbolDuration)
+		--burst;
+	else if(!(dataPos < (burst + 1) * symbolDuration))
+		++burst;
+	burst = std::min(burst, getNbBursts() - 1);
+
+	const simtime_t burstPos = rel - getBurstStart(burst);
+	if(burstPos < SIMTIME_ZERO)
+		return nbShrPulses + burst * pulsesPerBurst - 1;
+
+	long inBurst = static_cast<long>(floor(burstPos / pulseDuration));
+	if(burstPos < inBurst * pulseDuration)
+		--inBurst;
+	else if(!(burstPos < (inBurst + 1) * pulseDuration))
+		++inBurst;
+	inBurst = std::min(inBurst, static_cast<long>(pulsesPerBurst - 1));
+
+	return nbShrPulses + burst * pulsesPerBurst + inBurst;
+}
+
+long UWBIRPulseMapping::findPulse(simtime_t_cref t) const
+{
+	return findRelativePulse(t - signalStart);
+}
+
+UWBIRPulseMapping::argument_value_t UWBIRPulseMapping::getValue(simtime_t_cref t) const
+{
+	const simtime_t rel   = t - signalStart;
+	const long      pulse = findRelativePulse(rel);
+	if(pulse < 0)
+		return 0;
+
+	argument_value_t value = getPulseShape(rel - getRelativePulseStart(pulse));
+	// pulses of the synchronization header may overlap for some configurations
+	if(pulse > 0 && pulse <= static_cast<long>(shrPulses->size()))
+		value = std::max(value, getPulseShape(rel - getRelativePulseStart(pulse - 1)));
+
+	return value;
+}
+
+void UWBIRPulseMapping::getValues(const simtime_t* first, const simtime_t* last,
+                                  simtime_t_cref delay, argument_value_t* out) const
+{
+	if(first == last)
+		return;
+
+	const long      nbShrPulses = static_cast<long>(shrPulses->size());
+	const long      nbPulses    = getNbPulses();
+	const simtime_t shift       = signalStart + delay;
+	long            pulse       = findRelativePulse(*first - shift);
+
+	for(; first != last; ++first, ++out) {
+		const simtime_t rel = *first - shift;
+
+		// advance to the last pulse starting not after rel, search
+		// directly if more than one pulse has been passed
+		if(pulse + 1 < nbPulses && !(rel < getRelativePulseStart(pulse + 1))) {
+			if(pulse + 2 < nbPulses && !(rel < getRelativePulseStart(pulse + 2)))
+				pulse = findRelativePulse(rel);
+			else
+				++pulse;
+		}
+
+		if(pulse < 0) {
+			*out = 0;
+			continue;
+		}
+
+		*out = getPulseShape(rel - getRelativePulseStart(pulse));
+		// pulses of the synchronization header may overlap for some configurations
+		if(pulse > 0 && pulse <= nbShrPulses)
+			*out = std::max(*out, getPulseShape(rel - getRelativePulseStart(pulse - 1)));
+	}
+}
+
+ConstMappingIterator* UWBIRPulseMapping::createConstIterator() const
+{
+	return new UWBIRPulseMappingIterator(this);
+}
+
+ConstMappingIterator* UWBIRPulseMapping::createConstIterator(const Argument& pos) const
+{
+	ConstMappingIterator* it = new UWBIRPulseMappingIterator(this);
+	it->jumpTo(pos);
+	return it;
+}
+
+UWBIRPulseMappingIterator::UWBIRPulseMappingIterator(const UWBIRPulseMapping* mapping):
+	ConstMappingIterator(),
+	mapping(mapping),
+	position(),
+	nextPosition(),
+	bHasNext(false)
+{
+	assert(mapping);
+	jumpToBegin();
+}
+
+void UWBIRPulseMappingIterator::updateNextPosition()
+{
+	const simtime_t t     = position.getTime();
+	const long      pulse = mapping->findPulse(t);
+
+	bHasNext = true;
+	if(pulse >= 0) {
+		const simtime_t start = mapping->getPulseStart(pulse);
+		if(t < start + mapping->getHalfPulse()) {
+			nextPosition.setTime(start + mapping->getHalfPulse());
+			return;
+		}
+		if(t < mapping->getPulseEnd(pulse)) {
+			nextPosition.setTime(mapping->getPulseEnd(pulse));
+			return;
+		}
+	}
+
+	if(pulse + 1 < mapping->getNbPulses()) {
+		nextPosition.setTime(mapping->getPulseStart(pulse + 1));
+	}
+	else {
+		bHasNext = false;
+		nextPosition.setTime(t);
+	}
+}
+
+void UWBIRPulseMappingIterator::jumpTo(const Argument& pos)
+{
+	position.setTime(pos.getTime());
+	updateNextPosition();
+}
+
+void UWBIRPulseMappingIterator::jumpToBegin()
+{
+	if(mapping->getNbPulses() > 0)
+		position.setTime(mapping->getPulseStart(0));
+	updateNextPosition();
+}
+
+void UWBIRPulseMappingIterator::next()
+{
+	if(!bHasNext)
+		return;
+
+	position.setTime(nextPosition.getTime());
+	updateNextPosition();
+}
+
+bool UWBIRPulseMappingIterator::inRange() const
+{
+	const long nbPulses = mapping->getNbPulses();
+
+	return nbPulses > 0
+	       && !(position.getTime() < mapping->getPulseStart(0))
+	       && !(mapping->getPulseEnd(nbPulses - 1) < position.getTime());
+}
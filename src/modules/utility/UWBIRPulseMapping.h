@@ -0,0 +1,214 @@
+/* -*- mode:c++ -*- ********************************************************
+ * file:        UWBIRPulseMapping.h
+ *
+ *              This program is free software; you can redistribute it
+ *              and/or modify it under the terms of the GNU General Public
+ *              License as published by the Free Software Foundation; either
+ *              version 2 of the License, or (at your option) any later
+ *              version.
+ *              For further information see file COPYING
+ *              in the top level directory
+ * description: parametric pulse-level representation of an
+ *              IEEE 802.15.4A UWB-IR frame
+ ***************************************************************************/
+
+#ifndef UWBIRPULSEMAPPING_H_
+#define UWBIRPULSEMAPPING_H_
+
+#include <vector>
+
+#include "MiXiMDefs.h"
+#include "MappingBase.h"
+
+/**
+ * @brief Time domain Mapping describing the triangular pulses of an
+ * IEEE 802.15.4A UWB-IR frame (mandatory mode).
+ *
+ * Instead of storing three key entries per pulse as a TimeMapping would,
+ * this mapping only stores the (shared) pulse positions of the synchronization
+ * header and, for every data burst, the bit value and the hopping position.
+ * Pulse values are evaluated on demand: a pulse starting at t0 rises linearly
+ * from zero to the peak value at t0 + pulse/2 and falls back to zero at
+ * t0 + 2 * (pulse/2), which is one simulation time tick before t0 + pulse
+ * if the pulse duration is an odd number of ticks. Outside of any pulse the
+ * mapping is zero. All pulse times are calculated with simulation time
+ * precision, so they match the keys the equivalent TimeMapping would store.
+ *
+ * The iterators returned by this mapping visit the start, peak and end of
+ * every pulse, just like the iterator of the equivalent TimeMapping<Linear>.
+ *
+ * @ingroup ieee802154a
+ * @ingroup mappingDetails
+ */
+class MIXIM_API UWBIRPulseMapping : public ConstMapping {
+public:
+	/** @brief Type of the list of synchronization header pulse start times.*/
+	typedef std::vector<simtime_t> pulse_times_t;
+
+protected:
+	/** @brief Absolute start of the signal, all pulse times are relative to it.*/
+	simtime_t            signalStart;
+	/** @brief Sorted start times of the sync preamble and SFD pulses (not owned).*/
+	const pulse_times_t* shrPulses;
+
+	/** @brief Start of the first data symbol relative to signalStart.*/
+	simtime_t dataStart;
+	/** @brief Duration of a data symbol.*/
+	simtime_t symbolDuration;
+	/** @brief Time shift of the burst encoding a one bit.*/
+	simtime_t shiftDuration;
+	/** @brief Duration of a burst hopping position.*/
+	double    burstDuration;
+	/** @brief Duration of a single pulse and offset of its peak.*/
+	simtime_t pulseDuration, halfPulse;
+	/** @brief Offset of the end of a pulse (twice the rounded halfPulse).*/
+	simtime_t pulseEnd;
+	/** @brief Number of pulses forming a data burst.*/
+	int       pulsesPerBurst;
+	/** @brief Peak value of a pulse.*/
+	double    peak;
+
+	/** @brief Bit value of every data burst.*/
+	std::vector<bool>          bits;
+	/** @brief Hopping position of every data burst.*/
+	std::vector<unsigned char> hops;
+
+public:
+	/**
+	 * @brief Initializes an empty data section.
+	 *
+	 * The passed synchronization header pulses have to be sorted and
+	 * have to outlive this mapping and all its copies.
+	 */
+	UWBIRPulseMapping(simtime_t_cref       signalStart,
+	                  const pulse_times_t* shrPulses,
+	                  double dataStart,
+	                  double symbolDuration,
+	                  double shiftDuration,
+	                  double burstDuration,
+	                  double pulseDuration,
+	                  int    pulsesPerBurst,
+	                  double peak);
+
+	/** @brief Appends a data burst to the frame.*/
+	void addBurst(bool bitValue, int hoppingPos);
+
+	/** @brief Returns the number of data bursts of the frame.*/
+	long getNbBursts() const { return static_cast<long>(bits.size()); }
+
+	/** @brief Returns the total number of pulses of the frame.*/
+	long getNbPulses() const {
+		return static_cast<long>(shrPulses->size()) + getNbBursts() * pulsesPerBurst;
+	}
+
+	/** @brief Returns the absolute start time of the passed pulse.*/
+	simtime_t getPulseStart(long pulse) const;
+
+	/** @brief Returns the absolute end time of the passed pulse.*/
+	simtime_t getPulseEnd(long pulse) const { return getPulseStart(pulse) + pulseEnd; }
+
+	/** @brief Returns the half duration of a pulse, the offset of its peak.*/
+	simtime_t_cref getHalfPulse() const { return halfPulse; }
+
+	/**
+	 * @brief Returns the index of the last pulse starting not after t
+	 * or -1 if t lies before the first pulse.
+	 */
+	long findPulse(simtime_t_cref t) const;
+
+	/** @brief Returns the value of this mapping at the passed absolute time.*/
+	argument_value_t getValue(simtime_t_cref t) const;
+
+	virtual argument_value_t getValue(const Argument& pos) const {
+		return getValue(pos.getTime());
+	}
+
+	/**
+	 * @brief Writes the values of this mapping at the sorted absolute times
+	 * [first, last), each shifted back by delay, to out.
+	 *
+	 * Walks through the pulses together with the time points instead of
+	 * searching the pulse of every time point separately.
+	 */
+	void getValues(const simtime_t* first, const simtime_t* last,
+	               simtime_t_cref delay, argument_value_t* out) const;
+
+	virtual ConstMappingIterator* createConstIterator() const;
+
+	virtual ConstMappingIterator* createConstIterator(const Argument& pos) const;
+
+	virtual ConstMapping* constClone() const {
+		return new UWBIRPulseMapping(*this);
+	}
+
+protected:
+	/** @brief Returns the index of the last pulse starting not after rel (relative to signalStart).*/
+	long findRelativePulse(simtime_t_cref rel) const;
+
+	/** @brief Returns the start of the passed pulse relative to signalStart.*/
+	simtime_t getRelativePulseStart(long pulse) const;
+
+	/** @brief Returns the value of a pulse at the offset x from its start.*/
+	argument_value_t getPulseShape(simtime_t_cref x) const {
+		if(!(SIMTIME_ZERO < x) || !(x < pulseEnd))
+			return 0;
+		// triangular pulse
+		if(x < halfPulse)
+			return peak * (x / halfPulse);
+		return peak * ((pulseEnd - x) / (pulseEnd - halfPulse));
+	}
+
+	/** @brief Returns the start of the passed data burst relative to signalStart.*/
+	simtime_t getBurstStart(long burst) const {
+		simtime_t start = dataStart + burst * symbolDuration + simtime_t(hops[burst] * burstDuration);
+		if(bits[burst])
+			start += shiftDuration;
+		return start;
+	}
+};
+
+/**
+ * @brief ConstMappingIterator for UWBIRPulseMapping which visits the
+ * start, peak and end of every pulse.
+ *
+ * @ingroup ieee802154a
+ * @ingroup mappingDetails
+ */
+class MIXIM_API UWBIRPulseMappingIterator : public ConstMappingIterator {
+protected:
+	/** @brief The iterated mapping.*/
+	const UWBIRPulseMapping* mapping;
+	/** @brief Current and next position of the iterator.*/
+	Argument position, nextPosition;
+	/** @brief Stores if there is a key entry after the current position.*/
+	bool     bHasNext;
+
+protected:
+	/** @brief Updates the next position to the first key entry after the current position.*/
+	void updateNextPosition();
+
+public:
+	UWBIRPulseMappingIterator(const UWBIRPulseMapping* mapping);
+
+	virtual const Argument& getNextPosition() const { return nextPosition; }
+
+	virtual void jumpTo(const Argument& pos);
+
+	virtual void jumpToBegin();
+
+	virtual void iterateTo(const Argument& pos) { jumpTo(pos); }
+
+	virtual void next();
+
+	virtual bool inRange() const;
+
+	virtual bool hasNext() const { return bHasNext; }
+
+	virtual const Argument& getPosition() const { return position; }
+
+	virtual argument_value_t getValue() const {
+		return mapping->getValue(position.getTime());
+	}
+};
+
+#endif /* UWBIRPULSEMAPPING_H_ */
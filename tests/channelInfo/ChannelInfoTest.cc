@@ -19,6 +19,9 @@
 #include <ChannelInfo.h>
 #include <asserts.h>
 #include <OmnetTestBase.h>
+#include <ctime>
+#include <map>
+#include <iostream>
 
 /**
  * Unit test for isInBoundary method of class Coord
@@ -278,6 +281,206 @@ void testIntersections() {
 	assertEqual("Should be empty now..", 0u, v.size());
 }
 
+/**
+ * @brief Reference implementation of the AirFrame lookup ChannelInfo used
+ * before the interval index: one matrix for the active and one for the
+ * inactive AirFrames, each sorted by end time and, for equal end times, by
+ * start time. Inactive AirFrames are returned before the active ones.
+ */
+class AirFrameMatrix {
+protected:
+	typedef std::multimap<simtime_t, ChannelInfo::airframe_ptr_t> StartMap;
+	typedef std::map<simtime_t, StartMap> EndMap;
+
+	EndMap activeFrames;
+	EndMap inactiveFrames;
+
+	static void getIntersections(const EndMap& frames,
+								 simtime_t_cref from, simtime_t_cref to,
+								 ChannelInfo::AirFrameVector& out)
+	{
+		for(EndMap::const_iterator it = frames.lower_bound(from);
+			it != frames.end(); ++it)
+		{
+			StartMap::const_iterator itEnd = it->second.upper_bound(to);
+			for(StartMap::const_iterator itS = it->second.begin();
+				itS != itEnd; ++itS)
+			{
+				out.push_back(itS->second);
+			}
+		}
+	}
+
+	static void erase(EndMap& frames, simtime_t_cref start, simtime_t_cref end,
+					  ChannelInfo::airframe_ptr_t frame)
+	{
+		StartMap& starts = frames[end];
+		StartMap::iterator it = starts.lower_bound(start);
+		while(it->second != frame)
+			++it;
+		starts.erase(it);
+		if(starts.empty())
+			frames.erase(end);
+	}
+
+public:
+	void add(simtime_t_cref start, simtime_t_cref end,
+			 ChannelInfo::airframe_ptr_t frame)
+	{
+		activeFrames[end].insert(StartMap::value_type(start, frame));
+	}
+
+	void remove(simtime_t_cref start, simtime_t_cref end,
+				ChannelInfo::airframe_ptr_t frame)
+	{
+		erase(activeFrames, start, end, frame);
+		inactiveFrames[end].insert(StartMap::value_type(start, frame));
+	}
+
+	void getAirFrames(simtime_t_cref from, simtime_t_cref to,
+					  ChannelInfo::AirFrameVector& out) const
+	{
+		getIntersections(inactiveFrames, from, to, out);
+		getIntersections(activeFrames, from, to, out);
+	}
+
+	bool isActiveIntersecting(simtime_t_cref from, simtime_t_cref to) const
+	{
+		ChannelInfo::AirFrameVector v;
+		getIntersections(activeFrames, from, to, v);
+		return !v.empty();
+	}
+};
+
+/**
+ * @brief Compares the interval index of ChannelInfo against the old AirFrame
+ * matrices on a busy channel with many overlapping AirFrames.
+ *
+ * Both implementations have to return the same AirFrames in the same order,
+ * for queries during the transmissions as well as afterwards. The time both
+ * implementations spend in the queries is only written to std::cerr, so it
+ * does not affect the expected output.
+ */
+void testBusyChannel() {
+	const int numFrames = 5000;
+	const int queriesPerFrame = 4;
+
+	ChannelInfo testChannel;
+	AirFrameMatrix reference;
+	testChannel.startRecording(SIMTIME_ZERO);
+
+	unsigned long seed = 12345;
+	bool sameResults = true;
+	size_t numQueries = 0;
+	size_t numActiveQueries = 0;
+	double indexTime = 0;
+	double matrixTime = 0;
+	std::clock_t clockStart;
+	std::vector<simtime_t> from(numFrames * queriesPerFrame);
+	std::vector<simtime_t> to(numFrames * queriesPerFrame);
+	std::vector<ChannelInfo::AirFrameVector> v(numFrames * queriesPerFrame);
+	std::vector<ChannelInfo::AirFrameVector> vRef(numFrames * queriesPerFrame);
+
+	//deterministic CSMA like channel: short random back offs between frame
+	//starts and durations much longer than the back offs so that a lot of
+	//AirFrames overlap at every point in time
+	std::vector<simtime_t> starts;
+	std::vector<ChannelInfo::airframe_ptr_t> frames;
+	std::multimap<simtime_t, int> pendingEnds;
+	simtime_t now = SIMTIME_ZERO;
+	for(int i = 0; i < numFrames; ++i) {
+		seed = seed * 1103515245ul + 12345ul;
+		now += ((seed >> 16) % 100) * 0.00001;
+		seed = seed * 1103515245ul + 12345ul;
+		simtime_t duration = 0.001 + ((seed >> 16) % 400) * 0.00001;
+
+		//AirFrames are added and removed in chronological order
+		while(!pendingEnds.empty() && pendingEnds.begin()->first < now) {
+			int ended = pendingEnds.begin()->second;
+			testChannel.removeAirFrame(frames[ended]);
+			reference.remove(starts[ended], pendingEnds.begin()->first, frames[ended]);
+			pendingEnds.erase(pendingEnds.begin());
+		}
+
+		ChannelInfo::airframe_ptr_t frame = new ChannelInfo::airframe_t();
+		frame->setDuration(duration);
+		testChannel.addAirFrame(frame, now);
+		reference.add(now, now + duration, frame);
+		pendingEnds.insert(std::make_pair(now + duration, i));
+		starts.push_back(now);
+		frames.push_back(frame);
+
+		//queries around the current time hit active and inactive AirFrames
+		for(int q = 0; q < queriesPerFrame; ++q) {
+			seed = seed * 1103515245ul + 12345ul;
+			from[q] = now - ((seed >> 16) % 600) * 0.00001;
+			seed = seed * 1103515245ul + 12345ul;
+			to[q] = from[q] + ((seed >> 16) % 200) * 0.00001;
+			v[q].clear();
+			vRef[q].clear();
+		}
+		clockStart = std::clock();
+		for(int q = 0; q < queriesPerFrame; ++q)
+			testChannel.getAirFrames(from[q], to[q], v[q]);
+		indexTime += double(std::clock() - clockStart) / CLOCKS_PER_SEC;
+		clockStart = std::clock();
+		for(int q = 0; q < queriesPerFrame; ++q)
+			reference.getAirFrames(from[q], to[q], vRef[q]);
+		matrixTime += double(std::clock() - clockStart) / CLOCKS_PER_SEC;
+
+		for(int q = 0; q < queriesPerFrame && sameResults; ++q) {
+			sameResults = (v[q] == vRef[q]);
+			++numQueries;
+			if(reference.isActiveIntersecting(from[q], to[q]))
+				++numActiveQueries;
+		}
+	}
+	while(!pendingEnds.empty()) {
+		int ended = pendingEnds.begin()->second;
+		testChannel.removeAirFrame(frames[ended]);
+		reference.remove(starts[ended], pendingEnds.begin()->first, frames[ended]);
+		pendingEnds.erase(pendingEnds.begin());
+	}
+
+	//queries on the recorded, inactive AirFrames only
+	for(int i = 0; i < numFrames * queriesPerFrame; ++i) {
+		seed = seed * 1103515245ul + 12345ul;
+		int f = (seed >> 16) % numFrames;
+		seed = seed * 1103515245ul + 12345ul;
+		from[i] = starts[f];
+		to[i] = starts[f] + ((seed >> 16) % 200) * 0.00001;
+		v[i].clear();
+		vRef[i].clear();
+	}
+	clockStart = std::clock();
+	for(int i = 0; i < numFrames * queriesPerFrame; ++i)
+		testChannel.getAirFrames(from[i], to[i], v[i]);
+	indexTime += double(std::clock() - clockStart) / CLOCKS_PER_SEC;
+	clockStart = std::clock();
+	for(int i = 0; i < numFrames * queriesPerFrame; ++i)
+		reference.getAirFrames(from[i], to[i], vRef[i]);
+	matrixTime += double(std::clock() - clockStart) / CLOCKS_PER_SEC;
+
+	for(int i = 0; i < numFrames * queriesPerFrame && sameResults; ++i) {
+		sameResults = (v[i] == vRef[i]);
+		++numQueries;
+	}
+
+	assertTrue("Interval index returns the same AirFrames in the same order "
+			   "as the AirFrame matrices.", sameResults, true);
+	assertTrue("Every query was checked.",
+			   numQueries == size_t(2 * numFrames * queriesPerFrame), true);
+	assertTrue("Queries intersected active AirFrames.",
+			   numActiveQueries > 0, true);
+
+	std::cerr << "ChannelInfo benchmark: " << 2 * numFrames * queriesPerFrame
+			  << " queries on " << numFrames << " AirFrames, "
+			  << "interval index " << indexTime << "s, "
+			  << "AirFrame matrices " << matrixTime << "s" << std::endl;
+
+	//deletes the AirFrames kept for recording
+	testChannel.stopRecording();
+}
 
 class ChannelInfoTest:public SimpleTest {
 protected:
@@ -421,6 +624,7 @@ protected:
 
 	void runTests() {
 		testIntersections();
+		testBusyChannel();
 
 		testRecordingFlag();
 		testsExecuted = true;
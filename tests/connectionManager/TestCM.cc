@@ -30,12 +30,32 @@ void TestCM::updateConnections(int nicID, const Coord* oldPos, const Coord* newP
 	displayPassed = false;
 	assertTrue("NicID should exists.", nic != 0);
 
+	checkConnections(nic);
+}
+
+void TestCM::flushPositionUpdates() {
+	const bool pending = !pendingMoves.empty();
+
+	BaseConnectionManager::flushPositionUpdates();
+
+	// batched updates bypass updateConnections(), so check every nic
+	if(pending) {
+		for(NicEntries::iterator i = nics.begin(); i != nics.end(); ++i)
+		{
+			checkConnections(i->second);
+		}
+	}
+}
+
+void TestCM::checkConnections(NicEntry* nic) {
+	displayPassed = false;
+
 	for(NicEntries::iterator i = nics.begin(); i != nics.end(); ++i)
 	{
 		NicEntry* nic_i = i->second;
 
 		// no recursive connections
-		if ( nic_i->nicId == nicID ) continue;
+		if ( nic_i == nic ) continue;
 
 		double distance;
 
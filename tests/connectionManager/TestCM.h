@@ -22,12 +22,19 @@
 /**
  * @brief Checks after every update of the connection if the
  * hosts are connected correctly by checking every single host pair.
+ *
+ * With batched position updates the check is done after every flush
+ * of the pending updates.
  */
 class TestCM : public BaseConnectionManager
 {
 protected:
 	virtual double calcInterfDist();
 	virtual void updateConnections(int nicID, const Coord* oldPos, const Coord* newPos);
+	virtual void flushPositionUpdates();
+
+	/** @brief Asserts that the passed nic is connected to exactly the nics in range.*/
+	void checkConnections(NicEntry* nic);
 };
 
 #endif
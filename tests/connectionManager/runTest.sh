@@ -47,6 +47,8 @@ fi
 ./${lSingle} -c Test2 "${LIBSREF[@]}">> out.tmp 2>> err.tmp
 ./${lSingle} -c Test3 "${LIBSREF[@]}">> out.tmp 2>> err.tmp
 ./${lSingle} -c Test4 "${LIBSREF[@]}">> out.tmp 2>> err.tmp
+./${lSingle} -c Moving        "${LIBSREF[@]}">  outMoving.tmp  2>> err.tmp
+./${lSingle} -c MovingBatched "${LIBSREF[@]}">  outBatched.tmp 2>> err.tmp
 
 [ x$lIsComb = x1 ] && rm -f ${lSingle} ${lSingle}.exe >/dev/null 2>&1
 diff -I '^Assigned runID=' \
@@ -58,6 +60,17 @@ diff -I '^Assigned runID=' \
      -I '^** Event #' \
      -w exp-output out.tmp >diff.log 2>/dev/null
 
+# batched position updates have to result in the same connections as the
+# updates per move, only the number of events differs
+grep -e '^FAILED' outMoving.tmp outBatched.tmp >>diff.log
+diff -I '^Assigned runID=' \
+     -I '^Preparing for running configuration' \
+     -I '^     Speed:' \
+     -I '^     Messages:' \
+     -I '^** Event #' \
+     -I '^<!> ' \
+     -w outMoving.tmp outBatched.tmp >>diff.log 2>/dev/null
+
 if [ -s diff.log ]; then
     echo "FAILED counted $(( 1 + $(grep -c -e '^---$' diff.log) )) differences where #<=$(grep -c -e '^<' diff.log) and #>=$(grep -c -e '^>' diff.log); see $(basename $(cd $(dirname $0);pwd) )/diff.log"
     [ "$1" = "update-exp-output" ] && \
@@ -65,6 +78,6 @@ if [ -s diff.log ]; then
     exit 1
 else
     echo "PASSED $(basename $(cd $(dirname $0);pwd) )"
-    rm -f out.tmp diff.log err.tmp
+    rm -f out.tmp outMoving.tmp outBatched.tmp diff.log err.tmp
 fi
 exit 0
@@ -0,0 +1,105 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <cmath>
+#include <string>
+
+#include <Decider802154Narrow.h>
+#include <asserts.h>
+#include <OmnetTestBase.h>
+
+/**
+ * @brief Decider802154Narrow which can be configured without a phy layer.
+ */
+class TestDecider802154Narrow : public Decider802154Narrow {
+public:
+	TestDecider802154Narrow():
+		Decider802154Narrow(NULL, 0, 0, false)
+	{}
+
+	void configure(Modulation newModulation, double berLowerBound, double resolution) {
+		modulation      = newModulation;
+		BER_LOWER_BOUND = berLowerBound;
+		berTable        = getBERTable(modulation, BER_LOWER_BOUND, -10.0, 20.0, resolution, 1e-3);
+	}
+
+	bool hasTable() const { return berTable != NULL; }
+
+	double getBER(double snrDb) const { return getBERFromSNR(pow(10.0, snrDb / 10.0)); }
+
+	double getExactBER(double snrDb) const {
+		return std::max(calcBERFromSNR(modulation, pow(10.0, snrDb / 10.0)), BER_LOWER_BOUND);
+	}
+};
+
+/**
+ * @brief Unit tests for the BER lookup table of Decider802154Narrow.
+ */
+class Decider802154Test : public SimpleTest {
+protected:
+	/**
+	 * @brief Returns the largest relative difference between the BER of the
+	 * decider and the closed-form BER for SNRs from minDb to maxDb.
+	 */
+	double maxRelativeError(const TestDecider802154Narrow& decider, double minDb, double maxDb) {
+		double worst = 0;
+		for(int i = 0; minDb + i * 0.001 <= maxDb; ++i) {
+			const double snrDb = minDb + i * 0.001;
+			const double exact = decider.getExactBER(snrDb);
+			worst = std::max(worst, fabs(decider.getBER(snrDb) - exact) / exact);
+		}
+		return worst;
+	}
+
+	void testTable(Decider802154Narrow::Modulation modulation, std::string name) {
+		TestDecider802154Narrow decider;
+
+		decider.configure(modulation, 1e-8, 0);
+		assertFalse(name + ": no table by default.", decider.hasTable());
+		assertEqual(name + ": BER without table is the closed form.", 0.0, maxRelativeError(decider, -10.0, 20.0));
+
+		decider.configure(modulation, 1e-8, 0.1);
+		assertTrue(name + ": table is built.", decider.hasTable());
+		assertTrue(name + ": table within its maximum error.", maxRelativeError(decider, -10.0, 20.0) <= 1e-3);
+		assertEqual(name + ": closed form below the table.", 0.0, maxRelativeError(decider, -15.0, -10.001));
+		assertEqual(name + ": BER floor above the table.", 1e-8, decider.getBER(25.0));
+
+		std::cout << name << " BER table tests successful." << std::endl;
+	}
+
+	void testSharing() {
+		typedef Decider802154Narrow D;
+
+		const D::BERTable* table = D::getBERTable(D::OQPSK16, 1e-8, -10.0, 20.0, 0.1, 1e-3);
+		assertTrue("Same parameters share the table.", table == D::getBERTable(D::OQPSK16, 1e-8, -10.0, 20.0, 0.1, 1e-3));
+		assertTrue("Other modulation has its own table.", table != D::getBERTable(D::MSK, 1e-8, -10.0, 20.0, 0.1, 1e-3));
+		assertTrue("Other BER floor has its own table.", table != D::getBERTable(D::OQPSK16, 1e-9, -10.0, 20.0, 0.1, 1e-3));
+		assertTrue("Resolution 0 disables the table.", D::getBERTable(D::OQPSK16, 1e-8, -10.0, 20.0, 0, 1e-3) == NULL);
+		assertTrue("Empty range disables the table.", D::getBERTable(D::OQPSK16, 1e-8, 20.0, 20.0, 0.1, 1e-3) == NULL);
+
+		std::cout << "BER table sharing tests successful." << std::endl;
+	}
+
+	void runTests() {
+		testTable(Decider802154Narrow::MSK,     "msk");
+		testTable(Decider802154Narrow::OQPSK16, "oqpsk16");
+		testTable(Decider802154Narrow::GFSK,    "gfsk");
+		testSharing();
+
+		testsExecuted = true;
+	}
+};
+
+Define_Module(Decider802154Test);
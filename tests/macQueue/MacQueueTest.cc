@@ -0,0 +1,263 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <list>
+
+#include <BoundedMacQueue.h>
+#include <asserts.h>
+#include <OmnetTestBase.h>
+
+/**
+ * @brief BoundedMacQueue with access to the number of its sub-queues and
+ * to the queuing order of its classes.
+ */
+class TestQueue : public BoundedMacQueue<int, int> {
+public:
+	TestQueue(size_t capacity = 0, int nbPriorities = 1):
+		BoundedMacQueue<int, int>(capacity, nbPriorities)
+	{}
+
+	size_t getNbSubQueues() const { return subQueues.size(); }
+
+	size_t getNbArrivals(int priority) const { return classes[priority].arrivals.size(); }
+};
+
+/**
+ * @brief Packet of the reference list the queue is compared with.
+ */
+struct RefPacket {
+	int id, priority, dest;
+};
+
+/**
+ * @brief Unit tests for the capacity, the drop policy and the service
+ * order of BoundedMacQueue.
+ */
+class MacQueueTest : public SimpleTest {
+protected:
+	void testCapacity() {
+		TestQueue q(3);
+
+		assertTrue("New queue is empty.", q.empty());
+		assertFalse("New queue is not full.", q.full());
+		assertTrue("Push 1 into queue of capacity 3.", q.push_back(1));
+		assertTrue("Push 2 into queue of capacity 3.", q.push_back(2));
+		assertTrue("Push 3 into queue of capacity 3.", q.push_back(3));
+		assertTrue("Queue is full after 3 packets.", q.full());
+
+		// tail drop, the queued packets are kept
+		assertFalse("Push into full queue is refused.", q.push_back(4));
+		assertEqual("Refused packet is not queued.", (size_t)3, q.size());
+		assertEqual("Refused packet is counted as dropped.", 1ul, q.getNbDropped());
+		assertEqual("Refused packet is not counted as enqueued.", 3ul, q.getNbEnqueued());
+		assertEqual("Oldest packet is kept.", 1, q.front());
+
+		q.pop_front();
+		assertTrue("Push after pop is accepted.", q.push_back(5));
+		assertEqual("Max length is the capacity.", (size_t)3, q.getMaxLength());
+
+		q.setCapacity(0);
+		for(int i = 0; i < 100; ++i)
+			q.push_back(i);
+		assertFalse("Unbounded queue is never full.", q.full());
+		assertEqual("Unbounded queue holds all packets.", (size_t)103, q.size());
+
+		std::cout << "Capacity tests successful." << std::endl;
+	}
+
+	void testFifo() {
+		TestQueue q;
+		bool      inOrder = true;
+
+		// enough packets to wrap and grow the ring buffer several times
+		int pushed = 0, popped = 0;
+		for(int round = 0; round < 20; ++round) {
+			for(int i = 0; i < 2 * round + 3; ++i)
+				q.push_back(pushed++);
+			for(int i = 0; i < round + 1; ++i) {
+				inOrder = inOrder && q.front() == popped++;
+				q.pop_front();
+			}
+		}
+		assertTrue("Packets leave in the order they were queued.", inOrder);
+
+		std::cout << "FIFO tests successful." << std::endl;
+	}
+
+	void testPriorities() {
+		TestQueue q(0, 3);
+
+		q.push_back(20, 2);
+		q.push_back(10, 1);
+		q.push_back(21, 2);
+		q.push_back(0, 0);
+		q.push_back(11, 1);
+
+		assertEqual("Highest priority first.", 0, q.front());
+		q.pop_front();
+		assertEqual("Then the oldest of priority 1.", 10, q.front());
+		q.pop_front();
+		assertEqual("Then the newer of priority 1.", 11, q.front());
+		q.pop_front();
+		q.push_back(1, 0);
+		assertEqual("A new packet of higher priority overtakes.", 1, q.front());
+		q.pop_front();
+		assertEqual("Then the oldest of priority 2.", 20, q.front());
+		q.pop_front();
+		assertEqual("Then the newer of priority 2.", 21, q.front());
+		q.pop_front();
+		assertTrue("Queue is empty again.", q.empty());
+
+		std::cout << "Priority tests successful." << std::endl;
+	}
+
+	void testDestinations() {
+		TestQueue q(0, 2);
+
+		q.push_back(100, 1, 1);
+		q.push_back(200, 1, 2);
+		q.push_back(101, 1, 1);
+		q.push_back(300, 1, 3);
+		q.push_back(201, 0, 2);
+
+		assertTrue("Packet for destination 1 is queued.", q.hasPacketFor(1));
+		assertFalse("No packet for destination 4 is queued.", q.hasPacketFor(4));
+		assertEqual("One sub-queue per class and destination.", (size_t)4, q.getNbSubQueues());
+		assertEqual("Next packet for destination 2 has the higher priority.", 201, q.front(2));
+		assertEqual("Next packet for destination 1.", 100, q.front(1));
+
+		q.pop_front(1);
+		assertEqual("Next packet for destination 1 after pop.", 101, q.front(1));
+		assertEqual("Next packet overall has the highest priority.", 201, q.front());
+		q.pop_front();
+		assertEqual("Emptied sub-queue is kept.", (size_t)4, q.getNbSubQueues());
+		assertEqual("Next packet overall is the oldest of priority 1.", 200, q.front());
+
+		q.pop_front(3);
+		q.pop_front(1);
+		assertFalse("Destination 1 has no packets left.", q.hasPacketFor(1));
+		assertEqual("Last packet.", 200, q.front());
+		q.pop_front();
+		assertTrue("Queue is empty again.", q.empty());
+		assertFalse("Empty queue has no packet for a known destination.", q.hasPacketFor(2));
+
+		q.push_back(102, 1, 1);
+		q.push_back(202, 0, 2);
+		assertEqual("Sub-queues are reused.", (size_t)4, q.getNbSubQueues());
+		assertEqual("Reused sub-queue for destination 1.", 102, q.front(1));
+		assertEqual("Reused sub-queue of higher priority first.", 202, q.front());
+
+		std::cout << "Destination tests successful." << std::endl;
+	}
+
+	void testServedByDestination() {
+		TestQueue q;
+
+		// one packet waits while many others are served by destination
+		q.push_back(0, 0, 1);
+		for(int i = 1; i <= 1000; ++i) {
+			q.push_back(i, 0, 2);
+			q.pop_front(2);
+		}
+		assertEqual("Waiting packet is still queued.", (size_t)1, q.size());
+		assertTrue("Served packets do not pile up in the queuing order.", q.getNbArrivals(0) <= 20);
+		assertEqual("Waiting packet is next.", 0, q.front());
+		q.pop_front();
+		assertEqual("Queuing order is empty with the queue.", (size_t)0, q.getNbArrivals(0));
+
+		// served packets in front of the queuing order are skipped
+		q.push_back(10, 0, 1);
+		q.push_back(20, 0, 2);
+		q.push_back(11, 0, 1);
+		q.pop_front(1);
+		assertEqual("Oldest packet of the remaining ones is next.", 20, q.front());
+		q.pop_front();
+		assertEqual("Then the newer packet of the served destination.", 11, q.front());
+
+		std::cout << "Served by destination tests successful." << std::endl;
+	}
+
+	/**
+	 * @brief Compares the queue with a list searched from the front for
+	 * random operations.
+	 */
+	void testAgainstList() {
+		typedef std::list<RefPacket> Reference;
+
+		const size_t  capacity = 50;
+		TestQueue     q(capacity, 3);
+		Reference     ref;
+		unsigned long state  = 12345;
+		bool          equal  = true;
+		int           nextId = 0;
+
+		for(int step = 0; step < 20000 && equal; ++step) {
+			state = state * 1103515245ul + 12345ul;
+			const int r = static_cast<int>((state >> 16) & 0x7fff);
+
+			if(r % 5 < 3) {
+				RefPacket p = { nextId++, (r / 5) % 3, (r / 15) % 8 };
+				const bool accepted = q.push_back(p.id, p.priority, p.dest);
+				equal = (accepted == (ref.size() < capacity));
+				if(accepted)
+					ref.push_back(p);
+			}
+			else if(!ref.empty()) {
+				Reference::iterator next = ref.end();
+				if(r % 5 == 3) {
+					// oldest of the highest priority
+					for(Reference::iterator it = ref.begin(); it != ref.end(); ++it) {
+						if(next == ref.end() || it->priority < next->priority)
+							next = it;
+					}
+					equal = (q.front() == next->id);
+					q.pop_front();
+				}
+				else {
+					// oldest of the highest priority for one destination
+					const int dest = (r / 5) % 8;
+					for(Reference::iterator it = ref.begin(); it != ref.end(); ++it) {
+						if(it->dest == dest && (next == ref.end() || it->priority < next->priority))
+							next = it;
+					}
+					equal = (q.hasPacketFor(dest) == (next != ref.end()));
+					if(equal && next != ref.end()) {
+						equal = (q.front(dest) == next->id);
+						q.pop_front(dest);
+					}
+				}
+				if(next != ref.end())
+					ref.erase(next);
+			}
+			equal = equal && q.size() == ref.size() && q.getNbSubQueues() <= 3 * 8;
+		}
+		assertTrue("Random operations match the reference list.", equal);
+
+		std::cout << "Reference tests successful." << std::endl;
+	}
+
+	void runTests() {
+		testCapacity();
+		testFifo();
+		testPriorities();
+		testDestinations();
+		testServedByDestination();
+		testAgainstList();
+
+		testsExecuted = true;
+	}
+};
+
+Define_Module(MacQueueTest);
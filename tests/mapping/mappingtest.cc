@@ -345,6 +345,84 @@ protected:
 		//displayPassed = false;
 	}
 
+	/**
+	 * @brief Checks Arguments with more dimensions than they store inline.
+	 */
+	void testArgManyDimensions() {
+		const int    nbDims = 10;
+		Dimension    dims[nbDims];
+		DimensionSet dimSet(Dimension::time);
+
+		// new dimensions get ascending ids, so dims is sorted
+		for(int i = 0; i < nbDims; ++i) {
+			std::ostringstream name;
+			name << "manyDims" << i;
+			dims[i] = Dimension(name.str());
+			dimSet.addDimension(dims[i]);
+		}
+
+		// inserted out of order, grows from the inline values to the heap twice
+		const int order[nbDims] = { 4, 1, 9, 6, 0, 8, 3, 5, 7, 2 };
+		Argument a1(1.0);
+		for(int i = 0; i < nbDims; ++i)
+			a1.setArgValue(dims[order[i]], order[i] * 1.5);
+
+		bool sorted = true;
+		int  nbValues = 0;
+		for(Argument::const_iterator it = a1.begin(); it != a1.end(); ++it, ++nbValues)
+			sorted = sorted && nbValues < nbDims && it->first == dims[nbValues] && it->second == nbValues * 1.5;
+		assertTrue("Values of many dimensions are sorted by dimension.", sorted);
+		assertEqual("Argument holds a value per dimension.", nbDims, nbValues);
+		assertTrue("Argument is defined over all dimensions.", dimSet == a1.getDimensions());
+		assertEqual("Value of the last inserted dimension.", 2 * 1.5, a1.getArgValue(dims[2]));
+		a1.setArgValue(dims[2], 3.0);
+		assertEqual("Value of a heap stored dimension is updated.", 3.0, a1.getArgValue(dims[2]));
+		assertEqual("Update does not add a value.", (size_t)nbDims, a1.getDimensions().size() - 1);
+
+		// created over all dimensions and filled in reverse order
+		Argument a2(dimSet, 1.0);
+		for(int i = nbDims - 1; i >= 0; --i)
+			a2.setArgValue(dims[i], i * 1.5);
+		assertTrue("Arguments of different insert orders are equal.", a1 == a2);
+		assertEqual("Arguments of different insert orders are compared equal.", 0, a1.compare(a2, &dimSet));
+
+		// the highest dimension decides, the lower ones only on a tie
+		a2.setArgValue(dims[0], -1.0);
+		assertTrue("Smaller value of the lowest dimension is smaller.", a2 < a1);
+		assertTrue("Smaller value of the lowest dimension is compared smaller.", a2.compare(a1, &dimSet) < 0);
+		a2.setArgValue(dims[nbDims - 1], 100.0);
+		assertTrue("Bigger value of the highest dimension is bigger.", a1 < a2);
+		assertTrue("Bigger value of the highest dimension is compared bigger.", a2.compare(a1, &dimSet) > 0);
+		assertFalse("Arguments with different values are not equal.", a1 == a2);
+
+		// copies of a heap stored Argument
+		Argument copy(a1);
+		assertTrue("Copy equals the original.", copy == a1);
+		copy.setArgValue(dims[5], 42.0);
+		assertEqual("Copy has its own values.", 5 * 1.5, a1.getArgValue(dims[5]));
+		Argument assigned(2.0);
+		assigned.setArgValue(dims[3], 1.0);
+		assigned = a1;
+		assertTrue("Assigned Argument equals the original.", assigned == a1);
+		assigned = Argument(2.0);
+		assertFalse("Assigned Argument without dimensions has no values.", assigned.hasArgVal(dims[3]));
+
+		// merging into an Argument with fewer dimensions
+		Argument part(1.0);
+		part.setArgValue(dims[1], 1.5);
+		part.setArgValue(dims[7], 7 * 1.5);
+		assertTrue("Argument is at the same position as a part of it.", a1.isSamePosition(part));
+		assertFalse("Part is not at the same position as the whole Argument.", part.isSamePosition(a1));
+
+		Argument known(part);
+		known.setArgValues(a1, true);
+		assertEqual("Only known dimensions are updated.", (size_t)3, known.getDimensions().size());
+		assertEqual("Known dimension is updated.", 7 * 1.5, known.getArgValue(dims[7]));
+
+		part.setArgValues(a1);
+		assertTrue("Merge adds the missing dimensions.", part == a1);
+	}
+
 
 
 	template<class F>
@@ -1055,6 +1133,69 @@ protected:
 
 	}
 
+	void testGridMapping() {
+		DimensionSet dimSet(Dimension::time, freq);
+
+		// a sparse grid has to behave like a MultiDimMapping with the same entries
+		for(int oor = 0; oor < 2; ++oor) {
+			Mapping* multi = oor ? static_cast<Mapping*>(new MultiDimMapping<Linear>(dimSet, 0.5))
+			                     : static_cast<Mapping*>(new MultiDimMapping<Linear>(dimSet));
+			Mapping* grid  = oor ? new GridMapping(dimSet, 0.5) : new GridMapping(dimSet);
+
+			const double entries[][3] = { {2, 1, 5}, {2, 3, 10}, {3, 2, 50}, {4, 1, 20}, {4, 4, 7}, {3, 3.5, 1} };
+			for(unsigned int k = 0; k < sizeof(entries) / sizeof(entries[0]); ++k) {
+				multi->setValue(A(entries[k][0], entries[k][1]), entries[k][2]);
+				grid->setValue(A(entries[k][0], entries[k][1]), entries[k][2]);
+			}
+
+			for(double i = 1.0; i <= 5.0; i+=0.25) {
+				for(double j = 0.5; j <= 4.5; j+=0.25) {
+					assertClose("GridMapping value at " + toString(i) + "," + toString(j),
+					            multi->getValue(A(i, j)), grid->getValue(A(i, j)));
+				}
+			}
+
+			MappingIterator* itMulti = multi->createIterator();
+			MappingIterator* itGrid  = grid->createIterator();
+			while(itMulti->hasNext()) {
+				assertTrue("GridMapping iterator has next.", itGrid->hasNext());
+				assertTrue("GridMapping iterator position.", itMulti->getPosition() == itGrid->getPosition());
+				assertTrue("GridMapping iterator next position.", itMulti->getNextPosition() == itGrid->getNextPosition());
+				assertClose("GridMapping iterator value.", itMulti->getValue(), itGrid->getValue());
+				itMulti->next();
+				itGrid->next();
+			}
+			assertFalse("GridMapping iterator at end.", itGrid->hasNext());
+			delete itMulti;
+			delete itGrid;
+
+			delete multi;
+			delete grid;
+		}
+
+		// operators on identical full grids are calculated point by point
+		Mapping* g1 = new GridMapping(dimSet);
+		Mapping* g2 = new GridMapping(dimSet);
+		for(double i = 1.0; i <= 3.0; i+=1.0) {
+			for(double j = 1.0; j <= 4.0; j+=1.0) {
+				g1->setValue(A(i, j), i * j);
+				g2->setValue(A(i, j), i + j);
+			}
+		}
+		Mapping* res = MappingUtils::multiply(*g1, *g2);
+		assertTrue("Product of full grids is a grid.", dynamic_cast<GridMapping*>(res) != 0);
+		for(double i = 1.0; i <= 3.0; i+=1.0) {
+			for(double j = 1.0; j <= 4.0; j+=1.0) {
+				assertClose("Product of full grids at " + toString(i) + "," + toString(j),
+				            g1->getValue(A(i, j)) * g2->getValue(A(i, j)),
+				            res->getValue(A(i, j)));
+			}
+		}
+		delete res;
+		delete g1;
+		delete g2;
+	}
+
 
 	void testSteps() {
 		Mapping* t1 = MappingUtils::createMapping(DimensionSet(Dimension::time), Mapping::STEPS);
@@ -2631,22 +2772,115 @@ protected:
 		delete multi1;
 	}
 
+	/**
+	 * @brief Checks that findQuotientStats() finds the same minimum and
+	 * maximum as findMin() and findMax() on the divided mappings.
+	 */
+	void testFindQuotientStats() {
+		DimensionSet timeFreq(time, freq);
+
+		Mapping* numerator = MappingUtils::createMapping(timeFreq);
+		Mapping* noise1    = MappingUtils::createMapping(timeFreq);
+		Mapping* noise2    = MappingUtils::createMapping(timeFreq);
+		//constant noise over time only, like the thermal noise of the phy layer
+		ConstMapping* thermal = new ConstantSimpleConstMapping(DimensionSet::timeDomain, A(1), 0.5);
+
+		for(int f = 1; f <= 2; ++f) {
+			for(int t = 1; t <= 4; ++t) {
+				numerator->setValue(A(f, t), 1.0 + t * f);
+			}
+			noise1->setValue(A(f, 1.5), 2.0 * f);
+			noise1->setValue(A(f, 3),   0.5);
+			noise2->setValue(A(f, 2),   1.0);
+			noise2->setValue(A(f, 4),   3.0 / f);
+		}
+
+		MappingUtils::MappingSummands denominator;
+		denominator.push_back(noise1);
+		denominator.push_back(thermal);
+		denominator.push_back(noise2);
+
+		Mapping* noiseSum = MappingUtils::add(*noise1, *thermal);
+		Mapping* tmp      = noiseSum;
+		noiseSum = MappingUtils::add(*noiseSum, *noise2);
+		delete tmp;
+		Mapping* quotient = MappingUtils::divide(*numerator, *noiseSum);
+
+		const double times[] = { 0.5, 1, 1.5, 2, 3, 4 };
+		const int    nTimes  = sizeof(times) / sizeof(times[0]);
+
+		for(int t1 = 0; t1 < nTimes; ++t1) {
+		for(int t2 = t1; t2 < nTimes; ++t2) {
+		for(int f1 = 1; f1 <= 2; ++f1) {
+		for(int f2 = f1; f2 <= 2; ++f2) {
+			const Argument from(A(f1, times[t1]));
+			const Argument to(A(f2, times[t2]));
+			const std::string range = " in (" + toString(f1) + "," + toString(times[t1]) + ") to (" + toString(f2) + "," + toString(times[t2]) + ").";
+
+			MappingUtils::QuotientStats stats;
+			if(MappingUtils::findQuotientStats(*numerator, denominator, from, to, stats)) {
+				assertClose("Quotient min" + range, MappingUtils::findMin(*quotient, from, to), stats.min);
+				assertClose("Quotient max" + range, MappingUtils::findMax(*quotient, from, to), stats.max);
+				assertTrue("Quotient mean between min and max" + range, stats.min <= stats.mean && stats.mean <= stats.max);
+			}
+			else {
+				assertEqual("No quotient min" + range, MappingUtils::cMinNotFound, MappingUtils::findMin(*quotient, from, to));
+			}
+		}
+		}
+		}
+		}
+
+		delete quotient;
+		delete noiseSum;
+		delete numerator;
+		delete noise1;
+		delete noise2;
+		delete thermal;
+
+		//a step of the numerator at time 1, the mean has to be weighted by time
+		Mapping* step  = MappingUtils::createMapping();
+		Mapping* level = MappingUtils::createMapping();
+		step->setValue(A(0), 1.0);
+		step->setValue(A[1], 1.0);
+		step->setValue(A(1), 3.0);
+		step->setValue(A(4), 3.0);
+		level->setValue(A(0), 1.0);
+		level->setValue(A(4), 1.0);
+
+		MappingUtils::MappingSummands levelOnly(1, level);
+		MappingUtils::QuotientStats   stats;
+		assertTrue("Quotient of step found.", MappingUtils::findQuotientStats(*step, levelOnly, A(0), A(4), stats));
+		assertClose("Time weighted quotient mean over the step.", 2.5, stats.mean);
+		MappingUtils::findQuotientStats(*step, levelOnly, A(0), A(2), stats);
+		assertClose("Time weighted quotient mean until shortly after the step.", 2.0, stats.mean);
+		MappingUtils::findQuotientStats(*step, levelOnly, A(2), A(2), stats);
+		assertClose("Quotient mean without time covered.", 3.0, stats.mean);
+
+		delete step;
+		delete level;
+	}
+
 	void testMappingUtils() {
 		testFindMinMax();
+		testFindQuotientStats();
 	}
 
 	void runTests() {
 		displayPassed = false;
 		testDimension();
 		testArg();
+		testArgManyDimensions();
 		//testDoubleCompareLess();
 
 	    testSimpleFunction<TimeMapping<Linear> >();
+	    testSimpleFunction<TimeMapping<Linear, TimeMappingVectorStorage> >();
 	    const char cSaveFill = std::cout.fill();
 
 	    std::cout << std::setw(80) << std::setfill('-') << std::internal << " TimeMapping tests done. " << std::setw(48) << "" << std::setfill(cSaveFill) << std::endl; std::cout.flush();
 
 	    testMultiFunction();
+	    testGridMapping();
 	    std::cout << std::setw(80) << std::setfill('-') << std::internal << " MultiDimMapping tests done. " << std::setw(48) << "" << std::setfill(cSaveFill) << std::endl; std::cout.flush();
 
 	    testInterpolationMethods();
@@ -0,0 +1,314 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <map>
+
+#include <NeighborTable.h>
+#include <DuplicateCache.h>
+#include <netw/Flood.h>
+#include <asserts.h>
+#include <OmnetTestBase.h>
+
+/**
+ * @brief Hash which lets all keys of the same ten collide.
+ */
+struct CollidingHash {
+	size_t operator()(int key) const { return static_cast<size_t>(key / 10); }
+};
+
+/**
+ * @brief NeighborTable with access to its hash index.
+ */
+class TestTable : public NeighborTable<int, int, CollidingHash> {
+public:
+	TestTable(size_t capacity = 0, bool growable = false):
+		NeighborTable<int, int, CollidingHash>(capacity, growable)
+	{}
+
+	size_t getNbBuckets() const { return buckets.size(); }
+
+	size_t homeOf(int key) const { return bucketOf(key); }
+
+	/** @brief Returns the bucket holding key, the number of buckets if it is unknown.*/
+	size_t bucketHolding(int key) const {
+		for(size_t b = 0; b < buckets.size(); ++b) {
+			if(buckets[b] != NONE && slots[buckets[b]].key == key)
+				return b;
+		}
+		return buckets.size();
+	}
+};
+
+/**
+ * @brief Gives access to the duplicate cache type of Flood.
+ */
+class TestFlood : public Flood {
+public:
+	typedef BcastId        Id;
+	typedef cBroadcastList BroadcastList;
+};
+
+/**
+ * @brief Unit tests for the hash index, the least recently used replacement
+ * and the growth of NeighborTable and for the DuplicateCache built on it.
+ */
+class NeighborTableTest : public SimpleTest {
+protected:
+	void testBasics() {
+		NeighborTable<int, int> table(4);
+
+		assertTrue("New table is empty.", table.empty());
+		assertTrue("Unknown key is not found.", table.find(1) == NULL);
+
+		bool inserted = false;
+		*table.update(1, &inserted) = 10;
+		assertTrue("Update of an unknown key inserts it.", inserted);
+		*table.update(2) = 20;
+		assertEqual("Entry of key 1.", 10, *table.find(1));
+		assertEqual("Entry of key 2.", 20, *table.find(2));
+
+		assertEqual("Update of a known key keeps its entry.", 10, *table.update(1, &inserted));
+		assertFalse("Update of a known key does not insert it.", inserted);
+		assertEqual("Number of entries.", (size_t)2, table.size());
+
+		assertTrue("Erase known key.", table.erase(1));
+		assertFalse("Erase unknown key.", table.erase(1));
+		assertTrue("Erased key is not found.", table.find(1) == NULL);
+		assertEqual("Reinserted key has a new entry.", 0, *table.update(1));
+
+		NeighborTable<int, int> none(0);
+		assertTrue("Table of capacity 0 refuses updates.", none.update(1) == NULL && none.empty());
+
+		std::cout << "Basic tests successful." << std::endl;
+	}
+
+	void testReplacement() {
+		NeighborTable<int, int> table(3);
+
+		*table.update(1) = 1;
+		*table.update(2) = 2;
+		*table.update(3) = 3;
+		assertTrue("Table is full.", table.full());
+		assertEqual("Oldest entry.", 1, *table.oldest());
+
+		// find() does not count as use
+		table.find(1);
+		*table.update(4) = 4;
+		assertTrue("Least recently updated key is replaced.", table.find(1) == NULL);
+		assertEqual("Size stays at the capacity.", (size_t)3, table.size());
+
+		table.update(2);
+		*table.update(5) = 5;
+		assertTrue("Updated key is kept.", table.find(2) != NULL);
+		assertTrue("Next least recently updated key is replaced.", table.find(3) == NULL);
+		assertEqual("Replacing key gets a new entry.", 5, *table.find(5));
+		assertEqual("Oldest entry after replacements.", 4, *table.oldest());
+
+		assertTrue("Erase oldest.", table.eraseOldest());
+		assertEqual("Oldest entry after erase.", 2, *table.oldest());
+		assertFalse("Table is no longer full.", table.full());
+		table.eraseOldest();
+		table.eraseOldest();
+		assertFalse("Erase oldest of empty table.", table.eraseOldest());
+		assertTrue("Empty table has no oldest entry.", table.oldest() == NULL);
+
+		std::cout << "Replacement tests successful." << std::endl;
+	}
+
+	void testGrowth() {
+		NeighborTable<int, int> table(2, true);
+		bool kept = true;
+
+		for(int key = 0; key < 1000; ++key)
+			*table.update(key * 7) = key;
+		for(int key = 0; key < 1000; ++key)
+			kept = kept && table.find(key * 7) != NULL && *table.find(key * 7) == key;
+
+		assertTrue("Growable table keeps all entries.", kept);
+		assertEqual("Number of entries after growth.", (size_t)1000, table.size());
+		assertTrue("Capacity covers all entries.", table.getCapacity() >= 1000);
+		assertFalse("Growable table is never full.", table.full());
+		assertEqual("Oldest entry after growth.", 0, *table.oldest());
+
+		NeighborTable<int, int> empty(0, true);
+		*empty.update(3) = 3;
+		assertEqual("Growable table of capacity 0 accepts entries.", 3, *empty.find(3));
+
+		std::cout << "Growth tests successful." << std::endl;
+	}
+
+	void testBackwardShift() {
+		TestTable table(8);
+		const size_t nbBuckets = table.getNbBuckets();
+
+		// a run of colliding keys which wraps around the end of the index
+		int ten = 0;
+		while(table.homeOf(ten * 10) != nbBuckets - 1)
+			++ten;
+		int other = 0;
+		while(table.homeOf(other * 10) != 1)
+			++other;
+
+		const int a = ten * 10, b = a + 1, c = a + 2, d = other * 10;
+		table.update(a);
+		table.update(b);
+		table.update(c);
+		table.update(d);
+		assertEqual("Run starts in the last bucket.", nbBuckets - 1, table.bucketHolding(a));
+		assertEqual("Run wraps to the first bucket.", (size_t)0, table.bucketHolding(b));
+		assertEqual("Key of bucket 1 is displaced.", (size_t)2, table.bucketHolding(d));
+
+		table.erase(a);
+		assertEqual("Colliding key moves into the hole.", nbBuckets - 1, table.bucketHolding(b));
+		assertEqual("Next colliding key moves up.", (size_t)0, table.bucketHolding(c));
+		assertEqual("Displaced key moves to its home.", (size_t)1, table.bucketHolding(d));
+		assertTrue("Remaining keys are found.", table.find(b) && table.find(c) && table.find(d));
+
+		// a key at its home must not be moved in front of it
+		table.erase(c);
+		assertEqual("Key at its home stays.", (size_t)1, table.bucketHolding(d));
+		assertTrue("Keys are found after second erase.", table.find(b) && table.find(d) && !table.find(c));
+
+		std::cout << "Backward shift tests successful." << std::endl;
+	}
+
+	/**
+	 * @brief Compares a table with colliding keys with a std::map for
+	 * random updates and erases.
+	 */
+	void testAgainstMap() {
+		typedef std::map<int, int> Reference;
+
+		TestTable     table(16, true);
+		Reference     ref;
+		unsigned long state = 4711;
+		bool          equal = true;
+
+		for(int step = 0; step < 20000 && equal; ++step) {
+			state = state * 1103515245ul + 12345ul;
+			const int r   = static_cast<int>((state >> 16) & 0x7fff);
+			const int key = r % 200;
+
+			if(r % 3 == 0) {
+				equal = (table.erase(key) == (ref.erase(key) > 0));
+			}
+			else {
+				bool inserted = false;
+				int* entry = table.update(key, &inserted);
+				equal = (inserted == (ref.count(key) == 0));
+				*entry = ref[key] = step;
+			}
+
+			for(int k = 0; k < 200 && equal; k += 13) {
+				const int*                found = table.find(k);
+				const Reference::iterator it    = ref.find(k);
+				equal = (found == NULL) == (it == ref.end()) && (found == NULL || *found == it->second);
+			}
+			equal = equal && table.size() == ref.size();
+		}
+		for(Reference::iterator it = ref.begin(); it != ref.end() && equal; ++it)
+			equal = table.find(it->first) != NULL && *table.find(it->first) == it->second;
+		assertTrue("Random operations match the reference map.", equal);
+
+		std::cout << "Reference tests successful." << std::endl;
+	}
+
+	void testExpiry() {
+		DuplicateCache<int> cache(0, 2.0);
+
+		assertTrue("First insert of an id is new.", cache.insert(1, 0.0));
+		assertFalse("Second insert of an id is not new.", cache.insert(1, 0.5));
+		assertTrue("Id is remembered.", cache.contains(1, 1.0));
+		assertFalse("Unknown id is not remembered.", cache.contains(2, 1.0));
+		cache.insert(2, 1.0);
+
+		// the second insert restarted the lifetime of id 1
+		assertTrue("Id is remembered until its expiry.", cache.contains(1, 2.5));
+		assertFalse("Id is forgotten after its expiry.", cache.contains(1, 2.75));
+		assertEqual("Expired id is kept until purged.", (size_t)2, cache.size());
+		cache.purge(2.75);
+		assertEqual("Purge forgets the expired id only.", (size_t)1, cache.size());
+		assertTrue("Id which has not expired is remembered.", cache.contains(2, 2.75));
+		assertTrue("Insert of a forgotten id is new.", cache.insert(1, 3.5));
+		assertEqual("Insert purges the expired ids.", (size_t)1, cache.size());
+
+		DuplicateCache<int> forever(0, 0.0);
+		forever.insert(1, 0.0);
+		assertTrue("Id with lifetime 0 is remembered for ever.", forever.contains(1, 1e6));
+
+		std::cout << "Expiry tests successful." << std::endl;
+	}
+
+	void testBoundedCache() {
+		DuplicateCache<int> cache(3, 100.0);
+
+		cache.insert(1, 0.0);
+		cache.insert(2, 0.0);
+		cache.insert(3, 0.0);
+		cache.insert(1, 1.0);
+		assertTrue("New id is inserted into full cache.", cache.insert(4, 2.0));
+		assertEqual("Size stays at the maximum.", (size_t)3, cache.size());
+		assertFalse("Id which expires next is forgotten.", cache.contains(2, 2.0));
+		assertTrue("Other ids are remembered.", cache.contains(1, 2.0) && cache.contains(3, 2.0) && cache.contains(4, 2.0));
+		assertTrue("Erase remembered id.", cache.erase(3));
+		assertFalse("Erase forgotten id.", cache.erase(2));
+
+		std::cout << "Bounded cache tests successful." << std::endl;
+	}
+
+	/** @brief Checks the cache configured like Flood for its bcMaxEntries values.*/
+	void testFloodCache() {
+		const unsigned long nbIds = 5000;
+		TestFlood::BroadcastList unbounded;
+		TestFlood::BroadcastList bounded;
+		bool remembered = true;
+
+		// bcMaxEntries = 0 means unbounded
+		unbounded.setMaxEntries(0);
+		unbounded.setLifetime(100.0);
+		bounded.setMaxEntries(100);
+		bounded.setLifetime(100.0);
+		for(unsigned long seq = 0; seq < nbIds; ++seq) {
+			const TestFlood::Id id(static_cast<LAddress::L3Type>(seq % 50), seq);
+			remembered = remembered && unbounded.insert(id, 0.0);
+			bounded.insert(id, 0.0);
+		}
+		for(unsigned long seq = 0; seq < nbIds && remembered; ++seq)
+			remembered = unbounded.contains(TestFlood::Id(static_cast<LAddress::L3Type>(seq % 50), seq), 1.0);
+
+		assertTrue("Flood cache with bcMaxEntries 0 remembers all ids.", remembered);
+		assertEqual("Size of unbounded Flood cache.", (size_t)nbIds, unbounded.size());
+		assertEqual("Size of bounded Flood cache.", (size_t)100, bounded.size());
+		assertFalse("Bounded Flood cache forgets the oldest ids.", bounded.contains(TestFlood::Id(0, 0), 1.0));
+		assertTrue("Bounded Flood cache keeps the newest ids.", bounded.contains(TestFlood::Id((nbIds - 1) % 50, nbIds - 1), 1.0));
+
+		std::cout << "Flood cache tests successful." << std::endl;
+	}
+
+	void runTests() {
+		testBasics();
+		testReplacement();
+		testGrowth();
+		testBackwardShift();
+		testAgainstMap();
+		testExpiry();
+		testBoundedCache();
+		testFloodCache();
+
+		testsExecuted = true;
+	}
+};
+
+Define_Module(NeighborTableTest);
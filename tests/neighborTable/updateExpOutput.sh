@@ -0,0 +1,3 @@
+#!/bin/bash
+
+./runTest.sh "update-exp-output"
@@ -0,0 +1,31 @@
+#!/bin/bash
+
+# compares the lifetime of the analytic and the resolution based
+# accounting, arguments of check: case, exact lifetime, resolution
+iFailed=0
+
+lifetime() {
+  grep -s 'batteryStats[[:space:]]*lifetime' "results/$1-0.sca" | awk '{ print $NF }'
+}
+
+check() {
+  lAna="$(lifetime Analytic$1)"
+  lRes="$(lifetime Resolution$1)"
+  if [ -z "$lAna" -o -z "$lRes" ]; then
+    echo "  FAILED $1: missing lifetime scalar"
+    iFailed=$(( $iFailed + 1 ))
+  elif awk -v a="$lAna" -v r="$lRes" -v e="$2" -v d="$3" \
+       'BEGIN { exit !(a - e < 1e-6 && e - a < 1e-6 && r >= a - 1e-6 && r - a < d) }'; then
+    echo "  PASSED $1: analytic lifetime $lAna, resolution based $lRes"
+  else
+    echo "  FAILED $1: analytic lifetime $lAna (expected $2), resolution based $lRes (resolution $3)"
+    iFailed=$(( $iFailed + 1 ))
+  fi
+}
+
+check Boundary 9.3  0.1
+check MidCycle 7.12 0.1
+check Coarse   7.12 0.5
+
+[ $iFailed = 0 ] && rm -rf results >/dev/null 2>&1
+exit $iFailed
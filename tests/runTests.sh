@@ -82,6 +82,46 @@ if [ -d mapping ]; then
     st=$?
     [ x$st = x0 ] || ilErrs=$(( $ilErrs + 1 ))
 fi
+if [ -d waypointTrace ]; then
+    ilCout=$(( $ilCout + 1 ))
+    echo '----------------WaypointTrace-----------------'
+    ( ( cd waypointTrace >/dev/null 2>&1 && \
+    ./runTest.sh $1 ) && echo "PASSED" ) || ( echo "FAILED" && false )
+    st=$?
+    [ x$st = x0 ] || ilErrs=$(( $ilErrs + 1 ))
+fi
+if [ -d macQueue ]; then
+    ilCout=$(( $ilCout + 1 ))
+    echo '-------------------MacQueue-------------------'
+    ( ( cd macQueue >/dev/null 2>&1 && \
+    ./runTest.sh $1 ) && echo "PASSED" ) || ( echo "FAILED" && false )
+    st=$?
+    [ x$st = x0 ] || ilErrs=$(( $ilErrs + 1 ))
+fi
+if [ -d neighborTable ]; then
+    ilCout=$(( $ilCout + 1 ))
+    echo '----------------NeighborTable-----------------'
+    ( ( cd neighborTable >/dev/null 2>&1 && \
+    ./runTest.sh $1 ) && echo "PASSED" ) || ( echo "FAILED" && false )
+    st=$?
+    [ x$st = x0 ] || ilErrs=$(( $ilErrs + 1 ))
+fi
+if [ -d timerWheel ]; then
+    ilCout=$(( $ilCout + 1 ))
+    echo '------------------TimerWheel------------------'
+    ( ( cd timerWheel >/dev/null 2>&1 && \
+    ./runTest.sh $1 ) && echo "PASSED" ) || ( echo "FAILED" && false )
+    st=$?
+    [ x$st = x0 ] || ilErrs=$(( $ilErrs + 1 ))
+fi
+if [ -d decider802154 ]; then
+    ilCout=$(( $ilCout + 1 ))
+    echo '----------------Decider802154-----------------'
+    ( ( cd decider802154 >/dev/null 2>&1 && \
+    ./runTest.sh $1 ) && echo "PASSED" ) || ( echo "FAILED" && false )
+    st=$?
+    [ x$st = x0 ] || ilErrs=$(( $ilErrs + 1 ))
+fi
 if [ -d power ]; then
     ilCout=$(( $ilCout + 1 ))
     echo '-----------------Power------------------------'
@@ -0,0 +1,217 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <map>
+
+#include <TimerWheel.h>
+#include <asserts.h>
+#include <OmnetTestBase.h>
+
+/**
+ * @brief TimerWheel with access to the position of the wheel and the
+ * number of timers per level.
+ */
+class TestWheel : public TimerWheel<int> {
+public:
+	TestWheel(simtime_t_cref resolution = 0.001):
+		TimerWheel<int>(resolution)
+	{}
+
+	size_t getLevelCount(int level) const { return levelCount[level]; }
+
+	int64 getCurrentTick() const { return currentTick; }
+};
+
+/**
+ * @brief Unit tests for the ordering, the cascading between the levels and
+ * the advancing of TimerWheel.
+ */
+class TimerWheelTest : public SimpleTest {
+protected:
+	void testSameExpiry() {
+		TestWheel wheel;
+		TestWheel::handle_t handles[5];
+
+		for(int i = 0; i < 5; ++i)
+			handles[i] = wheel.schedule(1.0, i);
+		wheel.schedule(0.5, 10);
+		wheel.reschedule(handles[1], 1.0);
+		wheel.cancel(handles[3]);
+
+		int data = -1;
+		assertTrue("Earlier timer expires first.", wheel.popExpired(1.0, data) && data == 10);
+		assertTrue("First scheduled timer of the same expiry.", wheel.popExpired(1.0, data) && data == 0);
+		assertTrue("Second timer of the same expiry.", wheel.popExpired(1.0, data) && data == 2);
+		assertTrue("Third timer of the same expiry.", wheel.popExpired(1.0, data) && data == 4);
+		assertTrue("Rescheduled timer is the last of the same expiry.", wheel.popExpired(1.0, data) && data == 1);
+		assertFalse("Canceled timer does not expire.", wheel.popExpired(1.0, data));
+		assertTrue("Wheel is empty.", wheel.empty());
+
+		// timers in one slot but with different expiries
+		wheel.schedule(2.0009, 1);
+		wheel.schedule(2.0001, 2);
+		assertEqual("Exact expiry within a tick.", simtime_t(2.0001), wheel.nextExpiry());
+		assertFalse("Timer does not expire before its exact time.", wheel.popExpired(2.0, data));
+
+		std::cout << "Same expiry tests successful." << std::endl;
+	}
+
+	void testCascade() {
+		TestWheel wheel;
+		int data = -1;
+
+		// level 0 covers 64 ticks of 1 ms, every further level 64 times more
+		wheel.schedule(0.01, 0);
+		wheel.schedule(1.0, 1);
+		wheel.schedule(100.0, 2);
+		wheel.schedule(1000.0, 3);
+		wheel.schedule(100000.0, 4);
+		assertEqual("Timer on level 0.", (size_t)1, wheel.getLevelCount(0));
+		assertEqual("Timer on level 1.", (size_t)1, wheel.getLevelCount(1));
+		assertEqual("Timer on level 2.", (size_t)1, wheel.getLevelCount(2));
+		assertEqual("Timers on level 3, the last one beyond its range.", (size_t)2, wheel.getLevelCount(3));
+
+		assertTrue("Timer of level 0 expires.", wheel.popExpired(0.01, data) && data == 0);
+		assertEqual("Next expiry is on level 1.", simtime_t(1.0), wheel.nextExpiry());
+		assertEqual("Timer of level 1 cascaded to level 0.", (size_t)1, wheel.getLevelCount(0));
+		assertEqual("Level 1 is empty.", (size_t)0, wheel.getLevelCount(1));
+		assertTrue("Timer of level 1 expires.", wheel.popExpired(1.0, data) && data == 1);
+
+		assertFalse("Timer of level 2 does not expire early.", wheel.popExpired(99.999, data));
+		assertEqual("Timer of level 2 cascaded to level 0.", (size_t)1, wheel.getLevelCount(0));
+		assertEqual("Wheel stops before the timer of level 2.", (int64)100000, wheel.getCurrentTick());
+		assertTrue("Timer of level 2 expires.", wheel.popExpired(100.0, data) && data == 2);
+		assertTrue("Timer of level 3 expires.", wheel.popExpired(1000.0, data) && data == 3);
+		assertEqual("Timer beyond the range is found.", simtime_t(100000.0), wheel.nextExpiry());
+		assertTrue("Timer beyond the range expires.", wheel.popExpired(100000.0, data) && data == 4);
+		assertTrue("Wheel is empty.", wheel.empty());
+		assertEqual("Empty wheel has no expiry.", MAXTIME, wheel.nextExpiry());
+
+		std::cout << "Cascade tests successful." << std::endl;
+	}
+
+	void testAdvance() {
+		TestWheel wheel;
+		int data = -1;
+
+		// the timer of tick 70 lies in the next block of level 0
+		wheel.schedule(0.060, 0);
+		wheel.popExpired(0.060, data);
+		wheel.schedule(0.070, 1);
+		assertEqual("Timer of the next block stays on level 0.", (size_t)1, wheel.getLevelCount(0));
+		assertEqual("Timer of the next block is found.", simtime_t(0.070), wheel.nextExpiry());
+		assertEqual("Wheel moved into the next block.", (int64)70, wheel.getCurrentTick());
+		wheel.popExpired(0.070, data);
+
+		// empty slots of level 1 are skipped up to the one of the timer
+		wheel.schedule(3.0, 2);
+		wheel.schedule(3.5, 3);
+		assertEqual("Far timers are on level 1.", (size_t)2, wheel.getLevelCount(1));
+		assertEqual("Next expiry after empty slots.", simtime_t(3.0), wheel.nextExpiry());
+		assertEqual("Wheel skipped the empty slots.", (int64)3000, wheel.getCurrentTick());
+		assertEqual("Later timer stays on level 1.", (size_t)1, wheel.getLevelCount(1));
+		assertTrue("Far timer expires.", wheel.popExpired(3.0, data) && data == 2);
+		assertTrue("Later far timer expires.", wheel.popExpired(3.5, data) && data == 3);
+
+		// timers scheduled before the position of the wheel are due at once
+		wheel.schedule(4.0, 4);
+		wheel.nextExpiry();
+		wheel.schedule(3.75, 5);
+		assertTrue("Overdue timer expires first.", wheel.popExpired(4.0, data) && data == 5);
+		assertTrue("Timer after the overdue one.", wheel.popExpired(4.0, data) && data == 4);
+
+		std::cout << "Advance tests successful." << std::endl;
+	}
+
+	/**
+	 * @brief Compares the wheel with a std::multimap for random schedules,
+	 * reschedules, cancels and expiries.
+	 */
+	void testAgainstMultimap() {
+		typedef std::multimap<simtime_t, int> Reference;
+
+		TestWheel                          wheel;
+		Reference                          ref;
+		std::map<int, TestWheel::handle_t> handles;
+		std::map<int, Reference::iterator> entries;
+		unsigned long                      state = 815;
+		bool                               equal = true;
+		simtime_t                          now   = 0;
+		int                                next  = 0;
+
+		for(int step = 0; step < 20000 && equal; ++step) {
+			state = state * 1103515245ul + 12345ul;
+			const int r = static_cast<int>((state >> 16) & 0x7fff);
+
+			// delays from below one tick to beyond the range of the last level
+			const double    scales[] = { 0.0001, 0.1, 10.0, 1000.0, 100000.0 };
+			const simtime_t expiry   = now + scales[r % 5] * ((r / 5) % 100) / 100.0;
+
+			if(r % 7 < 3) {
+				handles[next] = wheel.schedule(expiry, next);
+				entries[next] = ref.insert(std::make_pair(expiry, next));
+				++next;
+			}
+			else if(r % 7 == 3 && !entries.empty()) {
+				std::map<int, Reference::iterator>::iterator it = entries.lower_bound((r / 7) % next);
+				if(it == entries.end())
+					it = entries.begin();
+				wheel.reschedule(handles[it->first], expiry);
+				ref.erase(it->second);
+				it->second = ref.insert(std::make_pair(expiry, it->first));
+			}
+			else if(r % 7 == 4 && !entries.empty()) {
+				std::map<int, Reference::iterator>::iterator it = entries.lower_bound((r / 7) % next);
+				if(it == entries.end())
+					it = entries.begin();
+				wheel.cancel(handles[it->first]);
+				ref.erase(it->second);
+				handles.erase(it->first);
+				entries.erase(it);
+			}
+			else {
+				// jump to the next expiry and take every expired timer
+				equal = (wheel.nextExpiry() == (ref.empty() ? MAXTIME : ref.begin()->first));
+				if(!ref.empty())
+					now = ref.begin()->first;
+				int data = -1;
+				while(equal && wheel.popExpired(now, data)) {
+					equal = !ref.empty() && ref.begin()->second == data && !(now < ref.begin()->first);
+					if(equal) {
+						ref.erase(ref.begin());
+						handles.erase(data);
+						entries.erase(data);
+					}
+				}
+				equal = equal && (ref.empty() || now < ref.begin()->first);
+			}
+			equal = equal && wheel.size() == ref.size();
+		}
+		assertTrue("Random operations match the reference multimap.", equal);
+
+		std::cout << "Reference tests successful." << std::endl;
+	}
+
+	void runTests() {
+		testSameExpiry();
+		testCascade();
+		testAdvance();
+		testAgainstMultimap();
+
+		testsExecuted = true;
+	}
+};
+
+Define_Module(TimerWheelTest);
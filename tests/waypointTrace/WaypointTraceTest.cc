@@ -0,0 +1,175 @@
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see http://www.gnu.org/licenses/.
+//
+
+#include <cstdio>
+#include <fstream>
+
+#include <WaypointTraceFile.h>
+#include <asserts.h>
+#include <OmnetTestBase.h>
+
+static const char* BONNMOTION_TEXT = "bm.movements";
+static const char* BONNMOTION_BIN  = "bm.wpt";
+static const char* NS2_TEXT        = "ns2.movements";
+static const char* NS2_BIN         = "ns2.wpt";
+static const char* CACHED_BIN      = "cached.wpt";
+
+static const double BONNMOTION_NODE0[] = { 0.0, 10.0, 20.0, 5.0, 30.0, 40.0 };
+static const double BONNMOTION_NODE1[] = { 1.5, 1.0, 2.0, 3.5, 4.0, 5.0, 7.25, 6.0, 7.0 };
+
+static const double NS2_NODE0[] = { 10.0, 20.0, 0.0, 1.0, 30.0, 40.0, 2.5, 3.0, 50.0, 60.0, 0.0 };
+static const double NS2_NODE1[] = { 5.0, 6.0, 0.0, 2.0, 7.0, 8.0, 1.0 };
+
+/**
+ * @brief Returns true if the passed waypoints equal the passed array.
+ */
+template<size_t N>
+static bool equals(const WaypointTraceFile::Values& values, const double (&expected)[N]) {
+	if(values.size() != N)
+		return false;
+	for(size_t i = 0; i < N; ++i) {
+		if(values[i] != expected[i])
+			return false;
+	}
+	return true;
+}
+
+/**
+ * @brief Unit tests for the text parsers, the binary format and the shared
+ * cache of WaypointTraceFile.
+ */
+class WaypointTraceTest : public SimpleTest {
+protected:
+	void writeTextFiles() {
+		std::ofstream bm(BONNMOTION_TEXT);
+		bm << "0.0 10 20 5.0 30 40\n"
+		   << "1.5 1 2 3.5 4 5 7.25 6 7\n";
+		bm.close();
+
+		// interleaved commands of two nodes, the comments must be ignored
+		std::ofstream ns2(NS2_TEXT);
+		ns2 << "# $node_(5) set X_ 1.0\n"
+		    << "$node_(0) set X_ 10.0\n"
+		    << "$node_(0) set Y_ 20.0\n"
+		    << "$node_(0) set Z_ 0.0\n"
+		    << "$node_(1) set X_ 5.0\n"
+		    << "$node_(1) set Y_ 6.0 # was X_ 3.0\n"
+		    << "$node_(1) set Z_ 0.0\n"
+		    << "$ns_ at 1.0 \"$node_(0) setdest 30.0 40.0 2.5\"\n"
+		    << "$ns_ at 2.0 \"$node_(1) setdest 7.0 8.0 1.0\"\n"
+		    << "$ns_ at 3.0 \"$node_(0) setdest 50.0 60.0 0.0\" # then setdest 1 1 1\n";
+		ns2.close();
+	}
+
+	void removeFiles() {
+		remove(BONNMOTION_TEXT);
+		remove(BONNMOTION_BIN);
+		remove(NS2_TEXT);
+		remove(NS2_BIN);
+		remove(CACHED_BIN);
+	}
+
+	void checkBonnMotion(const WaypointTraceFile& trace, std::string name) {
+		assertEqual(name + ": format.", WaypointTraceFile::BONNMOTION, trace.getFormat());
+		assertEqual(name + ": number of nodes.", (size_t)2, trace.getNumNodes());
+		assertTrue(name + ": waypoints of node 0.", equals(trace.getNode(0), BONNMOTION_NODE0));
+		assertTrue(name + ": waypoints of node 1.", equals(trace.getNode(1), BONNMOTION_NODE1));
+		assertTrue(name + ": unknown node is empty.", trace.getNode(2).empty() && trace.getNode(-1).empty());
+	}
+
+	void checkNs2(const WaypointTraceFile& trace, std::string name) {
+		assertEqual(name + ": format.", WaypointTraceFile::NS2, trace.getFormat());
+		assertEqual(name + ": number of nodes.", (size_t)2, trace.getNumNodes());
+		assertTrue(name + ": waypoints of node 0.", equals(trace.getNode(0), NS2_NODE0));
+		assertTrue(name + ": waypoints of node 1.", equals(trace.getNode(1), NS2_NODE1));
+	}
+
+	void testBonnMotion() {
+		WaypointTraceFile text;
+		assertFalse("BonnMotion text file is not binary.", WaypointTraceFile::isBinary(BONNMOTION_TEXT));
+		text.load(BONNMOTION_TEXT, WaypointTraceFile::BONNMOTION);
+		checkBonnMotion(text, "BonnMotion text");
+
+		text.write(BONNMOTION_BIN);
+		assertTrue("BonnMotion binary file is binary.", WaypointTraceFile::isBinary(BONNMOTION_BIN));
+
+		// the text format passed to load() is ignored for binary files
+		WaypointTraceFile binary;
+		binary.load(BONNMOTION_BIN, WaypointTraceFile::NS2);
+		checkBonnMotion(binary, "BonnMotion binary");
+
+		std::cout << "BonnMotion tests successful." << std::endl;
+	}
+
+	void testNs2() {
+		WaypointTraceFile text;
+		text.load(NS2_TEXT, WaypointTraceFile::NS2);
+		checkNs2(text, "ns2 text");
+
+		text.write(NS2_BIN);
+		WaypointTraceFile binary;
+		binary.load(NS2_BIN, WaypointTraceFile::BONNMOTION);
+		checkNs2(binary, "ns2 binary");
+
+		std::cout << "ns2 tests successful." << std::endl;
+	}
+
+	void testCache() {
+		remove(CACHED_BIN);
+
+		// two users, the first one converts the text file
+		WaypointTraceCache* cache = WaypointTraceCache::acquireInstance();
+		const WaypointTraceFile* trace = cache->getFile(BONNMOTION_TEXT, WaypointTraceFile::BONNMOTION, CACHED_BIN);
+		assertTrue("Cache wrote the binary file.", WaypointTraceFile::isBinary(CACHED_BIN));
+
+		const WaypointTraceFile* shared = WaypointTraceCache::acquireInstance()->getFile(BONNMOTION_TEXT, WaypointTraceFile::BONNMOTION, CACHED_BIN);
+		assertTrue("Cache shares the trace.", trace == shared);
+
+		bool wrongFormat = false;
+		try {
+			cache->getFile(BONNMOTION_TEXT, WaypointTraceFile::NS2, CACHED_BIN);
+		} catch(cRuntimeError&) {
+			wrongFormat = true;
+		}
+		assertTrue("Cache rejects a trace of the wrong format.", wrongFormat);
+
+		// the trace has to survive until the last user is gone
+		WaypointTraceCache::releaseInstance();
+		checkBonnMotion(*shared, "Cached trace after first release");
+		WaypointTraceCache::releaseInstance();
+
+		// a new user reads the binary file written before
+		cache = WaypointTraceCache::acquireInstance();
+		remove(BONNMOTION_TEXT);
+		trace = cache->getFile(BONNMOTION_TEXT, WaypointTraceFile::BONNMOTION, CACHED_BIN);
+		checkBonnMotion(*trace, "Cached binary trace");
+		WaypointTraceCache::releaseInstance();
+
+		std::cout << "Cache tests successful." << std::endl;
+	}
+
+	void runTests() {
+		writeTextFiles();
+
+		testBonnMotion();
+		testNs2();
+		testCache();
+
+		removeFiles();
+		testsExecuted = true;
+	}
+};
+
+Define_Module(WaypointTraceTest);